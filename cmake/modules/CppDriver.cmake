@@ -134,7 +134,7 @@ macro(CassUseBoost)
   endif()
 
   # Determine if Boost components are available for test executables
-  if(CASS_BUILD_UNIT_TESTS OR CASS_BUILD_INTEGRATION_TESTS)
+  if(CASS_BUILD_UNIT_TESTS OR CASS_BUILD_INTEGRATION_TESTS OR CASS_BUILD_BENCHMARKS)
     find_package(Boost ${CASS_MINIMUM_BOOST_VERSION} COMPONENTS chrono date_time filesystem log log_setup system regex thread unit_test_framework)
     if(NOT Boost_FOUND)
       message(FATAL_ERROR "Boost [chrono, date_time, filesystem, log, log_setup, system, regex, thread, and unit_test_framework] are required to build tests")
@@ -276,6 +276,82 @@ macro(CassUseZlib)
   endif()
 endmacro()
 
+#------------------------
+# CassUseLz4
+#
+# Add includes and libraries required for using LZ4.
+#
+# Input: CASS_INCLUDES and CASS_LIBS
+# Output: CASS_INCLUDES and CASS_LIBS
+#------------------------
+macro(CassUseLz4)
+  # Setup the paths and hints for LZ4
+  set(_LZ4_ROOT_PATHS "${PROJECT_SOURCE_DIR}/lib/lz4/")
+  set(_LZ4_ROOT_HINTS ${LZ4_ROOT_DIR} $ENV{LZ4_ROOT_DIR})
+  if(NOT WIN32)
+    set(_LZ4_ROOT_PATHS ${_LZ4_ROOT_PATHS} "/usr/" "/usr/local/")
+  endif()
+  set(_LZ4_ROOT_HINTS_AND_PATHS
+    HINTS ${_LZ4_ROOT_HINTS}
+    PATHS ${_LZ4_ROOT_PATHS})
+
+  # Ensure LZ4 was found
+  find_path(LZ4_INCLUDE_DIR
+    NAMES lz4.h
+    HINTS ${_LZ4_INCLUDEDIR} ${_LZ4_ROOT_HINTS_AND_PATHS}
+    PATH_SUFFIXES include)
+  find_library(LZ4_LIBRARY
+    NAMES lz4 liblz4
+    HINTS ${_LZ4_LIBDIR} ${_LZ4_ROOT_HINTS_AND_PATHS}
+    PATH_SUFFIXES lib)
+  find_package_handle_standard_args(Lz4 "Could NOT find LZ4, try to set the path to the LZ4 root folder in the system variable LZ4_ROOT_DIR"
+    LZ4_LIBRARY
+    LZ4_INCLUDE_DIR)
+
+  # Assign LZ4 include and libraries
+  set(CASS_INCLUDES ${CASS_INCLUDES} ${LZ4_INCLUDE_DIR})
+  set(CASS_LIBS ${CASS_LIBS} ${LZ4_LIBRARY})
+  add_definitions("-DCASS_USE_LZ4")
+endmacro()
+
+#------------------------
+# CassUseSnappy
+#
+# Add includes and libraries required for using Snappy.
+#
+# Input: CASS_INCLUDES and CASS_LIBS
+# Output: CASS_INCLUDES and CASS_LIBS
+#------------------------
+macro(CassUseSnappy)
+  # Setup the paths and hints for Snappy
+  set(_SNAPPY_ROOT_PATHS "${PROJECT_SOURCE_DIR}/lib/snappy/")
+  set(_SNAPPY_ROOT_HINTS ${SNAPPY_ROOT_DIR} $ENV{SNAPPY_ROOT_DIR})
+  if(NOT WIN32)
+    set(_SNAPPY_ROOT_PATHS ${_SNAPPY_ROOT_PATHS} "/usr/" "/usr/local/")
+  endif()
+  set(_SNAPPY_ROOT_HINTS_AND_PATHS
+    HINTS ${_SNAPPY_ROOT_HINTS}
+    PATHS ${_SNAPPY_ROOT_PATHS})
+
+  # Ensure Snappy was found
+  find_path(SNAPPY_INCLUDE_DIR
+    NAMES snappy-c.h
+    HINTS ${_SNAPPY_INCLUDEDIR} ${_SNAPPY_ROOT_HINTS_AND_PATHS}
+    PATH_SUFFIXES include)
+  find_library(SNAPPY_LIBRARY
+    NAMES snappy libsnappy
+    HINTS ${_SNAPPY_LIBDIR} ${_SNAPPY_ROOT_HINTS_AND_PATHS}
+    PATH_SUFFIXES lib)
+  find_package_handle_standard_args(Snappy "Could NOT find Snappy, try to set the path to the Snappy root folder in the system variable SNAPPY_ROOT_DIR"
+    SNAPPY_LIBRARY
+    SNAPPY_INCLUDE_DIR)
+
+  # Assign Snappy include and libraries
+  set(CASS_INCLUDES ${CASS_INCLUDES} ${SNAPPY_INCLUDE_DIR})
+  set(CASS_LIBS ${CASS_LIBS} ${SNAPPY_LIBRARY})
+  add_definitions("-DCASS_USE_SNAPPY")
+endmacro()
+
 #-------------------
 # Compiler Flags
 #-------------------
@@ -459,6 +459,44 @@ typedef struct CassMetrics_ {
     cass_uint64_t request_timeouts; /** Occurrences of requests that timed out waiting for a request to finish */
   } errors;
 
+  struct {
+    cass_uint64_t uncompressed_bytes_sent; /**< Size of compressed request bodies before compression */
+    cass_uint64_t compressed_bytes_sent; /**< Size of compressed request bodies after compression */
+    cass_uint64_t uncompressed_bytes_received; /**< Size of compressed response bodies after decompression */
+    cass_uint64_t compressed_bytes_received; /**< Size of compressed response bodies as received */
+  } compression;
+
+  struct {
+    cass_uint64_t attempts; /**< Speculative executions started */
+    cass_uint64_t wins; /**< Speculative executions that completed their request */
+  } speculative_executions;
+
+  struct {
+    cass_uint64_t replica_sets; /**< Distinct replica sets shared by the tokens of all keyspaces */
+    cass_uint64_t memory_bytes; /**< Estimated memory used by the tokens and replicas */
+  } token_map;
+
+  struct {
+    cass_uint64_t bytes_written; /**< Bytes written to sockets */
+    cass_uint64_t bytes_written_synchronously; /**< Bytes written without waiting on the event loop */
+  } writes;
+
+  struct {
+    cass_uint64_t requests_median; /**< Median number of requests written per flush */
+    cass_uint64_t requests_percentile_99th; /**< 99th percentile number of requests written per flush */
+    cass_uint64_t requests_max; /**< Maximum number of requests written per flush */
+    cass_uint64_t bytes_median; /**< Median number of bytes written per flush */
+    cass_uint64_t bytes_percentile_99th; /**< 99th percentile number of bytes written per flush */
+    cass_uint64_t bytes_max; /**< Maximum number of bytes written per flush */
+  } flushes;
+
+  struct {
+    cass_uint64_t buffer_hits; /**< Response bodies that reused a pooled buffer */
+    cass_uint64_t buffer_misses; /**< Response bodies that allocated a new buffer */
+    cass_uint64_t message_hits; /**< Responses that reused a pooled message */
+    cass_uint64_t message_misses; /**< Responses that allocated a new message */
+  } response_pool;
+
 } CassMetrics;
 
 typedef enum CassConsistency_ {
@@ -617,6 +655,12 @@ typedef enum CassSslVerifyFlags {
   CASS_SSL_VERIFY_PEER_IDENTITY_DNS = 0x04
 } CassSslVerifyFlags;
 
+typedef enum CassCompressionType_ {
+  CASS_COMPRESSION_NONE   = 0x00,
+  CASS_COMPRESSION_LZ4    = 0x01,
+  CASS_COMPRESSION_SNAPPY = 0x02
+} CassCompressionType;
+
 typedef enum  CassErrorSource_ {
   CASS_ERROR_SOURCE_NONE,
   CASS_ERROR_SOURCE_LIB,
@@ -1112,6 +1156,82 @@ CASS_EXPORT CassError
 cass_cluster_set_max_requests_per_flush(CassCluster* cluster,
                                         unsigned num_requests);
 
+/**
+ * Enables/Disables adaptive flushing of requests by the IO workers.
+ *
+ * When enabled the number of requests processed per flush grows while
+ * the request queue stays backed up and shrinks back to the maximum
+ * requests per flush once it drains. A connection is flushed as soon as
+ * its unflushed requests reach a number of bytes instead of waiting for
+ * the end of the event loop iteration, and, optionally, flushing at low
+ * load can be delayed for a few microseconds to batch requests that
+ * arrive close together.
+ *
+ * <b>Default:</b> cass_false (disabled).
+ *
+ * @public @memberof CassCluster
+ *
+ * @param[in] cluster
+ * @param[in] enabled
+ *
+ * @see cass_cluster_set_adaptive_flush_settings()
+ * @see cass_cluster_set_max_requests_per_flush()
+ */
+CASS_EXPORT void
+cass_cluster_set_adaptive_flush(CassCluster* cluster,
+                                cass_bool_t enabled);
+
+/**
+ * Sets adaptive flush settings.
+ *
+ * <b>Defaults:</b>
+ *
+ * <ul>
+ *   <li>num_bytes: 65536 bytes (64 KB)</li>
+ *   <li>max_delay_us: 0 microseconds (flush at the end of each event loop
+ *   iteration)</li>
+ * </ul>
+ *
+ * @public @memberof CassCluster
+ *
+ * @param[in] cluster
+ * @param[in] num_bytes The number of unflushed bytes that causes a connection
+ * to be flushed immediately.
+ * @param[in] max_delay_us The maximum amount of time in microseconds that
+ * a flush is delayed waiting for more requests. The event loop doesn't block
+ * while a flush is delayed so this should be kept small.
+ * @return CASS_OK if successful, otherwise an error occurred.
+ *
+ * @see cass_cluster_set_adaptive_flush()
+ */
+CASS_EXPORT CassError
+cass_cluster_set_adaptive_flush_settings(CassCluster* cluster,
+                                         unsigned num_bytes,
+                                         unsigned max_delay_us);
+
+/**
+ * Enables/Disables pooling of response buffers and messages by the IO
+ * workers.
+ *
+ * <b>Default:</b> cass_false (disabled).
+ *
+ * When enabled each IO worker keeps freed response bodies of up to 1 MB
+ * for reuse, including bodies freed by application threads (e.g. by
+ * cass_result_free()). This avoids contention on the system allocator when
+ * many threads free results, but it's slower than most allocators when
+ * results are freed on the IO thread and it retains up to about 6.5 MB per IO
+ * worker. Cached buffers are freed when an IO worker receives no responses
+ * for 10 seconds.
+ *
+ * @public @memberof CassCluster
+ *
+ * @param[in] cluster
+ * @param[in] enabled
+ */
+CASS_EXPORT void
+cass_cluster_set_response_pooling(CassCluster* cluster,
+                                  cass_bool_t enabled);
+
 /**
  * Sets the high water mark for the number of bytes outstanding
  * on a connection. Disables writes to a connection if the number
@@ -1402,6 +1522,27 @@ cass_cluster_set_latency_aware_routing_settings(CassCluster* cluster,
                                                 cass_uint64_t update_rate_ms,
                                                 cass_uint64_t min_measured);
 
+/**
+ * Configures the cluster to route requests using the number of requests
+ * currently in flight to each host or not.
+ *
+ * <b>Default:</b> cass_false (disabled).
+ *
+ * Of the first two hosts chosen by the base routing policy (two replicas
+ * when token-aware routing is enabled) the host with the fewest outstanding
+ * requests is tried first. This reacts to an overloaded node as soon as
+ * its requests start to queue instead of waiting for its average latency
+ * to be updated.
+ *
+ * @public @memberof CassCluster
+ *
+ * @param[in] cluster
+ * @param[in] enabled
+ */
+CASS_EXPORT void
+cass_cluster_set_least_outstanding_requests_routing(CassCluster* cluster,
+                                                    cass_bool_t enabled);
+
 /**
  * Sets/Appends whitelist hosts. The first call sets the whitelist hosts and
  * any subsequent calls appends additional hosts. Passing an empty string will
@@ -1660,6 +1801,74 @@ CASS_EXPORT void
 cass_cluster_set_retry_policy(CassCluster* cluster,
                               CassRetryPolicy* retry_policy);
 
+/**
+ * Enable constant speculative executions for idempotent requests. If a
+ * request hasn't completed within the delay another attempt is sent to the
+ * next host in the query plan. The first response to arrive completes the
+ * request.
+ *
+ * <b>Note:</b> This can't be combined with I/O thread affinity.
+ *
+ * <b>Default:</b> Disabled
+ *
+ * @public @memberof CassCluster
+ *
+ * @param[in] cluster
+ * @param[in] constant_delay_ms The delay before each speculative execution
+ * @param[in] max_speculative_executions The maximum number of speculative
+ * executions per request
+ * @return CASS_OK if successful, otherwise an error occurred.
+ *
+ * @see cass_statement_set_is_idempotent()
+ * @see cass_batch_set_is_idempotent()
+ * @see cass_cluster_set_use_io_worker_affinity()
+ */
+CASS_EXPORT CassError
+cass_cluster_set_constant_speculative_execution_policy(CassCluster* cluster,
+                                                       cass_int64_t constant_delay_ms,
+                                                       int max_speculative_executions);
+
+/**
+ * Enable speculative executions for idempotent requests using a percentile
+ * of the session's request latencies as the delay (e.g. 99.0 starts a
+ * speculative execution once a request is slower than 99% of requests).
+ * No speculative executions are started until enough requests have completed
+ * to calculate the percentile.
+ *
+ * <b>Note:</b> This can't be combined with I/O thread affinity.
+ *
+ * <b>Default:</b> Disabled
+ *
+ * @public @memberof CassCluster
+ *
+ * @param[in] cluster
+ * @param[in] percentile A percentile between 0.0 and 100.0 (exclusive)
+ * @param[in] max_speculative_executions The maximum number of speculative
+ * executions per request
+ * @return CASS_OK if successful, otherwise an error occurred.
+ *
+ * @see cass_statement_set_is_idempotent()
+ * @see cass_batch_set_is_idempotent()
+ * @see cass_cluster_set_use_io_worker_affinity()
+ */
+CASS_EXPORT CassError
+cass_cluster_set_percentile_speculative_execution_policy(CassCluster* cluster,
+                                                         cass_double_t percentile,
+                                                         int max_speculative_executions);
+
+/**
+ * Disable speculative executions.
+ *
+ * <b>Default:</b> This is the default speculative execution policy.
+ *
+ * @public @memberof CassCluster
+ *
+ * @param[in] cluster
+ * @return CASS_OK
+ */
+CASS_EXPORT CassError
+cass_cluster_set_no_speculative_execution_policy(CassCluster* cluster);
+
 /**
  * Enable/Disable retrieving and updating schema metadata. If disabled
  * this is allows the driver to skip over retrieving and updating schema
@@ -1703,6 +1912,100 @@ CASS_EXPORT CassError
 cass_cluster_set_use_hostname_resolution(CassCluster* cluster,
                                          cass_bool_t enabled);
 
+/**
+ * Enable/Disable dispatching requests directly from the calling thread.
+ *
+ * By default requests are handed off to the session thread which builds the
+ * query plan and then hands the request off to an I/O thread. When enabled,
+ * the thread calling cass_session_execute() (or cass_session_execute_batch()
+ * and cass_session_prepare()) builds the query plan itself and enqueues the
+ * request directly on an I/O thread. This removes a thread hop and a wakeup
+ * per request at the cost of a shared lock around load balancing policy and
+ * token map updates.
+ *
+ * <b>Default:</b> cass_false (disabled).
+ *
+ * @public @memberof CassCluster
+ *
+ * @param[in] cluster
+ * @param[in] enabled
+ */
+CASS_EXPORT void
+cass_cluster_set_use_direct_dispatch(CassCluster* cluster,
+                                     cass_bool_t enabled);
+
+/**
+ * Enable/Disable I/O thread affinity for hosts.
+ *
+ * By default every I/O thread keeps a connection pool to every host and
+ * requests are spread across the I/O threads round-robin. When enabled, each
+ * host's connection pool is owned by a single I/O thread and requests are
+ * sent to the I/O thread that owns the host chosen by the load balancing
+ * policy. This reduces the number of connections by a factor of the number of
+ * I/O threads, which is useful for large clusters.
+ *
+ * <b>Note:</b> This can't be combined with speculative executions.
+ *
+ * <b>Default:</b> cass_false (disabled).
+ *
+ * @public @memberof CassCluster
+ *
+ * @param[in] cluster
+ * @param[in] enabled
+ * @return CASS_OK if successful, otherwise CASS_ERROR_LIB_BAD_PARAMS if a
+ * speculative execution policy is enabled.
+ *
+ * @see cass_cluster_set_num_threads_io()
+ * @see cass_cluster_set_no_speculative_execution_policy()
+ */
+CASS_EXPORT CassError
+cass_cluster_set_use_io_worker_affinity(CassCluster* cluster,
+                                        cass_bool_t enabled);
+
+/**
+ * Sets the compression algorithms that may be used to compress frame bodies.
+ * The algorithm is negotiated with each host when a connection is established
+ * and compression is only enabled on a connection if the host supports one of
+ * the requested algorithms. If both LZ4 and Snappy are requested and the host
+ * supports both then LZ4 is used.
+ *
+ * <b>Default:</b> CASS_COMPRESSION_NONE
+ *
+ * <b>Important:</b> The driver must be built with support for the requested
+ * algorithms (CASS_USE_LZ4 and/or CASS_USE_SNAPPY), otherwise
+ * CASS_ERROR_LIB_NOT_IMPLEMENTED is returned. LZ4 requires protocol version 2
+ * or higher.
+ *
+ * @public @memberof CassCluster
+ *
+ * @param[in] cluster
+ * @param[in] compression_types A bitwise OR of CassCompressionType values
+ * @return CASS_OK if successful, otherwise an error occurred
+ *
+ * @see cass_cluster_set_compression_threshold()
+ */
+CASS_EXPORT CassError
+cass_cluster_set_compression(CassCluster* cluster,
+                             int compression_types);
+
+/**
+ * Sets the minimum size of a request body before it's compressed. Smaller
+ * requests are sent uncompressed because the savings don't cover the cost of
+ * compressing them.
+ *
+ * <b>Default:</b> 512 bytes
+ *
+ * @public @memberof CassCluster
+ *
+ * @param[in] cluster
+ * @param[in] num_bytes
+ *
+ * @see cass_cluster_set_compression()
+ */
+CASS_EXPORT void
+cass_cluster_set_compression_threshold(CassCluster* cluster,
+                                       unsigned num_bytes);
+
 /***********************************************************************************
  *
  * Session
@@ -1868,6 +2171,36 @@ CASS_EXPORT CassFuture*
 cass_session_execute_batch(CassSession* session,
                            const CassBatch* batch);
 
+/**
+ * Execute a batch statement split by replicas. The batch's statements are
+ * grouped by the replicas that own their partition keys and each group is
+ * sent, in parallel, as a separate batch directly to one of its replicas.
+ * Statements without a routing key are sent together in one batch. This
+ * is intended for bulk loading with unlogged batches that span many
+ * partitions.
+ *
+ * The returned future is set once all of the batches have finished. If any
+ * of them fail it's set to the first error, otherwise it's set to the
+ * result of one of the batches.
+ *
+ * <b>Important:</b> The batches are applied independently so a logged
+ * batch is only atomic within each group.
+ *
+ * @cassandra{2.0+}
+ *
+ * @public @memberof CassSession
+ *
+ * @param[in] session
+ * @param[in] batch
+ * @return A future that must be freed.
+ *
+ * @see cass_session_execute_batch()
+ * @see cass_cluster_set_token_aware_routing()
+ */
+CASS_EXPORT CassFuture*
+cass_session_execute_batch_split(CassSession* session,
+                                 const CassBatch* batch);
+
 /**
  * Gets a snapshot of this session's schema metadata. The returned
  * snapshot of the schema metadata is not updated. This function
@@ -3763,6 +4096,29 @@ CASS_EXPORT CassError
 cass_statement_add_key_index(CassStatement* statement,
                              size_t index);
 
+/**
+ * Gets the token of the statement's partition key as computed by the
+ * Murmur3Partitioner (the default partitioner). The token is computed once
+ * all of the key parameters are bound and is cached until one of them is
+ * bound again, so it can be used to group statements by token without
+ * re-hashing their partition keys.
+ *
+ * Keys with a collection bound using cass_statement_bind_collection() are
+ * not cached and always return an error.
+ *
+ * @public @memberof CassStatement
+ *
+ * @param[in] statement
+ * @param[out] token
+ * @return CASS_OK if all of the key parameters are bound, otherwise
+ * CASS_ERROR_LIB_PARAMETER_UNSET.
+ *
+ * @see cass_statement_add_key_index()
+ */
+CASS_EXPORT CassError
+cass_statement_routing_token(const CassStatement* statement,
+                             cass_int64_t* token);
+
 
 /**
  * Sets the statement's keyspace for use with token-aware routing.
@@ -3916,6 +4272,25 @@ CASS_EXPORT CassError
 cass_statement_set_retry_policy(CassStatement* statement,
                                 CassRetryPolicy* retry_policy);
 
+/**
+ * Sets whether the statement is idempotent. Idempotent statements can be
+ * speculatively executed.
+ *
+ * <b>Default:</b> cass_false (not idempotent)
+ *
+ * @public @memberof CassStatement
+ *
+ * @param[in] statement
+ * @param[in] is_idempotent
+ * @return CASS_OK if successful, otherwise an error occurred.
+ *
+ * @see cass_cluster_set_constant_speculative_execution_policy()
+ * @see cass_cluster_set_percentile_speculative_execution_policy()
+ */
+CASS_EXPORT CassError
+cass_statement_set_is_idempotent(CassStatement* statement,
+                                 cass_bool_t is_idempotent);
+
 /**
  * Sets the statement's custom payload.
  *
@@ -5176,6 +5551,27 @@ CASS_EXPORT CassError
 cass_batch_set_retry_policy(CassBatch* batch,
                             CassRetryPolicy* retry_policy);
 
+/**
+ * Sets whether the batch is idempotent. Idempotent batches can be
+ * speculatively executed.
+ *
+ * <b>Default:</b> cass_false (not idempotent)
+ *
+ * @cassandra{2.0+}
+ *
+ * @public @memberof CassBatch
+ *
+ * @param[in] batch
+ * @param[in] is_idempotent
+ * @return CASS_OK if successful, otherwise an error occurred.
+ *
+ * @see cass_cluster_set_constant_speculative_execution_policy()
+ * @see cass_cluster_set_percentile_speculative_execution_policy()
+ */
+CASS_EXPORT CassError
+cass_batch_set_is_idempotent(CassBatch* batch,
+                             cass_bool_t is_idempotent);
+
 /**
  * Sets the batch's custom payload.
  *
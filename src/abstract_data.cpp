@@ -27,6 +27,7 @@ namespace cass {
 CassError AbstractData::set(size_t index, CassNull value) {
   CASS_CHECK_INDEX_AND_TYPE(index, value);
   elements_[index] = Element(value);
+  on_element_set(index);
   return CASS_OK;
 }
 
@@ -37,18 +38,21 @@ CassError AbstractData::set(size_t index, const Collection* value) {
     return CASS_ERROR_LIB_INVALID_ITEM_COUNT;
   }
   elements_[index] = value;
+  on_element_set(index);
   return CASS_OK;
 }
 
 CassError AbstractData::set(size_t index, const Tuple* value) {
   CASS_CHECK_INDEX_AND_TYPE(index, value);
   elements_[index] = value->encode_with_length();
+  on_element_set(index);
   return CASS_OK;
 }
 
 CassError AbstractData::set(size_t index, const UserTypeValue* value) {
   CASS_CHECK_INDEX_AND_TYPE(index, value);
   elements_[index] = value->encode_with_length();
+  on_element_set(index);
   return CASS_OK;
 }
 
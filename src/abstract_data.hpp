@@ -70,6 +70,10 @@ public:
       return type_ == NUL;
     }
 
+    bool is_collection() const {
+      return type_ == COLLECTION;
+    }
+
     size_t get_size(int version) const;
     size_t copy_buffer(int version, size_t pos, Buffer* buf) const;
     Buffer get_buffer_cached(int version, Request::EncodingCache* cache, bool add_to_cache) const;
@@ -94,12 +98,14 @@ public:
   void reset(size_t count) {
     elements_.clear();
     elements_.resize(count);
+    on_elements_reset();
   }
 
 #define SET_TYPE(Type)                                  \
   CassError set(size_t index, const Type value) {       \
     CASS_CHECK_INDEX_AND_TYPE(index, value);            \
     elements_[index] = cass::encode_with_length(value); \
+    on_element_set(index);                              \
     return CASS_OK;                                     \
   }
 
@@ -151,6 +157,11 @@ protected:
                              IndexVec* indices) = 0;
   virtual const DataType::ConstPtr& get_type(size_t index) const = 0;
 
+  // Called after the element at "index" is set and after all of the elements
+  // are reset
+  virtual void on_element_set(size_t index) { }
+  virtual void on_elements_reset() { }
+
 private:
   template <class T>
   CassError check(size_t index, const T value) {
@@ -0,0 +1,90 @@
+/*
+  Copyright (c) 2014-2016 DataStax
+
+  Licensed under the Apache License, Version 2.0 (the "License");
+  you may not use this file except in compliance with the License.
+  You may obtain a copy of the License at
+
+  http://www.apache.org/licenses/LICENSE-2.0
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+*/
+
+#ifndef __CASS_ADAPTIVE_FLUSH_HPP_INCLUDED__
+#define __CASS_ADAPTIVE_FLUSH_HPP_INCLUDED__
+
+#include <algorithm>
+#include <stddef.h>
+#include <stdint.h>
+
+namespace cass {
+
+// Decides how many requests an IO worker processes per flush and how long
+// a flush may be delayed waiting for more requests. The batch doubles while
+// the request queue is backed up, up to MAX_BATCH_SIZE_FACTOR times the
+// configured requests per flush, and halves back down once it drains.
+class AdaptiveFlush {
+public:
+  static const size_t MAX_BATCH_SIZE_FACTOR = 8;
+
+  AdaptiveFlush(bool is_enabled, size_t min_batch_size, unsigned max_delay_us)
+    : is_enabled_(is_enabled)
+    , min_batch_size_(min_batch_size)
+    , max_delay_ns_(1000 * static_cast<uint64_t>(max_delay_us))
+    , batch_size_(min_batch_size)
+    , is_queue_backed_up_(false)
+    , delay_start_ns_(0) { }
+
+  size_t batch_size() const {
+    return is_enabled_ ? batch_size_ : min_batch_size_;
+  }
+
+  size_t max_batch_size() const {
+    return MAX_BATCH_SIZE_FACTOR * min_batch_size_;
+  }
+
+  bool is_delay_enabled() const {
+    return is_enabled_ && max_delay_ns_ > 0;
+  }
+
+  // Called after a batch of requests has been processed
+  void update(bool is_queue_backed_up) {
+    if (!is_enabled_) return;
+    if (is_queue_backed_up) {
+      batch_size_ = std::min(2 * batch_size_, max_batch_size());
+    } else {
+      batch_size_ = std::max(batch_size_ / 2, min_batch_size_);
+    }
+    is_queue_backed_up_ = is_queue_backed_up;
+  }
+
+  // Called when the first unflushed write is queued
+  void start_delay(uint64_t now_ns) {
+    delay_start_ns_ = now_ns;
+  }
+
+  // A backed up queue already produces large batches so there's no reason
+  // to wait for more requests.
+  bool should_delay(uint64_t now_ns) const {
+    if (!is_delay_enabled() || is_queue_backed_up_) {
+      return false;
+    }
+    return now_ns - delay_start_ns_ < max_delay_ns_;
+  }
+
+private:
+  bool is_enabled_;
+  size_t min_batch_size_;
+  uint64_t max_delay_ns_;
+  size_t batch_size_;
+  bool is_queue_backed_up_;
+  uint64_t delay_start_ns_;
+};
+
+} // namespace cass
+
+#endif
@@ -17,17 +17,23 @@
 #ifndef __CASS_ASYNC_QUEUE_HPP_INCLUDED__
 #define __CASS_ASYNC_QUEUE_HPP_INCLUDED__
 
+#include "atomic.hpp"
 #include "utils.hpp"
 
 #include <uv.h>
 
 namespace cass {
 
+// A queue whose consumer runs on a libuv loop. Producers only wake the loop
+// (uv_async_send()) when the consumer isn't already awake or about to wake
+// up. The consumer must either dequeue until the queue is empty or call
+// send() to wake itself up again.
 template <typename Q>
 class AsyncQueue {
 public:
   AsyncQueue(size_t queue_size)
-      : queue_(queue_size) {}
+      : is_signaled_(false)
+      , queue_(queue_size) {}
 
   int init(uv_loop_t* loop, void* data, uv_async_cb async_cb) {
     async_.data = data;
@@ -44,23 +50,36 @@ public:
 
   bool enqueue(const typename Q::EntryType& data) {
     if (queue_.enqueue(data)) {
-      // uv_async_send() makes no guarantees about synchronization so it may
-      // be necessary to use a memory fence to make sure stores happen before
-      // the event loop wakes up and runs the async callback.
-      Q::memory_fence();
-      uv_async_send(&async_);
+      // Orders the store into the queue before the load of the flag. This is
+      // paired with the fence in dequeue() so either this thread sees the
+      // flag cleared and wakes the loop or the consumer sees the new entry.
+      atomic_thread_fence(MEMORY_ORDER_SEQ_CST);
+      bool expected = false;
+      if (!is_signaled_.load(MEMORY_ORDER_RELAXED) &&
+          is_signaled_.compare_exchange_strong(expected, true)) {
+        uv_async_send(&async_);
+      }
       return true;
     }
     return false;
   }
 
-  bool dequeue(typename Q::EntryType& data) { return queue_.dequeue(data); }
+  bool dequeue(typename Q::EntryType& data) {
+    if (queue_.dequeue(data)) return true;
+    // The queue looks empty so producers need to wake the loop for any new
+    // entries. Check again for an entry that was enqueued before the flag
+    // was cleared.
+    is_signaled_.store(false, MEMORY_ORDER_RELAXED);
+    atomic_thread_fence(MEMORY_ORDER_SEQ_CST);
+    return queue_.dequeue(data);
+  }
 
   // Testing only
   bool is_empty() const { return queue_.is_empty(); }
 
 private:
   uv_async_t async_;
+  Atomic<bool> is_signaled_;
   Q queue_;
 };
 
@@ -21,6 +21,7 @@
 #include "external_types.hpp"
 #include "serialization.hpp"
 #include "statement.hpp"
+#include "token_map.hpp"
 
 extern "C" {
 
@@ -58,6 +59,12 @@ CassError cass_batch_set_retry_policy(CassBatch* batch,
   return CASS_OK;
 }
 
+CassError cass_batch_set_is_idempotent(CassBatch* batch,
+                                       cass_bool_t is_idempotent) {
+  batch->set_is_idempotent(is_idempotent == cass_true);
+  return CASS_OK;
+}
+
 CassError cass_batch_set_custom_payload(CassBatch* batch,
                                         const CassCustomPayload* payload) {
   batch->set_custom_payload(payload);
@@ -177,4 +184,75 @@ bool BatchRequest::get_routing_key(std::string* routing_key, EncodingCache* cach
   return false;
 }
 
+void BatchRequest::split_by_replicas(KeyspaceId connected_keyspace_id,
+                                     const TokenMap& token_map,
+                                     Vec* batches) const {
+  // The token map shares one HostVec between all tokens with the same
+  // replicas, so statements are grouped by the replica set's pointer rather
+  // than by comparing host addresses. Unroutable statements are grouped
+  // under NULL.
+  typedef std::map<const HostVec*, size_t> GroupMap;
+  GroupMap groups;
+
+  std::string routing_key;
+  EncodingCache cache;
+  for (StatementList::const_iterator i = statements_.begin(),
+       end = statements_.end(); i != end; ++i) {
+    Statement* statement = i->get();
+    const KeyspaceId keyspace_id = statement->keyspace().empty()
+                                   ? connected_keyspace_id
+                                   : token_map.keyspace_id(statement->keyspace(),
+                                                           statement->keyspace_id_cache());
+
+    const HostVec* replicas = NULL;
+    if (keyspace_id != INVALID_KEYSPACE_ID) {
+      int64_t token;
+      if (token_map.has_int64_tokens() && statement->get_routing_token(&token)) {
+        replicas = &(*token_map.get_replicas(keyspace_id, token));
+      } else if (statement->get_routing_key(&routing_key, &cache)) {
+        replicas = &(*token_map.get_replicas(keyspace_id, routing_key));
+      }
+      if (replicas != NULL && replicas->empty()) {
+        replicas = NULL;
+      }
+    }
+
+    GroupMap::iterator group = groups.find(replicas);
+    if (group == groups.end()) {
+      SharedRefPtr<BatchRequest> batch(new BatchRequest(type_));
+      batch->set_consistency(consistency());
+      batch->set_serial_consistency(serial_consistency());
+      batch->set_timestamp(timestamp());
+      batch->set_is_idempotent(is_idempotent());
+      batch->set_retry_policy(retry_policy());
+      batch->set_custom_payload(custom_payload().get());
+      // Route the batch using the keyspace of its first statement
+      if (!statement->keyspace().empty()) {
+        batch->set_keyspace(statement->keyspace());
+      } else if (!keyspace().empty()) {
+        batch->set_keyspace(keyspace());
+      }
+      group = groups.insert(GroupMap::value_type(replicas, batches->size())).first;
+      batches->push_back(batch);
+    }
+    (*batches)[group->second]->add_statement(statement);
+  }
+}
+
+bool BatchRequest::get_routing_token(int64_t* token) const {
+  // Only the first statement with a routing key is used for routing. If its
+  // token can't be cached (e.g. the key contains a collection) the caller
+  // falls back to get_routing_key().
+  for (BatchRequest::StatementList::const_iterator i = statements_.begin();
+       i != statements_.end(); ++i) {
+    if ((*i)->get_routing_token(token)) {
+      return true;
+    }
+    if ((*i)->has_routing_key()) {
+      return false;
+    }
+  }
+  return false;
+}
+
 } // namespace cass
@@ -25,15 +25,18 @@
 #include <list>
 #include <map>
 #include <string>
+#include <vector>
 
 namespace cass {
 
 class Statement;
 class ExecuteRequest;
+class TokenMap;
 
 class BatchRequest : public RoutableRequest {
 public:
   typedef std::list<SharedRefPtr<Statement> > StatementList;
+  typedef std::vector<SharedRefPtr<BatchRequest> > Vec;
 
   BatchRequest(uint8_t type_)
       : RoutableRequest(CQL_OPCODE_BATCH)
@@ -48,6 +51,14 @@ public:
   bool prepared_statement(const std::string& id, std::string* statement) const;
 
   virtual bool get_routing_key(std::string* routing_key, EncodingCache* cache) const;
+  virtual bool get_routing_token(int64_t* token) const;
+
+  // Groups the statements by the replicas of their partition keys and
+  // creates a batch, with the same settings as this one, for each group.
+  // Statements that can't be routed are kept together in a single batch.
+  void split_by_replicas(KeyspaceId connected_keyspace_id,
+                         const TokenMap& token_map,
+                         Vec* batches) const;
 
 private:
   int encode(int version, Handler* handler, BufferVec* bufs) const;
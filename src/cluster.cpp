@@ -16,9 +16,11 @@
 
 #include "cluster.hpp"
 
+#include "compression.hpp"
 #include "dc_aware_policy.hpp"
 #include "logger.hpp"
 #include "round_robin_policy.hpp"
+#include "speculative_execution.hpp"
 #include "external_types.hpp"
 #include "utils.hpp"
 
@@ -151,6 +153,27 @@ CassError cass_cluster_set_max_requests_per_flush(CassCluster* cluster,
   return CASS_OK;
 }
 
+void cass_cluster_set_adaptive_flush(CassCluster* cluster,
+                                     cass_bool_t enabled) {
+  cluster->config().set_adaptive_flush(enabled == cass_true);
+}
+
+CassError cass_cluster_set_adaptive_flush_settings(CassCluster* cluster,
+                                                   unsigned num_bytes,
+                                                   unsigned max_delay_us) {
+  if (num_bytes == 0) {
+    return CASS_ERROR_LIB_BAD_PARAMS;
+  }
+  cluster->config().set_adaptive_flush_bytes(num_bytes);
+  cluster->config().set_adaptive_flush_max_delay_us(max_delay_us);
+  return CASS_OK;
+}
+
+void cass_cluster_set_response_pooling(CassCluster* cluster,
+                                       cass_bool_t enabled) {
+  cluster->config().set_response_pooling(enabled == cass_true);
+}
+
 CassError cass_cluster_set_write_bytes_high_water_mark(CassCluster* cluster,
                                                        unsigned num_bytes) {
   if (num_bytes == 0 ||
@@ -285,6 +308,11 @@ void cass_cluster_set_latency_aware_routing_settings(CassCluster* cluster,
   cluster->config().set_latency_aware_routing_settings(settings);
 }
 
+void cass_cluster_set_least_outstanding_requests_routing(CassCluster* cluster,
+                                                         cass_bool_t enabled) {
+  cluster->config().set_least_outstanding_requests_routing(enabled == cass_true);
+}
+
 void cass_cluster_set_whitelist_filtering(CassCluster* cluster,
                                           const char* hosts) {
   size_t hosts_length
@@ -399,6 +427,46 @@ void cass_cluster_set_retry_policy(CassCluster* cluster,
   cluster->config().set_retry_policy(retry_policy);
 }
 
+CassError cass_cluster_set_constant_speculative_execution_policy(CassCluster* cluster,
+                                                                 cass_int64_t constant_delay_ms,
+                                                                 int max_speculative_executions) {
+  if (constant_delay_ms < 0 || max_speculative_executions < 0) {
+    return CASS_ERROR_LIB_BAD_PARAMS;
+  }
+  // Speculative executions can't be moved to the IO worker that owns their
+  // host
+  if (cluster->config().use_io_worker_affinity()) {
+    return CASS_ERROR_LIB_BAD_PARAMS;
+  }
+  cluster->config().set_speculative_execution_policy(
+        new cass::ConstantSpeculativeExecutionPolicy(constant_delay_ms,
+                                                     max_speculative_executions));
+  return CASS_OK;
+}
+
+CassError cass_cluster_set_percentile_speculative_execution_policy(CassCluster* cluster,
+                                                                   cass_double_t percentile,
+                                                                   int max_speculative_executions) {
+  if (percentile <= 0.0 || percentile >= 100.0 || max_speculative_executions < 0) {
+    return CASS_ERROR_LIB_BAD_PARAMS;
+  }
+  // Speculative executions can't be moved to the IO worker that owns their
+  // host
+  if (cluster->config().use_io_worker_affinity()) {
+    return CASS_ERROR_LIB_BAD_PARAMS;
+  }
+  cluster->config().set_speculative_execution_policy(
+        new cass::PercentileSpeculativeExecutionPolicy(percentile,
+                                                       max_speculative_executions));
+  return CASS_OK;
+}
+
+CassError cass_cluster_set_no_speculative_execution_policy(CassCluster* cluster) {
+  cluster->config().set_speculative_execution_policy(
+        new cass::NoSpeculativeExecutionPolicy());
+  return CASS_OK;
+}
+
 void cass_cluster_set_timestamp_gen(CassCluster* cluster,
                                     CassTimestampGen* timestamp_gen) {
   cluster->config().set_timestamp_gen(timestamp_gen);
@@ -423,6 +491,34 @@ CassError cass_cluster_set_use_hostname_resolution(CassCluster* cluster,
 #endif
 }
 
+void cass_cluster_set_use_direct_dispatch(CassCluster* cluster,
+                                          cass_bool_t enabled) {
+  cluster->config().set_use_direct_dispatch(enabled == cass_true);
+}
+
+CassError cass_cluster_set_use_io_worker_affinity(CassCluster* cluster,
+                                                  cass_bool_t enabled) {
+  if (enabled == cass_true && cluster->config().use_speculative_executions()) {
+    return CASS_ERROR_LIB_BAD_PARAMS;
+  }
+  cluster->config().set_use_io_worker_affinity(enabled == cass_true);
+  return CASS_OK;
+}
+
+CassError cass_cluster_set_compression(CassCluster* cluster,
+                                       int compression_types) {
+  if (!cass::Compressor::is_supported(compression_types)) {
+    return CASS_ERROR_LIB_NOT_IMPLEMENTED;
+  }
+  cluster->config().set_compression_types(compression_types);
+  return CASS_OK;
+}
+
+void cass_cluster_set_compression_threshold(CassCluster* cluster,
+                                            unsigned num_bytes) {
+  cluster->config().set_compression_threshold(num_bytes);
+}
+
 void cass_cluster_free(CassCluster* cluster) {
   delete cluster->from();
 }
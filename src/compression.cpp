@@ -0,0 +1,131 @@
+/*
+  Copyright (c) 2014-2016 DataStax
+
+  Licensed under the Apache License, Version 2.0 (the "License");
+  you may not use this file except in compliance with the License.
+  You may obtain a copy of the License at
+
+  http://www.apache.org/licenses/LICENSE-2.0
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+*/
+
+#include "compression.hpp"
+
+#include "serialization.hpp"
+
+#include <algorithm>
+
+#ifdef CASS_USE_LZ4
+#include <lz4.h>
+#endif
+
+#ifdef CASS_USE_SNAPPY
+#include <snappy-c.h>
+#endif
+
+namespace cass {
+
+#if defined(CASS_USE_LZ4) || defined(CASS_USE_SNAPPY)
+static bool is_supported_by_server(const std::list<std::string>& supported,
+                                   const char* name) {
+  return std::find(supported.begin(), supported.end(), name) != supported.end();
+}
+#endif
+
+bool Compressor::is_supported(int compression_types) {
+  int available = CASS_COMPRESSION_NONE;
+#ifdef CASS_USE_LZ4
+  available |= CASS_COMPRESSION_LZ4;
+#endif
+#ifdef CASS_USE_SNAPPY
+  available |= CASS_COMPRESSION_SNAPPY;
+#endif
+  return (compression_types & ~available) == 0;
+}
+
+Compressor* Compressor::negotiate(int compression_types,
+                                  int protocol_version,
+                                  const std::list<std::string>& supported) {
+#ifdef CASS_USE_LZ4
+  // LZ4 was added in protocol version 2
+  if ((compression_types & CASS_COMPRESSION_LZ4) &&
+      protocol_version >= 2 &&
+      is_supported_by_server(supported, "lz4")) {
+    return new Lz4Compressor();
+  }
+#endif
+#ifdef CASS_USE_SNAPPY
+  if ((compression_types & CASS_COMPRESSION_SNAPPY) &&
+      is_supported_by_server(supported, "snappy")) {
+    return new SnappyCompressor();
+  }
+#endif
+  return NULL;
+}
+
+#ifdef CASS_USE_LZ4
+size_t Lz4Compressor::max_compressed_length(size_t input_size) const {
+  return sizeof(int32_t) + LZ4_compressBound(static_cast<int>(input_size));
+}
+
+bool Lz4Compressor::compress(const char* input, size_t input_size,
+                             char* output, size_t* output_size) const {
+  encode_int32(output, static_cast<int32_t>(input_size));
+  int bound = LZ4_compressBound(static_cast<int>(input_size));
+  int result = LZ4_compress_default(input, output + sizeof(int32_t),
+                                    static_cast<int>(input_size), bound);
+  if (result <= 0) return false;
+  *output_size = sizeof(int32_t) + result;
+  return true;
+}
+
+bool Lz4Compressor::uncompressed_length(const char* input, size_t input_size,
+                                        size_t* length) const {
+  if (input_size < sizeof(int32_t)) return false;
+  int32_t result;
+  decode_int32(const_cast<char*>(input), result);
+  if (result < 0) return false;
+  *length = static_cast<size_t>(result);
+  return true;
+}
+
+bool Lz4Compressor::decompress(const char* input, size_t input_size,
+                               char* output, size_t output_size) const {
+  if (input_size < sizeof(int32_t)) return false;
+  int result = LZ4_decompress_safe(input + sizeof(int32_t), output,
+                                   static_cast<int>(input_size - sizeof(int32_t)),
+                                   static_cast<int>(output_size));
+  return result >= 0 && static_cast<size_t>(result) == output_size;
+}
+#endif
+
+#ifdef CASS_USE_SNAPPY
+size_t SnappyCompressor::max_compressed_length(size_t input_size) const {
+  return snappy_max_compressed_length(input_size);
+}
+
+bool SnappyCompressor::compress(const char* input, size_t input_size,
+                                char* output, size_t* output_size) const {
+  *output_size = snappy_max_compressed_length(input_size);
+  return snappy_compress(input, input_size, output, output_size) == SNAPPY_OK;
+}
+
+bool SnappyCompressor::uncompressed_length(const char* input, size_t input_size,
+                                           size_t* length) const {
+  return snappy_uncompressed_length(input, input_size, length) == SNAPPY_OK;
+}
+
+bool SnappyCompressor::decompress(const char* input, size_t input_size,
+                                  char* output, size_t output_size) const {
+  size_t length = output_size;
+  return snappy_uncompress(input, input_size, output, &length) == SNAPPY_OK &&
+      length == output_size;
+}
+#endif
+
+} // namespace cass
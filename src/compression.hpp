@@ -0,0 +1,108 @@
+/*
+  Copyright (c) 2014-2016 DataStax
+
+  Licensed under the Apache License, Version 2.0 (the "License");
+  you may not use this file except in compliance with the License.
+  You may obtain a copy of the License at
+
+  http://www.apache.org/licenses/LICENSE-2.0
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+*/
+
+#ifndef __CASS_COMPRESSION_HPP_INCLUDED__
+#define __CASS_COMPRESSION_HPP_INCLUDED__
+
+#include "cassandra.h"
+#include "macros.hpp"
+#include "ref_counted.hpp"
+
+#include <list>
+#include <string>
+
+namespace cass {
+
+// Frame body compression for the native protocol. The server advertises the
+// algorithms it supports in the SUPPORTED response and the one chosen is sent
+// back in the STARTUP request. Every frame after the STARTUP request may have
+// its body compressed (CASS_FLAG_COMPRESSION).
+class Compressor : public RefCounted<Compressor> {
+public:
+  typedef SharedRefPtr<const Compressor> ConstPtr;
+
+  virtual ~Compressor() { }
+
+  // The algorithm name used by the "COMPRESSION" startup option
+  virtual const char* name() const = 0;
+
+  virtual size_t max_compressed_length(size_t input_size) const = 0;
+
+  // "output" must be at least max_compressed_length() bytes. On success
+  // "output_size" is set to the number of compressed bytes.
+  virtual bool compress(const char* input, size_t input_size,
+                        char* output, size_t* output_size) const = 0;
+
+  virtual bool uncompressed_length(const char* input, size_t input_size,
+                                   size_t* length) const = 0;
+
+  // "output" must be exactly uncompressed_length() bytes
+  virtual bool decompress(const char* input, size_t input_size,
+                          char* output, size_t output_size) const = 0;
+
+  // Returns true if support for the compression types was compiled in
+  static bool is_supported(int compression_types);
+
+  // Picks a compressor from "compression_types" (a bitwise OR of
+  // CassCompressionType) that's also in the server's supported list. LZ4 is
+  // preferred over Snappy because it's faster at a similar ratio. Returns
+  // NULL if there's no match.
+  static Compressor* negotiate(int compression_types,
+                               int protocol_version,
+                               const std::list<std::string>& supported);
+};
+
+#ifdef CASS_USE_LZ4
+// Body format: [int] uncompressed length followed by a LZ4 block
+class Lz4Compressor : public Compressor {
+public:
+  virtual const char* name() const { return "lz4"; }
+
+  virtual size_t max_compressed_length(size_t input_size) const;
+
+  virtual bool compress(const char* input, size_t input_size,
+                        char* output, size_t* output_size) const;
+
+  virtual bool uncompressed_length(const char* input, size_t input_size,
+                                   size_t* length) const;
+
+  virtual bool decompress(const char* input, size_t input_size,
+                          char* output, size_t output_size) const;
+};
+#endif
+
+#ifdef CASS_USE_SNAPPY
+// Body format: a raw Snappy buffer (it includes the uncompressed length)
+class SnappyCompressor : public Compressor {
+public:
+  virtual const char* name() const { return "snappy"; }
+
+  virtual size_t max_compressed_length(size_t input_size) const;
+
+  virtual bool compress(const char* input, size_t input_size,
+                        char* output, size_t* output_size) const;
+
+  virtual bool uncompressed_length(const char* input, size_t input_size,
+                                   size_t* length) const;
+
+  virtual bool decompress(const char* input, size_t input_size,
+                          char* output, size_t output_size) const;
+};
+#endif
+
+} // namespace cass
+
+#endif
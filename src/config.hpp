@@ -21,7 +21,9 @@
 #include "cassandra.h"
 #include "dc_aware_policy.hpp"
 #include "latency_aware_policy.hpp"
+#include "least_outstanding_requests_policy.hpp"
 #include "retry_policy.hpp"
+#include "speculative_execution.hpp"
 #include "ssl.hpp"
 #include "timestamp_generator.hpp"
 #include "token_aware_policy.hpp"
@@ -51,6 +53,10 @@ public:
       , reconnect_wait_time_ms_(2000)
       , max_concurrent_creation_(1)
       , max_requests_per_flush_(128)
+      , adaptive_flush_(false)
+      , adaptive_flush_bytes_(64 * 1024)
+      , adaptive_flush_max_delay_us_(0)
+      , response_pooling_(false)
       , max_concurrent_requests_threshold_(100)
       , write_bytes_high_water_mark_(64 * 1024)
       , write_bytes_low_water_mark_(32 * 1024)
@@ -66,6 +72,7 @@ public:
       , load_balancing_policy_(new DCAwarePolicy())
       , token_aware_routing_(true)
       , latency_aware_routing_(false)
+      , least_outstanding_requests_routing_(false)
       , tcp_nodelay_enable_(true)
       , tcp_keepalive_enable_(false)
       , tcp_keepalive_delay_secs_(0)
@@ -73,8 +80,13 @@ public:
       , connection_heartbeat_interval_secs_(30)
       , timestamp_gen_(new ServerSideTimestampGenerator())
       , retry_policy_(new DefaultRetryPolicy())
+      , speculative_execution_policy_(new NoSpeculativeExecutionPolicy())
       , use_schema_(true)
-      , use_hostname_resolution_(false) { }
+      , use_hostname_resolution_(false)
+      , use_direct_dispatch_(false)
+      , use_io_worker_affinity_(false)
+      , compression_types_(CASS_COMPRESSION_NONE)
+      , compression_threshold_(512) { }
 
   unsigned thread_count_io() const { return thread_count_io_; }
 
@@ -166,6 +178,32 @@ public:
     max_requests_per_flush_ = num_requests;
   }
 
+  bool adaptive_flush() const { return adaptive_flush_; }
+
+  void set_adaptive_flush(bool is_adaptive_flush) {
+    adaptive_flush_ = is_adaptive_flush;
+  }
+
+  unsigned adaptive_flush_bytes() const { return adaptive_flush_bytes_; }
+
+  void set_adaptive_flush_bytes(unsigned num_bytes) {
+    adaptive_flush_bytes_ = num_bytes;
+  }
+
+  unsigned adaptive_flush_max_delay_us() const {
+    return adaptive_flush_max_delay_us_;
+  }
+
+  void set_adaptive_flush_max_delay_us(unsigned max_delay_us) {
+    adaptive_flush_max_delay_us_ = max_delay_us;
+  }
+
+  bool response_pooling() const { return response_pooling_; }
+
+  void set_response_pooling(bool is_response_pooling) {
+    response_pooling_ = is_response_pooling;
+  }
+
   unsigned max_concurrent_requests_threshold() const {
     return max_concurrent_requests_threshold_;
   }
@@ -239,7 +277,7 @@ public:
 
   LoadBalancingPolicy* load_balancing_policy() const {
     // The base LBP can be augmented by special wrappers (whitelist,
-    // token aware, latency aware)
+    // token aware, least outstanding requests, latency aware)
     LoadBalancingPolicy* chain = load_balancing_policy_->new_instance();
     if (!blacklist_.empty()) {
       chain = new BlacklistPolicy(chain, blacklist_);
@@ -256,6 +294,9 @@ public:
     if (token_aware_routing()) {
       chain = new TokenAwarePolicy(chain);
     }
+    if (least_outstanding_requests_routing()) {
+      chain = new LeastOutstandingRequestsPolicy(chain);
+    }
     if (latency_aware()) {
       chain = new LatencyAwarePolicy(chain, latency_aware_routing_settings_);
     }
@@ -285,6 +326,12 @@ public:
     latency_aware_routing_settings_ = settings;
   }
 
+  bool least_outstanding_requests_routing() const { return least_outstanding_requests_routing_; }
+
+  void set_least_outstanding_requests_routing(bool is_least_outstanding_requests) {
+    least_outstanding_requests_routing_ = is_least_outstanding_requests;
+  }
+
   ContactPointList& whitelist() {
     return whitelist_;
   }
@@ -349,6 +396,19 @@ public:
     retry_policy_.reset(retry_policy);
   }
 
+  SpeculativeExecutionPolicy* speculative_execution_policy() const {
+    return speculative_execution_policy_->new_instance();
+  }
+
+  void set_speculative_execution_policy(SpeculativeExecutionPolicy* sep) {
+    if (sep == NULL) return;
+    speculative_execution_policy_.reset(sep);
+  }
+
+  bool use_speculative_executions() const {
+    return speculative_execution_policy_->is_enabled();
+  }
+
   bool use_schema() const { return use_schema_; }
   void set_use_schema(bool enable) {
     use_schema_ = enable;
@@ -359,6 +419,26 @@ public:
     use_hostname_resolution_ = enable;
   }
 
+  bool use_direct_dispatch() const { return use_direct_dispatch_; }
+  void set_use_direct_dispatch(bool enable) {
+    use_direct_dispatch_ = enable;
+  }
+
+  bool use_io_worker_affinity() const { return use_io_worker_affinity_; }
+  void set_use_io_worker_affinity(bool enable) {
+    use_io_worker_affinity_ = enable;
+  }
+
+  int compression_types() const { return compression_types_; }
+  void set_compression_types(int compression_types) {
+    compression_types_ = compression_types;
+  }
+
+  unsigned compression_threshold() const { return compression_threshold_; }
+  void set_compression_threshold(unsigned num_bytes) {
+    compression_threshold_ = num_bytes;
+  }
+
 private:
   int port_;
   int protocol_version_;
@@ -372,6 +452,10 @@ private:
   unsigned reconnect_wait_time_ms_;
   unsigned max_concurrent_creation_;
   unsigned max_requests_per_flush_;
+  bool adaptive_flush_;
+  unsigned adaptive_flush_bytes_;
+  unsigned adaptive_flush_max_delay_us_;
+  bool response_pooling_;
   unsigned max_concurrent_requests_threshold_;
   unsigned write_bytes_high_water_mark_;
   unsigned write_bytes_low_water_mark_;
@@ -389,6 +473,7 @@ private:
   bool token_aware_routing_;
   bool latency_aware_routing_;
   LatencyAwarePolicy::Settings latency_aware_routing_settings_;
+  bool least_outstanding_requests_routing_;
   ContactPointList whitelist_;
   ContactPointList blacklist_;
   DcList whitelist_dc_;
@@ -400,8 +485,13 @@ private:
   unsigned connection_heartbeat_interval_secs_;
   SharedRefPtr<TimestampGenerator> timestamp_gen_;
   SharedRefPtr<RetryPolicy> retry_policy_;
+  SharedRefPtr<SpeculativeExecutionPolicy> speculative_execution_policy_;
   bool use_schema_;
   bool use_hostname_resolution_;
+  bool use_direct_dispatch_;
+  bool use_io_worker_affinity_;
+  int compression_types_;
+  unsigned compression_threshold_;
 };
 
 } // namespace cass
@@ -176,8 +176,10 @@ void Connection::HeartbeatHandler::on_timeout() {
 }
 
 Connection::Connection(uv_loop_t* loop,
+                       TimerWheel* timer_wheel,
                        const Config& config,
                        Metrics* metrics,
+                       ResponseBufferPool* response_buffer_pool,
                        const Host::ConstPtr& host,
                        const std::string& keyspace,
                        int protocol_version,
@@ -187,17 +189,20 @@ Connection::Connection(uv_loop_t* loop,
     , ssl_error_code_(CASS_OK)
     , pending_writes_size_(0)
     , loop_(loop)
+    , timer_wheel_(timer_wheel)
     , config_(config)
     , metrics_(metrics)
     , host_(host)
     , keyspace_(keyspace)
     , protocol_version_(protocol_version)
     , listener_(listener)
-    , response_(new ResponseMessage())
+    , response_buffer_pool_(response_buffer_pool)
+    , response_(new ResponseMessage(response_buffer_pool))
     , stream_manager_(protocol_version)
     , ssl_session_(NULL)
     , idle_start_time_ms_(0)
-    , heartbeat_outstanding_(false) {
+    , heartbeat_outstanding_(false)
+    , direct_read_buffer_(NULL) {
   socket_.data = this;
   uv_tcp_init(loop_, &socket_);
 
@@ -236,6 +241,14 @@ void Connection::connect() {
   }
 }
 
+void Connection::set_host(const Host::ConstPtr& host) {
+  if (host.get() == host_.get()) return;
+  int pending = static_cast<int>(stream_manager_.pending_streams());
+  host_->dec_inflight_request_count(pending);
+  host->inc_inflight_request_count(pending);
+  host_ = host;
+}
+
 bool Connection::write(Handler* handler, bool flush_immediately) {
   return internal_write(handler, flush_immediately, true);
 }
@@ -245,6 +258,7 @@ bool Connection::internal_write(Handler* handler, bool flush_immediately, bool r
   if (stream < 0) {
     return false;
   }
+  host_->inc_inflight_request_count();
 
   handler->inc_ref(); // Connection reference
   handler->set_connection(this);
@@ -263,6 +277,7 @@ bool Connection::internal_write(Handler* handler, bool flush_immediately, bool r
   int32_t request_size = pending_write->write(handler);
   if (request_size < 0) {
     stream_manager_.release(stream);
+    host_->dec_inflight_request_count();
     switch (request_size) {
       case Request::ENCODE_ERROR_BATCH_WITH_NAMED_VALUES:
       case Request::ENCODE_ERROR_PARAMETER_UNSET:
@@ -292,7 +307,7 @@ bool Connection::internal_write(Handler* handler, bool flush_immediately, bool r
             opcode_to_string(handler->request()->opcode()).c_str(), stream);
 
   handler->set_state(Handler::REQUEST_STATE_WRITING);
-  handler->start_timer(loop_,
+  handler->start_timer(timer_wheel_,
                        config_.request_timeout_ms(),
                        handler,
                        Connection::on_timeout);
@@ -315,6 +330,13 @@ void Connection::flush() {
   pending_writes_.back()->flush();
 }
 
+size_t Connection::unflushed_size() {
+  if (pending_writes_.is_empty() || pending_writes_.back()->is_flushed()) {
+    return 0;
+  }
+  return pending_writes_.back()->size();
+}
+
 void Connection::schedule_schema_agreement(const SharedRefPtr<SchemaChangeHandler>& handler, uint64_t wait) {
   PendingSchemaAgreement* pending_schema_agreement = new PendingSchemaAgreement(handler);
   pending_schema_agreements_.add_to_back(pending_schema_agreement);
@@ -426,7 +448,7 @@ void Connection::consume(char* input, size_t size) {
   size_t remaining = size;
 
   while (remaining != 0) {
-    ssize_t consumed = response_->decode(buffer, remaining);
+    ssize_t consumed = response_->decode(buffer, remaining, compressor_.get());
     if (consumed <= 0) {
       notify_error("Error consuming message");
       remaining = 0;
@@ -435,7 +457,12 @@ void Connection::consume(char* input, size_t size) {
 
     if (response_->is_body_ready()) {
       ScopedPtr<ResponseMessage> response(response_.release());
-      response_.reset(new ResponseMessage());
+      response_.reset(acquire_response());
+
+      if (response->compressed_length() > 0) {
+        metrics_->uncompressed_bytes_received.add(response->length());
+        metrics_->compressed_bytes_received.add(response->compressed_length());
+      }
 
       LOG_TRACE("Consumed message type %s with stream %d, input %u, remaining %u on host %s",
                 opcode_to_string(response->opcode()).c_str(),
@@ -454,6 +481,7 @@ void Connection::consume(char* input, size_t size) {
       } else {
         Handler* handler = NULL;
         if (stream_manager_.get_pending_and_release(response->stream(), handler)) {
+          host_->dec_inflight_request_count();
           switch (handler->state()) {
             case Handler::REQUEST_STATE_READING:
               maybe_set_keyspace(response.get());
@@ -492,12 +520,84 @@ void Connection::consume(char* input, size_t size) {
           notify_error("Invalid stream ID");
         }
       }
+
+      release_response(response.release());
     }
     remaining -= consumed;
     buffer += consumed;
   }
 }
 
+ResponseMessage* Connection::acquire_response() {
+  if (!response_buffer_pool_) {
+    return new ResponseMessage();
+  }
+  if (free_response_) {
+    metrics_->response_message_pool_hits.inc();
+    return free_response_.release();
+  }
+  metrics_->response_message_pool_misses.inc();
+  return new ResponseMessage(response_buffer_pool_.get());
+}
+
+void Connection::release_response(ResponseMessage* response) {
+  if (!response_buffer_pool_) {
+    delete response;
+    return;
+  }
+  // The handlers only keep the response's body so the message can be reused
+  response->reset();
+  free_response_.reset(response);
+}
+
+int32_t Connection::maybe_compress(BufferVec* bufs, size_t index, int32_t request_size) {
+  const size_t header_size
+      = (protocol_version_ >= 3) ? CASS_HEADER_SIZE_V3 : CASS_HEADER_SIZE_V1_AND_V2;
+  const size_t body_size = request_size - header_size;
+
+  if (body_size == 0 || body_size < config_.compression_threshold()) {
+    return request_size;
+  }
+
+  // The body is usually spread across several buffers, but the compressors
+  // require contiguous input.
+  const char* body;
+  if (bufs->size() == index + 2) {
+    body = (*bufs)[index + 1].data();
+  } else {
+    compression_input_.resize(body_size);
+    size_t offset = 0;
+    for (BufferVec::const_iterator it = bufs->begin() + index + 1,
+         end = bufs->end(); it != end; ++it) {
+      memcpy(&compression_input_[offset], it->data(), it->size());
+      offset += it->size();
+    }
+    assert(offset == body_size);
+    body = &compression_input_[0];
+  }
+
+  size_t compressed_size = 0;
+  compression_output_.resize(compressor_->max_compressed_length(body_size));
+  if (!compressor_->compress(body, body_size,
+                             &compression_output_[0], &compressed_size) ||
+      compressed_size >= body_size) {
+    // Send it uncompressed if it didn't shrink
+    return request_size;
+  }
+
+  Buffer& header = (*bufs)[index];
+  header.encode_byte(1, header.data()[1] | CASS_FLAG_COMPRESSION);
+  header.encode_int32(header_size - sizeof(int32_t), static_cast<int32_t>(compressed_size));
+
+  bufs->resize(index + 1);
+  bufs->push_back(Buffer(&compression_output_[0], compressed_size));
+
+  metrics_->uncompressed_bytes_sent.add(body_size);
+  metrics_->compressed_bytes_sent.add(compressed_size);
+
+  return header_size + compressed_size;
+}
+
 void Connection::maybe_set_keyspace(ResponseMessage* response) {
   if (response->opcode() == CQL_OPCODE_RESULT) {
     ResultResponse* result =
@@ -555,6 +655,10 @@ void Connection::on_close(uv_handle_t* handle) {
             static_cast<void*>(connection),
             connection->host_->address_string().c_str());
 
+  // Requests that are still outstanding will never be answered
+  connection->host_->dec_inflight_request_count(
+        static_cast<int>(connection->stream_manager_.pending_streams()));
+
   cleanup_pending_handlers(&connection->pending_reads_);
 
   while (!connection->pending_writes_.is_empty()) {
@@ -579,6 +683,14 @@ void Connection::on_close(uv_handle_t* handle) {
 }
 
 uv_buf_t Connection::internal_alloc_buffer(size_t suggested_size) {
+  size_t body_remaining = response_->body_remaining();
+  if (body_remaining >= BUFFER_REUSE_SIZE) {
+    // The rest of a large body is read directly into the response's buffer
+    // so that it isn't copied out of a read buffer. The read is limited to
+    // the body so the next frame starts in a new buffer.
+    direct_read_buffer_ = response_->body_buffer_pos();
+    return uv_buf_init(direct_read_buffer_, static_cast<unsigned int>(body_remaining));
+  }
   if (suggested_size <= BUFFER_REUSE_SIZE) {
     if (!buffer_reuse_list_.empty()) {
       uv_buf_t ret = buffer_reuse_list_.top();
@@ -591,6 +703,11 @@ uv_buf_t Connection::internal_alloc_buffer(size_t suggested_size) {
 }
 
 void Connection::internal_reuse_buffer(uv_buf_t buf) {
+  if (buf.base == direct_read_buffer_) {
+    // Owned by the response
+    direct_read_buffer_ = NULL;
+    return;
+  }
   if (buf.len == BUFFER_REUSE_SIZE && buffer_reuse_list_.size() < MAX_BUFFER_REUSE_NO) {
     buffer_reuse_list_.push(buf);
     return;
@@ -703,7 +820,7 @@ void Connection::on_read_ssl(uv_stream_t* client, ssize_t nread, const uv_buf_t*
   }
 }
 
-void Connection::on_timeout(Timer* timer) {
+void Connection::on_timeout(TimerWheel::Entry* timer) {
   Handler* handler = static_cast<Handler*>(timer->data());
   Connection* connection = handler->connection();
   LOG_INFO("Request timed out to host %s on connection(%p)",
@@ -773,10 +890,23 @@ void Connection::on_supported(ResponseMessage* response) {
   SupportedResponse* supported =
       static_cast<SupportedResponse*>(response->response_body().get());
 
-  // TODO(mstump) do something with the supported info
-  (void)supported;
+  Compressor::ConstPtr compressor(
+        Compressor::negotiate(config_.compression_types(),
+                              protocol_version_,
+                              supported->compression()));
+
+  if (compressor) {
+    LOG_DEBUG("Using %s compression on connection(%p) to host %s",
+              compressor->name(),
+              static_cast<void*>(this),
+              host_->address_string().c_str());
+    write(new StartupHandler(this, new StartupRequest(compressor->name())));
+  } else {
+    write(new StartupHandler(this, new StartupRequest()));
+  }
 
-  write(new StartupHandler(this, new StartupRequest()));
+  // The startup request is never compressed, only the requests that follow
+  compressor_ = compressor;
 }
 
 void Connection::on_pending_schema_agreement(Timer* timer) {
@@ -916,8 +1046,13 @@ int32_t Connection::PendingWriteBase::write(Handler* handler) {
     return request_size;
   }
 
+  if (connection_->compressor_) {
+    request_size = connection_->maybe_compress(&buffers_, last_buffer_size, request_size);
+  }
+
   size_ += request_size;
   handlers_.add_to_back(handler);
+  on_request_encoded(last_buffer_size);
 
   return request_size;
 }
@@ -946,6 +1081,7 @@ void Connection::PendingWriteBase::on_write(uv_write_t* req, int status) {
           }
 
           connection->stream_manager_.release(handler->stream());
+          connection->host_->dec_inflight_request_count();
           handler->stop_timer();
           handler->set_state(Handler::REQUEST_STATE_DONE);
           handler->on_error(CASS_ERROR_LIB_WRITE_ERROR,
@@ -993,20 +1129,56 @@ void Connection::PendingWriteBase::on_write(uv_write_t* req, int status) {
   connection->flush();
 }
 
+void Connection::PendingWrite::on_request_encoded(size_t first_buffer) {
+  // The request is copied into the arena so its buffers are released right
+  // away and the write is flushed using a few large iovecs
+  for (BufferVec::const_iterator it = buffers_.begin() + first_buffer,
+       end = buffers_.end(); it != end; ++it) {
+    arena_.append(*it);
+  }
+  buffers_.resize(first_buffer);
+}
+
 void Connection::PendingWrite::flush() {
-  if (!is_flushed_ && !buffers_.empty()) {
-    UvBufVec bufs;
+  if (!is_flushed_ && !arena_.is_empty()) {
+    const UvBufVec& bufs = arena_.bufs();
+    is_flushed_ = true;
+    uv_stream_t* sock_stream = copy_cast<uv_tcp_t*, uv_stream_t*>(&connection_->socket_);
 
-    bufs.reserve(buffers_.size());
+    Metrics* metrics = connection_->metrics_;
+    metrics->bytes_written.add(arena_.size());
+    metrics->record_flush(handlers_.size(), arena_.size());
+
+#if UV_VERSION_MAJOR >= 1
+    // Attempt to write directly into the socket's send buffer. This is only
+    // done for the oldest pending write so that the ordering of writes
+    // is preserved (libuv also refuses if there are queued writes).
+    if (connection_->pending_writes_.front() == this) {
+      int rc = uv_try_write(sock_stream, bufs.data(), bufs.size());
+      if (rc > 0) {
+        size_t written = static_cast<size_t>(rc);
+        metrics->bytes_written_sync.add(written);
+
+        if (written == arena_.size()) {
+          LOG_TRACE("Wrote %u bytes synchronously", static_cast<unsigned int>(written));
+          // Finish the write without waiting on the event loop. This
+          // deletes the pending write.
+          PendingWriteBase::on_write(&req_, 0);
+          return;
+        }
 
-    for (BufferVec::const_iterator it = buffers_.begin(),
-         end = buffers_.end(); it != end; ++it) {
-      bufs.push_back(uv_buf_init(const_cast<char*>(it->data()), it->size()));
+        // Only the unwritten remainder is queued
+        UvBufVec remaining;
+        arena_.unwritten_bufs(written, &remaining);
+        uv_write(&req_, sock_stream, &remaining[0], remaining.size(),
+                 PendingWrite::on_write);
+        return;
+      }
     }
+#endif
 
-    is_flushed_ = true;
-    uv_stream_t* sock_stream = copy_cast<uv_tcp_t*, uv_stream_t*>(&connection_->socket_);
-    uv_write(&req_, sock_stream, bufs.data(), bufs.size(), PendingWrite::on_write);
+    uv_write(&req_, sock_stream, const_cast<uv_buf_t*>(bufs.data()), bufs.size(),
+             PendingWrite::on_write);
   }
 }
 
@@ -1075,6 +1247,9 @@ void Connection::PendingWriteSsl::flush() {
 
     LOG_TRACE("Sending %u encrypted bytes", static_cast<unsigned int>(encrypted_size_));
 
+    connection_->metrics_->bytes_written.add(encrypted_size_);
+    connection_->metrics_->record_flush(handlers_.size(), size());
+
     uv_stream_t* sock_stream = copy_cast<uv_tcp_t*, uv_stream_t*>(&connection_->socket_);
     uv_write(&req_, sock_stream, bufs.data(), bufs.size(), PendingWriteSsl::on_write);
 
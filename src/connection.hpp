@@ -19,6 +19,7 @@
 
 #include "buffer.hpp"
 #include "cassandra.h"
+#include "compression.hpp"
 #include "handler.hpp"
 #include "host.hpp"
 #include "list.hpp"
@@ -32,10 +33,13 @@
 #include "ssl.hpp"
 #include "stream_manager.hpp"
 #include "timer.hpp"
+#include "timer_wheel.hpp"
+#include "write_arena.hpp"
 
 #include <uv.h>
 
 #include <stack>
+#include <vector>
 
 namespace cass {
 
@@ -93,8 +97,10 @@ public:
   };
 
   Connection(uv_loop_t* loop,
+             TimerWheel* timer_wheel,
              const Config& config,
              Metrics* metrics,
+             ResponseBufferPool* response_buffer_pool,
              const Host::ConstPtr& host,
              const std::string& keyspace,
              int protocol_version,
@@ -106,6 +112,9 @@ public:
   bool write(Handler* request, bool flush_immediately = true);
   void flush();
 
+  // The number of bytes written to the connection, but not yet flushed
+  size_t unflushed_size();
+
   void schedule_schema_agreement(const SharedRefPtr<SchemaChangeHandler>& handler, uint64_t wait);
 
   const Config& config() const { return config_; }
@@ -114,6 +123,10 @@ public:
   const std::string& address_string() const { return host_->address_string(); }
   const std::string& keyspace() const { return keyspace_; }
 
+  // Rebinds the connection to a new host object for the same address and
+  // moves the count of outstanding requests to it
+  void set_host(const Host::ConstPtr& host);
+
   void close();
   void defunct();
 
@@ -141,7 +154,7 @@ public:
   size_t available_streams() const { return stream_manager_.available_streams(); }
   size_t pending_request_count() const { return stream_manager_.pending_streams(); }
 
-  static void on_timeout(Timer* timer);
+  static void on_timeout(TimerWheel::Entry* timer);
 
 private:
   class SslHandshakeWriter {
@@ -210,6 +223,10 @@ private:
     virtual void flush() = 0;
 
   protected:
+    // Called with the index of the first buffer of each request added to
+    // "buffers_"
+    virtual void on_request_encoded(size_t first_buffer) { }
+
     static void on_write(uv_write_t* req, int status);
 
     Connection* connection_;
@@ -223,9 +240,16 @@ private:
   class PendingWrite : public PendingWriteBase {
   public:
     PendingWrite(Connection* connection)
-       : PendingWriteBase(connection) {}
+       : PendingWriteBase(connection)
+       , arena_(&connection->write_chunk_pool_) {}
 
     virtual void flush();
+
+  protected:
+    virtual void on_request_encoded(size_t first_buffer);
+
+  private:
+    WriteArena arena_;
   };
 
   class PendingWriteSsl : public PendingWriteBase {
@@ -257,6 +281,9 @@ private:
   void internal_close(ConnectionState close_state);
   void set_state(ConnectionState state);
   void consume(char* input, size_t size);
+  ResponseMessage* acquire_response();
+  void release_response(ResponseMessage* response);
+  int32_t maybe_compress(BufferVec* bufs, size_t index, int32_t request_size);
   void maybe_set_keyspace(ResponseMessage* response);
 
   static void on_connect(Connector* connecter);
@@ -310,6 +337,7 @@ private:
   List<PendingSchemaAgreement> pending_schema_agreements_;
 
   uv_loop_t* loop_;
+  TimerWheel* timer_wheel_;
   const Config& config_;
   Metrics* metrics_;
   Host::ConstPtr host_;
@@ -317,9 +345,17 @@ private:
   const int protocol_version_;
   Listener* listener_;
 
+  ResponseBufferPool::Ptr response_buffer_pool_;
   ScopedPtr<ResponseMessage> response_;
+  // A decoded message kept to decode the next frame instead of
+  // allocating a new one
+  ScopedPtr<ResponseMessage> free_response_;
   StreamManager<Handler*> stream_manager_;
 
+  Compressor::ConstPtr compressor_;
+  std::vector<char> compression_input_;
+  std::vector<char> compression_output_;
+
   uv_tcp_t socket_;
   Timer connect_timer_;
   ScopedPtr<SslSession> ssl_session_;
@@ -330,6 +366,11 @@ private:
 
   // buffer reuse for libuv
   std::stack<uv_buf_t> buffer_reuse_list_;
+  // The response body region handed to libuv for the current read, if any
+  char* direct_read_buffer_;
+
+  // Chunks for the write arenas of pending writes
+  WriteChunkPool write_chunk_pool_;
 
 private:
   DISALLOW_COPY_AND_ASSIGN(Connection);
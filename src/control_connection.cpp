@@ -62,9 +62,9 @@ public:
     : hosts_(hosts)
     , it_(hosts_.begin()) {}
 
-  virtual SharedRefPtr<Host> compute_next() {
-    if (it_ == hosts_.end()) return SharedRefPtr<Host>();
-    const SharedRefPtr<Host>& host = it_->second;
+  virtual Host* compute_next() {
+    if (it_ == hosts_.end()) return NULL;
+    Host* host = it_->second.get();
     ++it_;
     return host;
   }
@@ -131,7 +131,7 @@ void ControlConnection::clear() {
 
 void ControlConnection::connect(Session* session) {
   session_ = session;
-  query_plan_.reset(new ControlStartupQueryPlan(session_->hosts_)); // No hosts lock necessary (read-only)
+  query_plan_.reset(new (NULL) ControlStartupQueryPlan(session_->hosts_)); // No hosts lock necessary (read-only)
   protocol_version_ = session_->config().protocol_version();
   should_query_tokens_ = session_->config().token_aware_routing();
   if (protocol_version_ < 0) {
@@ -169,7 +169,7 @@ void ControlConnection::reconnect(bool retry_current_host) {
   }
 
   if (!retry_current_host) {
-    current_host_ = query_plan_->compute_next();
+    current_host_ = Host::Ptr(query_plan_->compute_next());
     if (!current_host_) {
       if (state_ == CONTROL_STATE_READY) {
         schedule_reconnect(1000); // TODO(mpenick): Configurable?
@@ -186,8 +186,10 @@ void ControlConnection::reconnect(bool retry_current_host) {
   }
 
   connection_ = new Connection(session_->loop(),
+                               session_->timer_wheel(),
                                session_->config(),
                                session_->metrics(),
+                               NULL, // Schema responses aren't pooled
                                current_host_,
                                "", // No keyspace
                                protocol_version_,
@@ -709,6 +711,7 @@ void ControlConnection::update_node_info(SharedRefPtr<Host> host, const Row* row
 
   if ((!rack.empty() && rack != host->rack()) ||
       (!dc.empty() && dc != host->dc())) {
+    ScopedWriteLock l(&session_->policy_rwlock_);
     if (!host->was_just_added()) {
       session_->load_balancing_policy_->on_remove(host);
     }
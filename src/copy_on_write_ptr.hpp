@@ -63,6 +63,11 @@ public:
     return ptr_->ref;
   }
 
+  // True if this is the only reference to the object
+  bool unique() const {
+    return ptr_->ref_count() == 1;
+  }
+
 private:
   void detach() {
     Referenced* temp = ptr_.get();
@@ -55,12 +55,13 @@ CassHostDistance DCAwarePolicy::distance(const SharedRefPtr<Host>& host) const {
   return CASS_HOST_DISTANCE_IGNORE;
 }
 
-QueryPlan* DCAwarePolicy::new_query_plan(const std::string& connected_keyspace,
+QueryPlan* DCAwarePolicy::new_query_plan(KeyspaceId connected_keyspace_id,
                                          const Request* request,
                                          const TokenMap& token_map,
-                                         Request::EncodingCache* cache) {
+                                         Request::EncodingCache* cache,
+                                         QueryPlanArena* arena) {
   CassConsistency cl = request != NULL ? request->consistency() : Request::DEFAULT_CONSISTENCY;
-  return new DCAwareQueryPlan(this, cl, index_++);
+  return new (arena) DCAwareQueryPlan(this, cl, index_.fetch_add(1, MEMORY_ORDER_RELAXED));
 }
 
 void DCAwarePolicy::on_add(const SharedRefPtr<Host>& host) {
@@ -146,22 +147,22 @@ DCAwarePolicy::DCAwareQueryPlan::DCAwareQueryPlan(const DCAwarePolicy* policy,
                                                   size_t start_index)
   : policy_(policy)
   , cl_(cl)
-  , hosts_(policy_->local_dc_live_hosts_)
-  , local_remaining_(get_hosts_size(hosts_))
+  , local_hosts_(policy_->local_dc_live_hosts_)
+  , local_remaining_(get_hosts_size(local_hosts_))
   , remote_remaining_(0)
   , index_(start_index) {}
 
-SharedRefPtr<Host> DCAwarePolicy::DCAwareQueryPlan::compute_next() {
+Host* DCAwarePolicy::DCAwareQueryPlan::compute_next() {
   while (local_remaining_ > 0) {
     --local_remaining_;
-    const SharedRefPtr<Host>& host(get_next_host(hosts_, index_++));
+    const SharedRefPtr<Host>& host(get_next_host(local_hosts_, index_++));
     if (host->is_up()) {
-      return host;
+      return host.get();
     }
   }
 
   if (policy_->skip_remote_dcs_for_local_cl_ && is_dc_local(cl_)) {
-    return SharedRefPtr<Host>();
+    return NULL;
   }
 
   if (!remote_dcs_) {
@@ -172,9 +173,9 @@ SharedRefPtr<Host> DCAwarePolicy::DCAwareQueryPlan::compute_next() {
   while (true) {
     while (remote_remaining_ > 0) {
       --remote_remaining_;
-      const SharedRefPtr<Host>& host(get_next_host(hosts_, index_++));
+      const SharedRefPtr<Host>& host(get_next_host(remote_hosts_.back(), index_++));
       if (host->is_up()) {
-        return host;
+        return host.get();
       }
     }
 
@@ -183,12 +184,13 @@ SharedRefPtr<Host> DCAwarePolicy::DCAwareQueryPlan::compute_next() {
     }
 
     PerDCHostMap::KeySet::iterator i = remote_dcs_->begin();
-    hosts_ = policy_->per_remote_dc_live_hosts_.get_hosts(*i);
-    remote_remaining_ = std::min(get_hosts_size(hosts_), policy_->used_hosts_per_remote_dc_);
+    remote_hosts_.push_back(policy_->per_remote_dc_live_hosts_.get_hosts(*i));
+    remote_remaining_ = std::min(get_hosts_size(remote_hosts_.back()),
+                                 policy_->used_hosts_per_remote_dc_);
     remote_dcs_->erase(i);
   }
 
-  return SharedRefPtr<Host>();
+  return NULL;
 }
 
 } // namespace cass
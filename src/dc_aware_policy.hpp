@@ -17,6 +17,7 @@
 #ifndef __CASS_DC_AWARE_POLICY_HPP_INCLUDED__
 #define __CASS_DC_AWARE_POLICY_HPP_INCLUDED__
 
+#include "atomic.hpp"
 #include "load_balancing.hpp"
 #include "host.hpp"
 #include "round_robin_policy.hpp"
@@ -25,6 +26,7 @@
 
 #include <map>
 #include <set>
+#include <vector>
 #include <uv.h>
 
 namespace cass {
@@ -50,10 +52,11 @@ public:
 
   virtual CassHostDistance distance(const SharedRefPtr<Host>& host) const;
 
-  virtual QueryPlan* new_query_plan(const std::string& connected_keyspace,
+  virtual QueryPlan* new_query_plan(KeyspaceId connected_keyspace_id,
                                     const Request* request,
                                     const TokenMap& token_map,
-                                    Request::EncodingCache* cache);
+                                    Request::EncodingCache* cache,
+                                    QueryPlanArena* arena);
 
   virtual void on_add(const SharedRefPtr<Host>& host);
 
@@ -100,12 +103,15 @@ private:
                      CassConsistency cl,
                      size_t start_index);
 
-    virtual SharedRefPtr<Host> compute_next();
+    virtual Host* compute_next();
 
   private:
     const DCAwarePolicy* policy_;
     CassConsistency cl_;
-    CopyOnWriteHostVec hosts_;
+    CopyOnWriteHostVec local_hosts_;
+    // Every remote DC's hosts that have been visited are kept so that the
+    // hosts already returned stay valid until the plan is destroyed
+    std::vector<CopyOnWriteHostVec> remote_hosts_;
     ScopedPtr<PerDCHostMap::KeySet> remote_dcs_;
     size_t local_remaining_;
     size_t remote_remaining_;
@@ -118,7 +124,7 @@ private:
 
   CopyOnWriteHostVec local_dc_live_hosts_;
   PerDCHostMap per_remote_dc_live_hosts_;
-  size_t index_;
+  Atomic<size_t> index_;
 
 private:
   DISALLOW_COPY_AND_ASSIGN(DCAwarePolicy);
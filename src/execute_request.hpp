@@ -36,6 +36,8 @@ public:
                   prepared->result()->keyspace().to_string())
       , prepared_(prepared)
       , metadata_(prepared->result()->metadata()){
+      // The prepared statement is kept alive by the request
+      share_keyspace_id_cache(&prepared->keyspace_id_cache());
       // If the prepared statement has result metadata then there is no
       // need to get the metadata with this request too.
       if (prepared->result()->result_metadata()) {
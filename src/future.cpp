@@ -72,13 +72,14 @@ const CassPrepared* cass_future_get_prepared(CassFuture* future) {
       static_cast<cass::ResponseFuture*>(future->from());
 
   cass::SharedRefPtr<cass::ResultResponse> result(response_future->response());
-  if (!result || result->kind() != CASS_RESULT_KIND_PREPARED) {
+  if (!result || result->kind() != CASS_RESULT_KIND_PREPARED ||
+      !response_future->schema_metadata) {
     return NULL;
   }
 
   cass::Prepared* prepared = new cass::Prepared(result,
                                                 response_future->statement,
-                                                response_future->schema_metadata);
+                                                *response_future->schema_metadata);
   if (prepared) prepared->inc_ref();
   return CassPrepared::to(prepared);
 }
@@ -24,7 +24,7 @@
 #include "list.hpp"
 #include "request.hpp"
 #include "scoped_ptr.hpp"
-#include "timer.hpp"
+#include "timer_wheel.hpp"
 
 #include <string>
 #include <uv.h>
@@ -86,9 +86,9 @@ public:
 
   void set_state(State next_state);
 
-  void start_timer(uv_loop_t* loop, uint64_t timeout, void* data,
-                   Timer::Callback cb) {
-    timer_.start(loop, timeout, data, cb);
+  void start_timer(TimerWheel* timer_wheel, uint64_t timeout, void* data,
+                   TimerWheel::Entry::Callback cb) {
+    timer_.start(timer_wheel, timeout, data, cb);
   }
 
   void stop_timer() {
@@ -111,6 +111,9 @@ public:
 
   uint64_t start_time_ns() const { return start_time_ns_; }
 
+  // Testing only (set when the request is encoded)
+  void set_start_time_ns(uint64_t start_time_ns) { start_time_ns_ = start_time_ns; }
+
   Request::EncodingCache* encoding_cache() { return &encoding_cache_; }
 
 protected:
@@ -118,7 +121,7 @@ protected:
   Connection* connection_;
 
 private:
-  Timer timer_;
+  TimerWheel::Entry timer_;
   int stream_;
   State state_;
   CassConsistency cl_;
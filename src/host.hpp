@@ -115,7 +115,9 @@ public:
       : address_(address)
       , mark_(mark)
       , state_(ADDED)
-      , address_string_(address.to_string()) { }
+      , address_string_(address.to_string())
+      , io_worker_index_(0)
+      , inflight_request_count_(0) { }
 
   const Address& address() const { return address_; }
   const std::string& address_string() const { return address_string_; }
@@ -123,6 +125,33 @@ public:
   bool mark() const { return mark_; }
   void set_mark(bool mark) { mark_ = mark; }
 
+  // The IO worker that owns this host's pool when IO worker affinity is
+  // enabled. It's assigned before the host is shared with other threads.
+  size_t io_worker_index() const { return io_worker_index_; }
+  void set_io_worker_index(size_t index) { io_worker_index_ = index; }
+
+  // Whether the host's pool on each IO worker is able to take new requests.
+  // It's sized before the host is shared with other threads and then only
+  // the flags change, so it's read without locking. Hosts that aren't used
+  // by IO workers are always available.
+  void init_io_worker_availability(size_t io_worker_count) {
+    io_worker_availability_.reset(new Atomic<bool>[io_worker_count]);
+    for (size_t i = 0; i < io_worker_count; ++i) {
+      io_worker_availability_[i].store(true, MEMORY_ORDER_RELAXED);
+    }
+  }
+
+  bool is_available(size_t io_worker_index) const {
+    return !io_worker_availability_ ||
+        io_worker_availability_[io_worker_index].load(MEMORY_ORDER_RELAXED);
+  }
+
+  void set_available(size_t io_worker_index, bool is_available) const {
+    if (io_worker_availability_) {
+      io_worker_availability_[io_worker_index].store(is_available, MEMORY_ORDER_RELAXED);
+    }
+  }
+
   const std::string hostname() const { return hostname_; }
   void set_hostname(const std::string& hostname) {
     if (!hostname.empty() && hostname[hostname.size() - 1] == '.') {
@@ -186,6 +215,21 @@ public:
     return TimestampedAverage();
   }
 
+  // The number of requests written to this host that are still waiting for a
+  // response, across all of its connections. It's maintained by the
+  // connections which only hold const references to their host.
+  int inflight_request_count() const {
+    return inflight_request_count_.load(MEMORY_ORDER_RELAXED);
+  }
+
+  void inc_inflight_request_count(int count = 1) const {
+    inflight_request_count_.fetch_add(count, MEMORY_ORDER_RELAXED);
+  }
+
+  void dec_inflight_request_count(int count = 1) const {
+    inflight_request_count_.fetch_sub(count, MEMORY_ORDER_RELAXED);
+  }
+
 private:
   class LatencyTracker {
   public:
@@ -222,6 +266,9 @@ private:
   bool mark_;
   Atomic<HostState> state_;
   std::string address_string_;
+  size_t io_worker_index_;
+  ScopedPtr<Atomic<bool>[]> io_worker_availability_;
+  mutable Atomic<int> inflight_request_count_;
   std::string listen_address_;
   VersionNumber cassandra_version_;
   std::string hostname_;
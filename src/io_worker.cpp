@@ -21,27 +21,34 @@
 #include "pool.hpp"
 #include "request_handler.hpp"
 #include "session.hpp"
-#include "scoped_lock.hpp"
 #include "timer.hpp"
 
+// How often an IO worker checks if its response buffers are unused
+#define RESPONSE_BUFFER_POOL_TRIM_INTERVAL_MS 10000
+
 namespace cass {
 
-IOWorker::IOWorker(Session* session)
+IOWorker::IOWorker(Session* session, size_t index)
     : state_(IO_WORKER_STATE_READY)
     , session_(session)
+    , index_(index)
     , config_(session->config())
     , metrics_(session->metrics())
+    , response_buffer_pool_(config_.response_pooling()
+                            ? new ResponseBufferPool(metrics_)
+                            : NULL)
     , protocol_version_(-1)
+    , adaptive_flush_(config_.adaptive_flush(),
+                      config_.max_requests_per_flush(),
+                      config_.adaptive_flush_max_delay_us())
     , keyspace_(new std::string)
     , pending_request_count_(0)
     , request_queue_(config_.queue_size_io()) {
   prepare_.data = this;
-  uv_mutex_init(&unavailable_addresses_mutex_);
+  idle_.data = this;
 }
 
-IOWorker::~IOWorker() {
-  uv_mutex_destroy(&unavailable_addresses_mutex_);
-}
+IOWorker::~IOWorker() { }
 
 int IOWorker::init() {
   int rc = EventThread<IOWorkerEvent>::init(config_.queue_size_event());
@@ -52,6 +59,12 @@ int IOWorker::init() {
   if (rc != 0) return rc;
   rc = uv_prepare_start(&prepare_, on_prepare);
   if (rc != 0) return rc;
+  rc = uv_idle_init(loop(), &idle_);
+  if (rc != 0) return rc;
+  if (response_buffer_pool_) {
+    trim_timer_.start(loop(), RESPONSE_BUFFER_POOL_TRIM_INTERVAL_MS, this,
+                      on_trim_response_buffer_pool);
+  }
   return rc;
 }
 
@@ -66,21 +79,23 @@ void IOWorker::broadcast_keyspace_change(const std::string& keyspace) {
 
 bool IOWorker::is_host_up(const Address& address) const {
   PoolMap::const_iterator it = pools_.find(address);
-  return it != pools_.end() && it->second->is_ready();
+  if (it != pools_.end()) {
+    return it->second->is_ready();
+  }
+  if (config_.use_io_worker_affinity()) {
+    // The host's pool is owned by another IO worker
+    SharedRefPtr<Host> host(session_->get_host(address));
+    return host && host->is_up();
+  }
+  return false;
 }
 
-void IOWorker::set_host_is_available(const Address& address, bool is_available) {
-  ScopedMutex lock(&unavailable_addresses_mutex_);
-  if (is_available) {
-    unavailable_addresses_.erase(address);
-  } else {
-    unavailable_addresses_.insert(address);
-  }
+void IOWorker::set_host_is_available(const Host* host, bool is_available) {
+  host->set_available(index_, is_available);
 }
 
-bool IOWorker::is_host_available(const Address& address) {
-  ScopedMutex lock(&unavailable_addresses_mutex_);
-  return unavailable_addresses_.count(address) == 0;
+bool IOWorker::is_host_available(const Host* host) const {
+  return host->is_available(index_);
 }
 
 bool IOWorker::add_pool_async(const Host::ConstPtr& host, bool is_initial_connection) {
@@ -116,7 +131,7 @@ void IOWorker::add_pool(const Host::ConstPtr& host, bool is_initial_connection)
               host->address_string().c_str(),
               static_cast<void*>(this));
 
-    set_host_is_available(address, false);
+    set_host_is_available(host.get(), false);
 
     SharedRefPtr<Pool> pool(new Pool(this, host, is_initial_connection));
     pools_[address] = pool;
@@ -127,6 +142,11 @@ void IOWorker::add_pool(const Host::ConstPtr& host, bool is_initial_connection)
     LOG_DEBUG("Host %s already present attempting to initiate immediate connection for io_worker(%p)",
               host->address_string().c_str(),
               static_cast<void*>(this));
+    if (it->second->host().get() != host.get()) {
+      // The host was removed and added back as a new object. Availability
+      // is tracked per host object so the pool must now update the new one.
+      it->second->set_host(host);
+    }
     it->second->connect();
   }
 }
@@ -156,12 +176,29 @@ void IOWorker::retry(RequestHandler* request_handler) {
     } else { // Too busy, or no connections
       pool->wait_for_connection(request_handler);
     }
-  } else {
+  } else if (!maybe_transfer(request_handler)) {
     request_handler->next_host();
     retry(request_handler);
   }
 }
 
+bool IOWorker::maybe_transfer(RequestHandler* request_handler) {
+  if (!config_.use_io_worker_affinity() ||
+      !request_handler->is_transferable() ||
+      session_->owner_io_worker(request_handler->current_host()) == this) {
+    return false;
+  }
+  // The transfer is deferred until the prepare callback so that nothing on
+  // the current call stack touches the request after it's been moved.
+  pending_transfers_.push_back(request_handler);
+  return true;
+}
+
+void IOWorker::execute_speculative(RequestHandler* request_handler) {
+  pending_request_count_++;
+  retry(request_handler);
+}
+
 void IOWorker::request_finished(RequestHandler* request_handler) {
   pending_request_count_--;
   maybe_close();
@@ -205,9 +242,18 @@ void IOWorker::notify_pool_closed(Pool* pool) {
 }
 
 void IOWorker::add_pending_flush(Pool* pool) {
+  if (pools_pending_flush_.empty() && adaptive_flush_.is_delay_enabled()) {
+    adaptive_flush_.start_delay(uv_hrtime());
+  }
   pools_pending_flush_.push_back(SharedRefPtr<Pool>(pool));
 }
 
+bool IOWorker::should_delay_flush() const {
+  return !is_closing() &&
+      adaptive_flush_.is_delay_enabled() &&
+      adaptive_flush_.should_delay(uv_hrtime());
+}
+
 void IOWorker::maybe_close() {
   if (is_closing() && pending_request_count_ <= 0) {
     if (config_.core_connections_per_host() > 0) {
@@ -241,6 +287,12 @@ void IOWorker::close_handles() {
   request_queue_.close_handles();
   uv_prepare_stop(&prepare_);
   uv_close(copy_cast<uv_prepare_t*, uv_handle_t*>(&prepare_), NULL);
+  uv_idle_stop(&idle_);
+  uv_close(copy_cast<uv_idle_t*, uv_handle_t*>(&idle_), NULL);
+  trim_timer_.stop();
+  if (response_buffer_pool_) {
+    response_buffer_pool_->trim();
+  }
 }
 
 void IOWorker::on_event(const IOWorkerEvent& event) {
@@ -278,11 +330,12 @@ void IOWorker::on_execute(uv_async_t* async) {
   IOWorker* io_worker = static_cast<IOWorker*>(async->data);
 
   RequestHandler* request_handler = NULL;
-  size_t remaining = io_worker->config().max_requests_per_flush();
+  size_t remaining = io_worker->adaptive_flush_.batch_size();
   while (remaining != 0 && io_worker->request_queue_.dequeue(request_handler)) {
     if (request_handler != NULL) {
       io_worker->pending_request_count_++;
       request_handler->set_io_worker(io_worker);
+      request_handler->schedule_next_execution();
       request_handler->retry();
     } else {
       io_worker->state_ = IO_WORKER_STATE_CLOSING;
@@ -290,6 +343,14 @@ void IOWorker::on_execute(uv_async_t* async) {
     remaining--;
   }
 
+  if (remaining == 0) {
+    // The queue might not be empty so the loop needs to wake itself up to
+    // process the rest of the requests.
+    io_worker->request_queue_.send();
+  }
+
+  io_worker->adaptive_flush_.update(remaining == 0);
+
   io_worker->maybe_close();
 }
 
@@ -300,11 +361,47 @@ void IOWorker::on_prepare(uv_prepare_t* prepare) {
 #endif
   IOWorker* io_worker = static_cast<IOWorker*>(prepare->data);
 
-  for (PoolVec::iterator it = io_worker->pools_pending_flush_.begin(),
-       end = io_worker->pools_pending_flush_.end(); it != end; ++it) {
-    (*it)->flush();
+  if (io_worker->should_delay_flush()) {
+    // Poll without blocking so that the flush happens within the delay
+    uv_idle_start(&io_worker->idle_, on_idle);
+  } else {
+    for (PoolVec::iterator it = io_worker->pools_pending_flush_.begin(),
+         end = io_worker->pools_pending_flush_.end(); it != end; ++it) {
+      (*it)->flush();
+    }
+    io_worker->pools_pending_flush_.clear();
+    uv_idle_stop(&io_worker->idle_);
+  }
+
+  if (!io_worker->pending_transfers_.empty()) {
+    RequestHandlerVec transfers;
+    transfers.swap(io_worker->pending_transfers_);
+    for (RequestHandlerVec::iterator it = transfers.begin(),
+         end = transfers.end(); it != end; ++it) {
+      RequestHandler* request_handler = *it;
+      request_handler->cancel_next_execution();
+      if (io_worker->session_->transfer(request_handler)) {
+        io_worker->pending_request_count_--;
+      } else {
+        request_handler->on_error(CASS_ERROR_LIB_REQUEST_QUEUE_FULL,
+                                  "Unable to move the request to the I/O "
+                                  "thread that owns the host");
+      }
+    }
+    io_worker->maybe_close();
+  }
+}
+
+void IOWorker::on_trim_response_buffer_pool(Timer* timer) {
+  IOWorker* io_worker = static_cast<IOWorker*>(timer->data());
+  size_t freed = io_worker->response_buffer_pool_->trim_if_idle();
+  if (freed > 0) {
+    LOG_DEBUG("Freed %u bytes of unused response buffers on io_worker(%p)",
+              static_cast<unsigned>(freed),
+              static_cast<void*>(io_worker));
   }
-  io_worker->pools_pending_flush_.clear();
+  timer->start(io_worker->loop(), RESPONSE_BUFFER_POOL_TRIM_INTERVAL_MS,
+               io_worker, on_trim_response_buffer_pool);
 }
 
 void IOWorker::schedule_reconnect(const Host::ConstPtr& host) {
@@ -17,6 +17,7 @@
 #ifndef __CASS_IO_WORKER_HPP_INCLUDED__
 #define __CASS_IO_WORKER_HPP_INCLUDED__
 
+#include "adaptive_flush.hpp"
 #include "address.hpp"
 #include "atomic.hpp"
 #include "async_queue.hpp"
@@ -26,7 +27,8 @@
 #include "host.hpp"
 #include "logger.hpp"
 #include "metrics.hpp"
-#include "spsc_queue.hpp"
+#include "mpmc_queue.hpp"
+#include "response_buffer_pool.hpp"
 #include "timer.hpp"
 
 #include <map>
@@ -70,7 +72,7 @@ public:
     IO_WORKER_STATE_CLOSED
   };
 
-  IOWorker(Session* session);
+  IOWorker(Session* session, size_t index);
   ~IOWorker();
 
   int init();
@@ -81,6 +83,13 @@ public:
   const Config& config() const { return config_; }
   Metrics* metrics() const { return metrics_; }
 
+  ResponseBufferPool* response_buffer_pool() const {
+    return response_buffer_pool_.get();
+  }
+
+  // The position of this IO worker in the session's IO workers
+  size_t index() const { return index_; }
+
   int protocol_version() const {
     return protocol_version_.load();
   }
@@ -92,8 +101,8 @@ public:
   void set_keyspace(const std::string& keyspace);
   void broadcast_keyspace_change(const std::string& keyspace);
 
-  void set_host_is_available(const Address& address, bool is_available);
-  bool is_host_available(const Address& address);
+  void set_host_is_available(const Host* host, bool is_available);
+  bool is_host_available(const Host* host) const;
 
   bool is_host_up(const Address& address) const;
 
@@ -104,6 +113,7 @@ public:
   bool execute(RequestHandler* request_handler);
 
   void retry(RequestHandler* request_handler);
+  void execute_speculative(RequestHandler* request_handler);
   void request_finished(RequestHandler* request_handler);
 
   void notify_pool_ready(Pool* pool);
@@ -113,47 +123,62 @@ public:
 
 private:
   void add_pool(const Host::ConstPtr& host, bool is_initial_connection);
+  bool maybe_transfer(RequestHandler* request_handler);
   void maybe_close();
   void maybe_notify_closed();
   void close_handles();
 
   static void on_pending_pool_reconnect(Timer* timer);
+  static void on_trim_response_buffer_pool(Timer* timer);
 
   virtual void on_event(const IOWorkerEvent& event);
 
 #if UV_VERSION_MAJOR == 0
   static void on_execute(uv_async_t* async, int status);
   static void on_prepare(uv_prepare_t *prepare, int status);
+  static void on_idle(uv_idle_t* idle, int status) { }
 #else
   static void on_execute(uv_async_t* async);
   static void on_prepare(uv_prepare_t *prepare);
+  static void on_idle(uv_idle_t* idle) { }
 #endif
 
+  bool should_delay_flush() const;
+
 private:
   typedef std::map<Address, SharedRefPtr<Pool> > PoolMap;
   typedef std::vector<SharedRefPtr<Pool> > PoolVec;
+  typedef std::vector<RequestHandler*> RequestHandlerVec;
 
   void schedule_reconnect(const Host::ConstPtr& host);
 
 private:
   State state_;
   Session* session_;
+  size_t index_;
   const Config& config_;
   Metrics* metrics_;
+  ResponseBufferPool::Ptr response_buffer_pool_;
+  Timer trim_timer_;
   Atomic<int> protocol_version_;
   uv_prepare_t prepare_;
 
-  CopyOnWritePtr<std::string> keyspace_;
+  AdaptiveFlush adaptive_flush_;
+  // Keeps the event loop from blocking while a flush is delayed
+  uv_idle_t idle_;
 
-  AddressSet unavailable_addresses_;
-  uv_mutex_t unavailable_addresses_mutex_;
+  CopyOnWritePtr<std::string> keyspace_;
 
   PoolMap pools_;
   PoolVec pools_pending_flush_;
+  RequestHandlerVec pending_transfers_;
   bool is_closing_;
   int pending_request_count_;
 
-  AsyncQueue<SPSCQueue<RequestHandler*> > request_queue_;
+  // Multiple producers: the session thread or, when direct dispatch is
+  // enabled, any application thread calling Session::execute(). Other IO
+  // workers also transfer requests when IO worker affinity is enabled.
+  AsyncQueue<MPMCQueue<RequestHandler*> > request_queue_;
 };
 
 } // namespace cass
@@ -0,0 +1,31 @@
+/*
+  Copyright (c) 2014-2016 DataStax
+
+  Licensed under the Apache License, Version 2.0 (the "License");
+  you may not use this file except in compliance with the License.
+  You may obtain a copy of the License at
+
+  http://www.apache.org/licenses/LICENSE-2.0
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+*/
+
+#include "keyspace_id.hpp"
+
+namespace cass {
+
+static Atomic<uint32_t> last_keyspace_ids_generation(0);
+
+uint32_t KeyspaceIds::next_generation() {
+  uint32_t generation;
+  do {
+    generation = last_keyspace_ids_generation.fetch_add(1, MEMORY_ORDER_RELAXED) + 1;
+  } while (generation == 0); // Reserved for empty caches
+  return generation;
+}
+
+} // namespace cass
@@ -0,0 +1,108 @@
+/*
+  Copyright (c) 2014-2016 DataStax
+
+  Licensed under the Apache License, Version 2.0 (the "License");
+  you may not use this file except in compliance with the License.
+  You may obtain a copy of the License at
+
+  http://www.apache.org/licenses/LICENSE-2.0
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+*/
+
+#ifndef __CASS_KEYSPACE_ID_HPP_INCLUDED__
+#define __CASS_KEYSPACE_ID_HPP_INCLUDED__
+
+#include "atomic.hpp"
+
+#include <map>
+#include <stdint.h>
+#include <string>
+
+namespace cass {
+
+// Keyspace names are interned into small integer ids so that per-request
+// routing indexes the token map's replicas instead of comparing strings. Each
+// token map owns its ids: they're only assigned while the map is updated on
+// the session thread and are shared, copy-on-write, with its read-only
+// snapshots so lookups by name never add an id or take a lock.
+typedef int KeyspaceId;
+
+static const KeyspaceId INVALID_KEYSPACE_ID = -1;
+
+class KeyspaceIds {
+public:
+  KeyspaceIds()
+    : generation_(next_generation()) { }
+
+  // Returns INVALID_KEYSPACE_ID for an empty name
+  KeyspaceId intern(const std::string& name) {
+    if (name.empty()) return INVALID_KEYSPACE_ID;
+    Map::iterator i = ids_.find(name);
+    if (i != ids_.end()) return i->second;
+    KeyspaceId id = static_cast<KeyspaceId>(ids_.size());
+    ids_.insert(Map::value_type(name, id));
+    generation_ = next_generation();
+    return id;
+  }
+
+  // Returns INVALID_KEYSPACE_ID if the name hasn't been interned
+  KeyspaceId find(const std::string& name) const {
+    Map::const_iterator i = ids_.find(name);
+    return i != ids_.end() ? i->second : INVALID_KEYSPACE_ID;
+  }
+
+  // Changes whenever an id is added. Generations are unique to the process
+  // so ids cached from a different set of ids are never mistaken as current.
+  uint32_t generation() const { return generation_; }
+
+private:
+  static uint32_t next_generation();
+
+private:
+  typedef std::map<std::string, KeyspaceId> Map;
+  Map ids_;
+  uint32_t generation_;
+};
+
+// The id of a single keyspace name, cached with the generation of the ids it
+// was found in so the name is only looked up again when the ids change. The
+// id and generation are stored together so the cache can be shared by the
+// threads executing a request without a lock.
+class KeyspaceIdCache {
+public:
+  KeyspaceIdCache()
+    : value_(0) { }
+
+  KeyspaceIdCache(const KeyspaceIdCache& other)
+    : value_(other.value_.load(MEMORY_ORDER_RELAXED)) { }
+
+  bool get(uint32_t generation, KeyspaceId* id) const {
+    uint64_t value = value_.load(MEMORY_ORDER_RELAXED);
+    if (static_cast<uint32_t>(value >> 32) != generation) return false;
+    *id = static_cast<KeyspaceId>(static_cast<int32_t>(value & 0xFFFFFFFF));
+    return true;
+  }
+
+  void set(uint32_t generation, KeyspaceId id) const {
+    value_.store((static_cast<uint64_t>(generation) << 32) | static_cast<uint32_t>(id),
+                 MEMORY_ORDER_RELAXED);
+  }
+
+  // Generation 0 is never used
+  void reset() { value_.store(0, MEMORY_ORDER_RELAXED); }
+
+private:
+  KeyspaceIdCache& operator=(const KeyspaceIdCache&);
+
+private:
+  mutable Atomic<uint64_t> value_;
+};
+
+} // namespace cass
+
+#endif
@@ -44,13 +44,14 @@ void LatencyAwarePolicy::close_handles() {
   }
 }
 
-QueryPlan* LatencyAwarePolicy::new_query_plan(const std::string& connected_keyspace,
+QueryPlan* LatencyAwarePolicy::new_query_plan(KeyspaceId connected_keyspace_id,
                                               const Request* request,
                                               const TokenMap& token_map,
-                                              Request::EncodingCache* cache) {
-  return new LatencyAwareQueryPlan(this,
-                                   child_policy_->new_query_plan(connected_keyspace, request,
-                                                                 token_map, cache));
+                                              Request::EncodingCache* cache,
+                                              QueryPlanArena* arena) {
+  return new (arena) LatencyAwareQueryPlan(this,
+                                           child_policy_->new_query_plan(connected_keyspace_id, request,
+                                                                         token_map, cache, arena));
 }
 
 void LatencyAwarePolicy::on_add(const SharedRefPtr<Host>& host) {
@@ -74,13 +75,13 @@ void LatencyAwarePolicy::on_down(const SharedRefPtr<Host>& host) {
   ChainedLoadBalancingPolicy::on_down(host);
 }
 
-SharedRefPtr<Host> LatencyAwarePolicy::LatencyAwareQueryPlan::compute_next() {
+Host* LatencyAwarePolicy::LatencyAwareQueryPlan::compute_next() {
   int64_t min = policy_->min_average_.load();
   const Settings& settings = policy_->settings_;
   uint64_t now = uv_hrtime();
 
-  SharedRefPtr<Host> host;
-  while ((host = child_plan_->compute_next())) {
+  Host* host;
+  while ((host = child_plan_->compute_next()) != NULL) {
     TimestampedAverage latency = host->get_current_average();
 
     if (min < 0 ||
@@ -101,7 +102,7 @@ SharedRefPtr<Host> LatencyAwarePolicy::LatencyAwareQueryPlan::compute_next() {
     return skipped_[skipped_index_++];
   }
 
-  return SharedRefPtr<Host>();
+  return NULL;
 }
 
 void LatencyAwarePolicy::on_work(PeriodicTask* task) {
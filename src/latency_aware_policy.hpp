@@ -18,11 +18,14 @@
 #define __CASS_LATENCY_AWARE_POLICY_HPP_INCLUDED__
 
 #include "atomic.hpp"
+#include "fixed_vector.hpp"
 #include "load_balancing.hpp"
 #include "macros.hpp"
 #include "periodic_task.hpp"
 #include "scoped_ptr.hpp"
 
+#include <vector>
+
 namespace cass {
 
 class LatencyAwarePolicy : public ChainedLoadBalancingPolicy {
@@ -56,10 +59,11 @@ public:
   virtual void register_handles(uv_loop_t* loop);
   virtual void close_handles();
 
-  virtual QueryPlan* new_query_plan(const std::string& connected_keyspace,
+  virtual QueryPlan* new_query_plan(KeyspaceId connected_keyspace_id,
                                     const Request* request,
                                     const TokenMap& token_map,
-                                    Request::EncodingCache* cache);
+                                    Request::EncodingCache* cache,
+                                    QueryPlanArena* arena);
 
   virtual LoadBalancingPolicy* new_instance() {
     return new LatencyAwarePolicy(child_policy_->new_instance(), settings_);
@@ -84,13 +88,15 @@ private:
       , child_plan_(child_plan)
       , skipped_index_(0) {}
 
-    SharedRefPtr<Host> compute_next();
+    Host* compute_next();
 
   private:
     LatencyAwarePolicy* policy_;
     ScopedPtr<QueryPlan> child_plan_;
 
-    HostVec skipped_;
+    // Kept alive by the child plan. Stored inline unless many hosts are
+    // skipped.
+    FixedVector<Host*, 8> skipped_;
     size_t skipped_index_;
   };
 
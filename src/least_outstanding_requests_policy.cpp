@@ -0,0 +1,62 @@
+/*
+  Copyright (c) 2014-2016 DataStax
+
+  Licensed under the Apache License, Version 2.0 (the "License");
+  you may not use this file except in compliance with the License.
+  You may obtain a copy of the License at
+
+  http://www.apache.org/licenses/LICENSE-2.0
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+*/
+
+#include "least_outstanding_requests_policy.hpp"
+
+namespace cass {
+
+QueryPlan* LeastOutstandingRequestsPolicy::new_query_plan(KeyspaceId connected_keyspace_id,
+                                                          const Request* request,
+                                                          const TokenMap& token_map,
+                                                          Request::EncodingCache* cache,
+                                                          QueryPlanArena* arena) {
+  return new (arena) LeastOutstandingRequestsQueryPlan(
+        child_policy_->new_query_plan(connected_keyspace_id, request,
+                                      token_map, cache, arena));
+}
+
+Host* LeastOutstandingRequestsPolicy::LeastOutstandingRequestsQueryPlan::compute_next() {
+  if (is_first_) {
+    is_first_ = false;
+
+    Host* first = child_plan_->compute_next();
+    if (first == NULL) return NULL;
+
+    Host* second = child_plan_->compute_next();
+    // Only hosts the child treats the same are swapped. A token-aware plan
+    // returns its replicas first, so with a single replica left the second
+    // host is a non-replica and the replica keeps its place. Ties keep the
+    // child's order so its rotation still spreads the load.
+    if (second != NULL &&
+        child_plan_->is_replica(first) == child_plan_->is_replica(second) &&
+        second->inflight_request_count() < first->inflight_request_count()) {
+      next_ = first;
+      return second;
+    }
+    next_ = second;
+    return first;
+  }
+
+  if (next_ != NULL) {
+    Host* host = next_;
+    next_ = NULL;
+    return host;
+  }
+
+  return child_plan_->compute_next();
+}
+
+} // namespace cass
@@ -0,0 +1,75 @@
+/*
+  Copyright (c) 2014-2016 DataStax
+
+  Licensed under the Apache License, Version 2.0 (the "License");
+  you may not use this file except in compliance with the License.
+  You may obtain a copy of the License at
+
+  http://www.apache.org/licenses/LICENSE-2.0
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+*/
+
+#ifndef __CASS_LEAST_OUTSTANDING_REQUESTS_POLICY_HPP_INCLUDED__
+#define __CASS_LEAST_OUTSTANDING_REQUESTS_POLICY_HPP_INCLUDED__
+
+#include "load_balancing.hpp"
+#include "macros.hpp"
+#include "scoped_ptr.hpp"
+
+namespace cass {
+
+// Uses the power of two choices: of the first two hosts returned by the child
+// policy (two replicas when token-aware) the one with the fewest in-flight
+// requests is tried first. A replica is never swapped with a non-replica.
+// The rest of the child's plan is unchanged.
+class LeastOutstandingRequestsPolicy : public ChainedLoadBalancingPolicy {
+public:
+  LeastOutstandingRequestsPolicy(LoadBalancingPolicy* child_policy)
+    : ChainedLoadBalancingPolicy(child_policy) {}
+
+  virtual ~LeastOutstandingRequestsPolicy() {}
+
+  virtual QueryPlan* new_query_plan(KeyspaceId connected_keyspace_id,
+                                    const Request* request,
+                                    const TokenMap& token_map,
+                                    Request::EncodingCache* cache,
+                                    QueryPlanArena* arena);
+
+  virtual LoadBalancingPolicy* new_instance() {
+    return new LeastOutstandingRequestsPolicy(child_policy_->new_instance());
+  }
+
+private:
+  class LeastOutstandingRequestsQueryPlan : public QueryPlan {
+  public:
+    LeastOutstandingRequestsQueryPlan(QueryPlan* child_plan)
+      : child_plan_(child_plan)
+      , is_first_(true)
+      , next_(NULL) {}
+
+    Host* compute_next();
+
+    bool is_replica(const Host* host) const {
+      return child_plan_->is_replica(host);
+    }
+
+  private:
+    ScopedPtr<QueryPlan> child_plan_;
+    bool is_first_;
+
+    // The host that lost the first choice. It's kept alive by the child plan.
+    Host* next_;
+  };
+
+private:
+  DISALLOW_COPY_AND_ASSIGN(LeastOutstandingRequestsPolicy);
+};
+
+} // namespace cass
+
+#endif
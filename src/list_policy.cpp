@@ -40,14 +40,16 @@ CassHostDistance ListPolicy::distance(const SharedRefPtr<Host>& host) const {
   return CASS_HOST_DISTANCE_IGNORE;
 }
 
-QueryPlan* ListPolicy::new_query_plan(const std::string& connected_keyspace,
+QueryPlan* ListPolicy::new_query_plan(KeyspaceId connected_keyspace_id,
                                            const Request* request,
                                            const TokenMap& token_map,
-                                           Request::EncodingCache* cache) {
-  return child_policy_->new_query_plan(connected_keyspace,
+                                           Request::EncodingCache* cache,
+                                           QueryPlanArena* arena) {
+  return child_policy_->new_query_plan(connected_keyspace_id,
                                        request,
                                        token_map,
-                                       cache);
+                                       cache,
+                                       arena);
 }
 
 void ListPolicy::on_add(const SharedRefPtr<Host>& host) {
@@ -34,10 +34,11 @@ public:
 
   virtual CassHostDistance distance(const SharedRefPtr<Host>& host) const;
 
-  virtual QueryPlan* new_query_plan(const std::string& connected_keyspace,
+  virtual QueryPlan* new_query_plan(KeyspaceId connected_keyspace_id,
                                     const Request* request,
                                     const TokenMap& token_map,
-                                    Request::EncodingCache* cache);
+                                    Request::EncodingCache* cache,
+                                    QueryPlanArena* arena);
 
   virtual void on_add(const SharedRefPtr<Host>& host);
   virtual void on_remove(const SharedRefPtr<Host>& host);
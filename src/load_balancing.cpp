@@ -0,0 +1,71 @@
+/*
+  Copyright (c) 2014-2016 DataStax
+
+  Licensed under the Apache License, Version 2.0 (the "License");
+  you may not use this file except in compliance with the License.
+  You may obtain a copy of the License at
+
+  http://www.apache.org/licenses/LICENSE-2.0
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+*/
+
+#include "load_balancing.hpp"
+
+namespace cass {
+
+// Each plan is prefixed with where it was allocated so it can be freed
+// without knowing its arena
+union QueryPlanBlockHeader {
+  bool is_heap;
+  void* align_ptr;
+  int64_t align_int;
+  double align_double;
+};
+
+void* QueryPlanArena::allocate(size_t size) {
+  // Keep every block aligned like the header
+  const size_t alignment = sizeof(QueryPlanBlockHeader);
+  size = (size + alignment - 1) / alignment * alignment;
+  if (size > CAPACITY - size_) {
+    heap_allocations_++;
+    return NULL;
+  }
+  void* ptr = data_ + size_;
+  size_ += size;
+  return ptr;
+}
+
+void* QueryPlan::operator new(size_t size, QueryPlanArena* arena) {
+  size_t block_size = sizeof(QueryPlanBlockHeader) + size;
+  QueryPlanBlockHeader* header = NULL;
+  if (arena != NULL) {
+    header = static_cast<QueryPlanBlockHeader*>(arena->allocate(block_size));
+  }
+  if (header != NULL) {
+    header->is_heap = false;
+  } else {
+    header = static_cast<QueryPlanBlockHeader*>(::operator new(block_size));
+    header->is_heap = true;
+  }
+  return header + 1;
+}
+
+void QueryPlan::operator delete(void* ptr, QueryPlanArena* arena) {
+  QueryPlan::operator delete(ptr);
+}
+
+void QueryPlan::operator delete(void* ptr) {
+  if (ptr == NULL) return;
+  QueryPlanBlockHeader* header = static_cast<QueryPlanBlockHeader*>(ptr) - 1;
+  // Arena blocks are released with their arena
+  if (header->is_heap) {
+    ::operator delete(header);
+  }
+}
+
+} // namespace cass
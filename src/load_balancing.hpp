@@ -20,6 +20,7 @@
 #include "cassandra.h"
 #include "constants.hpp"
 #include "host.hpp"
+#include "macros.hpp"
 #include "request.hpp"
 
 #include <list>
@@ -58,19 +59,69 @@ inline bool is_dc_local(CassConsistency cl) {
   return cl == CASS_CONSISTENCY_LOCAL_ONE || cl == CASS_CONSISTENCY_LOCAL_QUORUM;
 }
 
+// Storage for the chain of query plans built for a single request. It's kept
+// inline in the request handler so building a query plan doesn't allocate.
+// Plans that don't fit are allocated on the heap.
+class QueryPlanArena {
+public:
+  QueryPlanArena()
+    : size_(0)
+    , heap_allocations_(0) { }
+
+  // Returns NULL if there isn't enough space left, the caller then allocates
+  // on the heap
+  void* allocate(size_t size);
+
+  // The number of bytes used and the number of allocations that didn't fit
+  size_t size() const { return size_; }
+  size_t heap_allocations() const { return heap_allocations_; }
+
+private:
+  // Fits the longest chain the config can build (latency-aware, least
+  // outstanding requests, token-aware and DC-aware plans), about 340 bytes
+  // on 64-bit platforms, with room for larger standard library types
+  static const size_t CAPACITY = 512;
+
+  union {
+    char data_[CAPACITY];
+    void* align_ptr_;
+    int64_t align_int_;
+    double align_double_;
+  };
+  size_t size_;
+  size_t heap_allocations_;
+
+private:
+  DISALLOW_COPY_AND_ASSIGN(QueryPlanArena);
+};
+
 class QueryPlan {
 public:
   virtual ~QueryPlan() {}
-  virtual SharedRefPtr<Host> compute_next() = 0;
+
+  // Returns NULL once the plan is exhausted. The plan holds references to all
+  // of its hosts so they're returned without touching their reference counts
+  // and remain valid until the plan is destroyed.
+  virtual Host* compute_next() = 0;
 
   bool compute_next(Address* address) {
-    SharedRefPtr<Host> host = compute_next();
-    if (host) {
+    Host* host = compute_next();
+    if (host != NULL) {
       *address = host->address();
       return true;
     }
     return false;
   }
+
+  // Whether "host" is a local replica of the request's partition key. Only
+  // token-aware plans know the replicas; other plans return false.
+  virtual bool is_replica(const Host* host) const { return false; }
+
+  // Plans are allocated from "arena" if there's space left, otherwise on the
+  // heap. A NULL arena always uses the heap.
+  static void* operator new(size_t size, QueryPlanArena* arena);
+  static void operator delete(void* ptr, QueryPlanArena* arena);
+  static void operator delete(void* ptr);
 };
 
 class LoadBalancingPolicy : public Host::StateListener, public RefCounted<LoadBalancingPolicy> {
@@ -87,10 +138,13 @@ public:
 
   virtual CassHostDistance distance(const SharedRefPtr<Host>& host) const = 0;
 
-  virtual QueryPlan* new_query_plan(const std::string& connected_keyspace,
+  // "connected_keyspace_id" is the id of the session's keyspace in
+  // "token_map"
+  virtual QueryPlan* new_query_plan(KeyspaceId connected_keyspace_id,
                                     const Request* request,
                                     const TokenMap& token_map,
-                                    Request::EncodingCache* cache) = 0;
+                                    Request::EncodingCache* cache,
+                                    QueryPlanArena* arena) = 0;
 
   virtual LoadBalancingPolicy* new_instance() = 0;
 };
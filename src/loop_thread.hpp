@@ -18,6 +18,7 @@
 #define __CASS_LOOP_THREAD_HPP_INCLUDED__
 
 #include "macros.hpp"
+#include "timer_wheel.hpp"
 
 #include <assert.h>
 #include <uv.h>
@@ -57,10 +58,12 @@ public:
     if (rc != 0) return rc;
     rc = uv_signal_start(&sigpipe_, on_signal, SIGPIPE);
 #endif
+    timer_wheel_.init(loop());
     return rc;
   }
 
   void close_handles() {
+    timer_wheel_.close_handles();
 #if !defined(_WIN32)
     uv_signal_stop(&sigpipe_);
     uv_close(copy_cast<uv_signal_t*, uv_handle_t*>(&sigpipe_), NULL);
@@ -73,6 +76,9 @@ public:
   uv_loop_t* loop() { return &loop_; }
 #endif
 
+  // Shared by all request timeouts on this thread
+  TimerWheel* timer_wheel() { return &timer_wheel_; }
+
   int run() {
     int rc = uv_thread_create(&thread_, on_run_internal, this);
     if (rc == 0) is_joinable_ = true;
@@ -115,6 +121,7 @@ private:
 
   uv_thread_t thread_;
   bool is_joinable_;
+  TimerWheel timer_wheel_;
 
 #if !defined(_WIN32)
   uv_signal_t sigpipe_;
@@ -809,6 +809,9 @@ void Metadata::update_keyspaces(ResultResponse* result) {
   for (KeyspaceMetadata::Map::const_iterator i = updates.begin(); i != updates.end(); ++i) {
     token_map_.update_keyspace(i->first, i->second);
   }
+  if (!updates.empty() && token_map_.is_built()) {
+    publish_token_map();
+  }
 }
 
 void Metadata::update_tables(ResultResponse* result) {
@@ -956,6 +959,7 @@ void Metadata::clear_and_update_back() {
     config_.native_types.init_class_names();
   }
   token_map_.clear();
+  publish_token_map();
   back_.clear();
   updating_ = &back_;
 }
@@ -978,6 +982,22 @@ void Metadata::clear() {
   }
   back_.clear();
   token_map_.clear();
+  publish_token_map();
+}
+
+void Metadata::publish_token_map() {
+  TokenMap::ConstPtr snapshot(token_map_.snapshot());
+  token_map_replica_set_count_.store(token_map_.replica_set_count(), MEMORY_ORDER_RELAXED);
+  token_map_memory_size_.store(token_map_.memory_size(), MEMORY_ORDER_RELAXED);
+
+  // The previous snapshot is released after the lock so that freeing it
+  // doesn't block readers
+  TokenMap::ConstPtr previous;
+  {
+    ScopedWriteLock l(&token_map_rwlock_);
+    previous = token_map_snapshot_;
+    token_map_snapshot_ = snapshot;
+  }
 }
 
 const Value* MetadataBase::get_field(const std::string& name) const {
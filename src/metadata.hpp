@@ -17,6 +17,7 @@
 #ifndef __CASS_SCHEMA_METADATA_HPP_INCLUDED__
 #define __CASS_SCHEMA_METADATA_HPP_INCLUDED__
 
+#include "atomic.hpp"
 #include "copy_on_write_ptr.hpp"
 #include "iterator.hpp"
 #include "macros.hpp"
@@ -628,12 +629,17 @@ public:
 public:
   Metadata()
     : updating_(&front_)
-    , schema_snapshot_version_(0) {
+    , schema_snapshot_version_(0)
+    , token_map_snapshot_(new TokenMap())
+    , token_map_replica_set_count_(0)
+    , token_map_memory_size_(0) {
     uv_mutex_init(&mutex_);
+    uv_rwlock_init(&token_map_rwlock_);
   }
 
   ~Metadata() {
     uv_mutex_destroy(&mutex_);
+    uv_rwlock_destroy(&token_map_rwlock_);
   }
 
   SchemaSnapshot schema_snapshot() const;
@@ -672,16 +678,42 @@ public:
     config_.cassandra_version = cassandra_version;
   }
 
-  void set_partitioner(const std::string& partitioner_class) { token_map_.set_partitioner(partitioner_class); }
-  void update_host(SharedRefPtr<Host>& host, const TokenStringList& tokens) { token_map_.update_host(host, tokens); }
-  void build() { token_map_.build(); }
-  void remove_host(SharedRefPtr<Host>& host) { token_map_.remove_host(host); }
+  void set_partitioner(const std::string& partitioner_class) {
+    token_map_.set_partitioner(partitioner_class);
+  }
+  void update_host(SharedRefPtr<Host>& host, const TokenStringList& tokens) {
+    token_map_.update_host(host, tokens);
+    if (token_map_.is_built()) publish_token_map();
+  }
+  void build() {
+    token_map_.build();
+    publish_token_map();
+  }
+  void remove_host(SharedRefPtr<Host>& host) {
+    token_map_.remove_host(host);
+    if (token_map_.is_built()) publish_token_map();
+  }
 
-  const TokenMap& token_map() const { return token_map_; }
+  // The token map is only updated on the session thread. Other threads use
+  // the most recently published snapshot, which isn't affected by updates.
+  TokenMap::ConstPtr token_map() const {
+    ScopedReadLock l(&token_map_rwlock_);
+    return token_map_snapshot_;
+  }
+
+  // Recorded when a snapshot is published so metrics never touch the map
+  size_t token_map_replica_set_count() const {
+    return token_map_replica_set_count_.load(MEMORY_ORDER_RELAXED);
+  }
+  size_t token_map_memory_size() const {
+    return token_map_memory_size_.load(MEMORY_ORDER_RELAXED);
+  }
 
 private:
   bool is_front_buffer() const { return updating_ == &front_; }
 
+  void publish_token_map();
+
 private:
   class InternalData {
   public:
@@ -733,10 +765,15 @@ private:
   // This lock prevents partial snapshots when updating metadata
   mutable uv_mutex_t mutex_;
 
-  // Only used internally on a single thread so it doesn't currently use
-  // copy-on-write. When this is exposed externally it needs to be
-  // moved into the InternalData class and made to use copy-on-write.
+  // Only updated on the session thread. Query plans can be built on other
+  // threads (direct dispatch) so a snapshot is published after each update.
+  // The lock is only held to swap the snapshot, never while the map is
+  // being rebuilt.
   TokenMap token_map_;
+  TokenMap::ConstPtr token_map_snapshot_;
+  Atomic<size_t> token_map_replica_set_count_;
+  Atomic<size_t> token_map_memory_size_;
+  mutable uv_rwlock_t token_map_rwlock_;
 
   // Only used internally on a single thread, there's
   // no need for copy-on-write.
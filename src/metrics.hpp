@@ -105,6 +105,10 @@ public:
       counters_[thread_state_->current_thread_id()].sub(1LL);
     }
 
+    void add(int64_t n) {
+      counters_[thread_state_->current_thread_id()].add(n);
+    }
+
     int64_t sum() const {
       int64_t sum = 0;
       for (size_t i = 0; i < thread_state_->max_threads(); ++i) {
@@ -285,11 +289,13 @@ public:
       : thread_state_(thread_state)
       , histograms_(new PerThreadHistogram[thread_state->max_threads()]) {
       hdr_init(1LL, HIGHEST_TRACKABLE_VALUE, 3, &histogram_);
+      hdr_init(1LL, HIGHEST_TRACKABLE_VALUE, 3, &interval_histogram_);
       uv_mutex_init(&mutex_);
     }
 
     ~Histogram() {
       free(histogram_);
+      free(interval_histogram_);
       uv_mutex_destroy(&mutex_);
     }
 
@@ -301,12 +307,12 @@ public:
       histograms_[thread_state_->current_thread_id()].record_value(value);
     }
 
+    // Values are recorded into per-thread histograms and only merged into a
+    // shared histogram here so recording never takes a lock (libuv 1.x).
     void get_snapshot(Snapshot* snapshot) const {
       ScopedMutex l(&mutex_);
+      merge();
       hdr_histogram* h = histogram_;
-      for (size_t i = 0; i < thread_state_->max_threads(); ++i) {
-        histograms_[i].add(h);
-      }
       snapshot->min = hdr_min(h);
       snapshot->max = hdr_max(h);
       snapshot->mean = static_cast<int64_t>(hdr_mean(h));
@@ -319,6 +325,20 @@ public:
       snapshot->percentile_999th = hdr_value_at_percentile(h, 99.9);
     }
 
+    // Returns a percentile of the values recorded since the last time this
+    // returned a value so that it follows the current latencies instead of
+    // the whole history of the session. Returns 0, and keeps accumulating
+    // values, if fewer than "min_count" values have been recorded.
+    int64_t interval_value_at_percentile(double percentile, int64_t min_count) const {
+      ScopedMutex l(&mutex_);
+      merge();
+      hdr_histogram* h = interval_histogram_;
+      if (h->total_count < min_count) return 0;
+      int64_t value = hdr_value_at_percentile(h, percentile);
+      hdr_reset(h);
+      return value;
+    }
+
   private:
 #if UV_VERSION_MAJOR == 0
     class PerThreadHistogram {
@@ -336,8 +356,10 @@ public:
 
       }
 
-      void add(hdr_histogram* to) {
+      void add(hdr_histogram* to, hdr_histogram* interval) {
         hdr_add(to, histogram_);
+        hdr_add(interval, histogram_);
+        hdr_reset(histogram_);
       }
 
     private:
@@ -422,23 +444,42 @@ public:
         phaser_.writer_critical_section_end(critical_value_enter);
       }
 
-      void add(hdr_histogram* to) {
+      // Moves the values recorded since the last call into "to" and
+      // "interval". Writers keep recording into the other histogram so they
+      // never wait on this.
+      void add(hdr_histogram* to, hdr_histogram* interval) {
         int inactive_index = active_index_.exchange(!active_index_.load());
         hdr_histogram* from = histograms_[inactive_index];
         phaser_.flip_phase();
         hdr_add(to, from);
+        hdr_add(interval, from);
+        hdr_reset(from);
       }
 
     private:
       hdr_histogram* histograms_[2];
       Atomic<int> active_index_;
       WriterReaderPhaser phaser_;
+
+      // Each IO thread updates its own phaser on every recorded value so
+      // keep adjacent per-thread histograms on separate cache lines.
+      static const size_t cacheline_size = 64;
+      char pad__[cacheline_size];
+      void no_unused_private_warning__() { pad__[0] = 0; }
     };
 #endif
 
+    // Must be called with the mutex held
+    void merge() const {
+      for (size_t i = 0; i < thread_state_->max_threads(); ++i) {
+        histograms_[i].add(histogram_, interval_histogram_);
+      }
+    }
+
     ThreadState* thread_state_;
     ScopedPtr<PerThreadHistogram[]> histograms_;
     hdr_histogram* histogram_;
+    hdr_histogram* interval_histogram_;
     mutable uv_mutex_t mutex_;
 
   private:
@@ -468,7 +509,21 @@ public:
     , exceeded_write_bytes_water_mark(&thread_state_)
     , connection_timeouts(&thread_state_)
     , pending_request_timeouts(&thread_state_)
-    , request_timeouts(&thread_state_) {}
+    , request_timeouts(&thread_state_)
+    , uncompressed_bytes_sent(&thread_state_)
+    , compressed_bytes_sent(&thread_state_)
+    , uncompressed_bytes_received(&thread_state_)
+    , compressed_bytes_received(&thread_state_)
+    , speculative_executions(&thread_state_)
+    , speculative_wins(&thread_state_)
+    , bytes_written(&thread_state_)
+    , bytes_written_sync(&thread_state_)
+    , flush_batch_requests(&thread_state_)
+    , flush_batch_bytes(&thread_state_)
+    , response_buffer_pool_hits(&thread_state_)
+    , response_buffer_pool_misses(&thread_state_)
+    , response_message_pool_hits(&thread_state_)
+    , response_message_pool_misses(&thread_state_) {}
 
   void record_request(uint64_t latency_ns) {
     // Final measurement is in microseconds
@@ -476,6 +531,11 @@ public:
     request_rates.mark();
   }
 
+  void record_flush(size_t num_requests, size_t num_bytes) {
+    flush_batch_requests.record_value(static_cast<int64_t>(num_requests));
+    flush_batch_bytes.record_value(static_cast<int64_t>(num_bytes));
+  }
+
 private:
   ThreadState thread_state_;
 
@@ -492,6 +552,25 @@ public:
   Counter pending_request_timeouts;
   Counter request_timeouts;
 
+  Counter uncompressed_bytes_sent;
+  Counter compressed_bytes_sent;
+  Counter uncompressed_bytes_received;
+  Counter compressed_bytes_received;
+
+  Counter speculative_executions;
+  Counter speculative_wins;
+
+  Counter bytes_written;
+  Counter bytes_written_sync;
+
+  Histogram flush_batch_requests;
+  Histogram flush_batch_bytes;
+
+  Counter response_buffer_pool_hits;
+  Counter response_buffer_pool_misses;
+  Counter response_message_pool_hits;
+  Counter response_message_pool_misses;
+
 private:
   DISALLOW_COPY_AND_ASSIGN(Metrics);
 };
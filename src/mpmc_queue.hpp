@@ -131,12 +131,6 @@ public:
     return (intptr_t)node_seq - (intptr_t)(pos + 1) < 0;
   }
 
-  static void memory_fence() {
-#if defined(CASS_USE_BOOST_ATOMIC) || defined(CASS_USE_STD_ATOMIC)
-    atomic_thread_fence(MEMORY_ORDER_SEQ_CST);
-#endif
-  }
-
 private:
   struct Node {
     Atomic<size_t> seq;
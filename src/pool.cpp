@@ -186,17 +186,32 @@ void Pool::set_is_available(bool is_available) {
     if (!is_available_ &&
         available_connection_count_ > 0 &&
         pending_requests_.size() < config_.pending_requests_low_water_mark()) {
-      io_worker_->set_host_is_available(host_->address(), true);
+      io_worker_->set_host_is_available(host_.get(), true);
       is_available_ = true;
     }
   } else {
     if (is_available_) {
-      io_worker_->set_host_is_available(host_->address(), false);
+      io_worker_->set_host_is_available(host_.get(), false);
       is_available_ = false;
     }
   }
 }
 
+void Pool::set_host(const Host::ConstPtr& host) {
+  host_ = host;
+  // Keep counting the outstanding requests of the reused connections on
+  // the host object the load balancing policies see
+  for (ConnectionVec::iterator it = connections_.begin(),
+       end = connections_.end(); it != end; ++it) {
+    (*it)->set_host(host);
+  }
+  for (ConnectionSet::iterator it = connections_pending_.begin(),
+       end = connections_pending_.end(); it != end; ++it) {
+    (*it)->set_host(host);
+  }
+  io_worker_->set_host_is_available(host_.get(), is_available_);
+}
+
 bool Pool::write(Connection* connection, RequestHandler* request_handler) {
   request_handler->set_pool(this);
   if (*io_worker_->keyspace() == connection->keyspace()) {
@@ -213,6 +228,12 @@ bool Pool::write(Connection* connection, RequestHandler* request_handler) {
       return false;
     }
   }
+  if (config_.adaptive_flush() &&
+      connection->unflushed_size() >= config_.adaptive_flush_bytes()) {
+    // Large batches are flushed right away instead of waiting for the
+    // IO worker to flush the pool
+    connection->flush();
+  }
   if (!is_pending_flush_) {
     io_worker_->add_pending_flush(this);
   }
@@ -255,7 +276,8 @@ void Pool::maybe_close() {
 void Pool::spawn_connection() {
   if (state_ != POOL_STATE_CLOSING && state_ != POOL_STATE_CLOSED) {
     Connection* connection =
-        new Connection(loop_, config_, metrics_,
+        new Connection(loop_, io_worker_->timer_wheel(), config_, metrics_,
+                       io_worker_->response_buffer_pool(),
                        host_,
                        *io_worker_->keyspace(),
                        io_worker_->protocol_version(),
@@ -376,7 +398,7 @@ void Pool::on_availability_change(Connection* connection) {
   }
 }
 
-void Pool::on_pending_request_timeout(Timer* timer) {
+void Pool::on_pending_request_timeout(TimerWheel::Entry* timer) {
   RequestHandler* request_handler = static_cast<RequestHandler*>(timer->data());
   Pool* pool = request_handler->pool();
   pool->metrics_->pending_request_timeouts.inc();
@@ -391,7 +413,7 @@ void Pool::on_pending_request_timeout(Timer* timer) {
 
 void Pool::wait_for_connection(RequestHandler* request_handler) {
   request_handler->set_pool(this);
-  request_handler->start_timer(loop_,
+  request_handler->start_timer(io_worker_->timer_wheel(),
                                config_.connect_timeout_ms(),
                                request_handler,
                                Pool::on_pending_request_timeout);
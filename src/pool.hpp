@@ -26,6 +26,7 @@
 #include "request_handler.hpp"
 #include "scoped_ptr.hpp"
 #include "timer.hpp"
+#include "timer_wheel.hpp"
 
 #include <algorithm>
 #include <functional>
@@ -67,6 +68,11 @@ public:
 
   const Host::ConstPtr& host() const { return host_; }
 
+  // Used when a host is removed and then added back while its pool is still
+  // around. The pool's availability is copied to the new host and all
+  // future updates go to it.
+  void set_host(const Host::ConstPtr& host);
+
   bool is_initial_connection() const { return is_initial_connection_; }
   bool is_ready() const { return state_ == POOL_STATE_READY; }
   bool is_keyspace_error() const {
@@ -99,7 +105,7 @@ private:
   virtual void on_availability_change(Connection* connection);
   virtual void on_event(EventResponse* response) {}
 
-  static void on_pending_request_timeout(Timer* timer);
+  static void on_pending_request_timeout(TimerWheel::Entry* timer);
   static void on_partial_reconnect(Timer* timer);
   static void on_wait_to_connect(Timer* timer);
 
@@ -17,6 +17,7 @@
 #ifndef __CASS_PREPARED_HPP_INCLUDED__
 #define __CASS_PREPARED_HPP_INCLUDED__
 
+#include "keyspace_id.hpp"
 #include "ref_counted.hpp"
 #include "result_response.hpp"
 #include "metadata.hpp"
@@ -37,11 +38,15 @@ public:
   const std::string& statement() const { return statement_; }
   const ResultResponse::PKIndexVec& key_indices() const { return key_indices_; }
 
+  // Shared by the statements bound from this one
+  const KeyspaceIdCache& keyspace_id_cache() const { return keyspace_id_cache_; }
+
 private:
   SharedRefPtr<const ResultResponse> result_;
   std::string id_;
   std::string statement_;
   ResultResponse::PKIndexVec key_indices_;
+  KeyspaceIdCache keyspace_id_cache_;
 };
 
 } // namespace cass
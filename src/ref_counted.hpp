@@ -58,6 +58,14 @@ private:
 
 class RefBuffer : public RefCounted<RefBuffer> {
 public:
+  // A source of buffer memory that takes it back when a buffer's last
+  // reference is released. That can happen on any thread.
+  class Pool {
+  public:
+    virtual ~Pool() {}
+    virtual void release(void* memory, size_t capacity) = 0;
+  };
+
   static RefBuffer* create(size_t size) {
 #if defined(_WIN32)
 #pragma warning(push)
@@ -69,19 +77,57 @@ public:
 #endif
   }
 
+  // Constructs a buffer in "memory" which must be at least
+  // block_size(capacity) bytes. The memory is given back to "pool" when
+  // the buffer is destroyed.
+  static RefBuffer* create(Pool* pool, void* memory, size_t capacity) {
+#if defined(_WIN32)
+#pragma warning(push)
+#pragma warning(disable: 4291) //Invalid warning thrown RefBuffer has a delete function
+#endif
+    return new (pool, memory, capacity) RefBuffer();
+#if defined(_WIN32)
+#pragma warning(pop)
+#endif
+  }
+
+  static size_t block_size(size_t capacity) {
+    return sizeof(Header) + sizeof(RefBuffer) + capacity;
+  }
+
   char* data() {
     return reinterpret_cast<char*>(this) + sizeof(RefBuffer);
   }
 
   void operator delete(void* ptr) {
-    ::operator delete(ptr);
+    Header* header = static_cast<Header*>(ptr) - 1;
+    if (header->pool != NULL) {
+      header->pool->release(header, header->capacity);
+    } else {
+      ::operator delete(header);
+    }
   }
 
 private:
+  struct Header {
+    Pool* pool;
+    size_t capacity;
+  };
+
   RefBuffer() {}
 
   void* operator new(size_t size, size_t extra) {
-    return ::operator new(size + extra);
+    Header* header = static_cast<Header*>(::operator new(sizeof(Header) + size + extra));
+    header->pool = NULL;
+    header->capacity = extra;
+    return header + 1;
+  }
+
+  void* operator new(size_t size, Pool* pool, void* memory, size_t capacity) {
+    Header* header = static_cast<Header*>(memory);
+    header->pool = pool;
+    header->capacity = capacity;
+    return header + 1;
   }
 
   DISALLOW_COPY_AND_ASSIGN(RefBuffer);
@@ -22,6 +22,9 @@
 #include "token_map.hpp"
 #include "utils.hpp"
 
+#include <uv.h>
+
+#include <algorithm>
 #include <map>
 #include <set>
 
@@ -78,17 +81,7 @@ SharedRefPtr<ReplicationStrategy> ReplicationStrategy::from_keyspace_meta(const
   }
 }
 
-const std::string NetworkTopologyStrategy::STRATEGY_CLASS("NetworkTopologyStrategy");
-
-bool NetworkTopologyStrategy::equal(const KeyspaceMetadata& ks_meta) {
-  if (ks_meta.strategy_class() != strategy_class_) return false;
-  DCReplicaCountMap temp_rfs;
-  build_dc_replicas(ks_meta, &temp_rfs);
-  return replication_factors_ == temp_rfs;
-}
-
-typedef std::map<std::string, std::set<std::string> > DCRackMap;
-static DCRackMap racks_in_dcs(const TokenHostMap& token_hosts) {
+DCRackMap racks_in_dcs(const TokenHostMap& token_hosts) {
   DCRackMap racks;
   for (TokenHostMap::const_iterator i = token_hosts.begin();
        i != token_hosts.end(); ++i) {
@@ -101,67 +94,355 @@ static DCRackMap racks_in_dcs(const TokenHostMap& token_hosts) {
   return racks;
 }
 
-void NetworkTopologyStrategy::tokens_to_replicas(const TokenHostMap& primary, TokenReplicaMap* output) const {
-  DCRackMap racks = racks_in_dcs(primary);
+bool ReplicaSetPool::HostVecLess::operator()(const HostVec* lhs, const HostVec* rhs) const {
+  if (lhs->size() != rhs->size()) return lhs->size() < rhs->size();
+  for (HostVec::const_iterator i = lhs->begin(), j = rhs->begin();
+       i != lhs->end(); ++i, ++j) {
+    if (i->get() != j->get()) return i->get() < j->get();
+  }
+  return false;
+}
+
+CopyOnWriteHostVec ReplicaSetPool::intern(const CopyOnWriteHostVec& replicas) {
+  const HostVec* key = &(*replicas);
+  Map::iterator i = replica_sets_.find(key);
+  if (i != replica_sets_.end()) {
+    return i->second;
+  }
+  replica_sets_.insert(std::make_pair(key, replicas));
+  return replicas;
+}
 
-  output->clear();
+void ReplicaSetPool::purge() {
+  Map::iterator i = replica_sets_.begin();
+  while (i != replica_sets_.end()) {
+    if (i->second.unique()) {
+      replica_sets_.erase(i++);
+    } else {
+      ++i;
+    }
+  }
+}
+
+size_t ReplicaSetPool::memory_size() const {
+  // Map nodes are estimated as three pointers and a color
+  size_t size = replica_sets_.size() * (4 * sizeof(void*) + sizeof(Map::value_type));
+  for (Map::const_iterator i = replica_sets_.begin(),
+       end = replica_sets_.end(); i != end; ++i) {
+    size += sizeof(HostVec) + i->first->capacity() * sizeof(HostVec::value_type);
+  }
+  return size;
+}
+
+// Rings with fewer tokens per thread than this are built on the calling thread
+static const size_t MIN_TOKENS_PER_BUILD_THREAD = 16384;
+static const size_t MAX_BUILD_THREADS = 16;
+
+static uv_once_t cpu_count_init_guard = UV_ONCE_INIT;
+static size_t cpu_count = 1;
+
+static void init_cpu_count() {
+  uv_cpu_info_t* cpu_infos;
+  int count;
+  if (uv_cpu_info(&cpu_infos, &count) == 0) {
+    uv_free_cpu_info(cpu_infos, count);
+    if (count > 0) cpu_count = static_cast<size_t>(count);
+  }
+}
+
+static size_t build_thread_count(size_t ring_size) {
+  size_t count = ring_size / MIN_TOKENS_PER_BUILD_THREAD;
+  if (count <= 1) return 1;
+
+  // uv_cpu_info() reads /proc/cpuinfo on Linux so it's only called once
+  uv_once(&cpu_count_init_guard, init_cpu_count);
+
+  return std::min(count, std::min(cpu_count, MAX_BUILD_THREADS));
+}
 
+HostRing::HostRing(const TokenHostMap& primary, const DCRackMap& racks) {
+  // Hosts own many tokens so their ids are only resolved once
+  std::map<const Host*, std::pair<int, int> > host_ids;
+
+  entries_.reserve(primary.size());
   for (TokenHostMap::const_iterator i = primary.begin(); i != primary.end(); ++i) {
-    DCReplicaCountMap replica_counts;
-    std::map<std::string, std::set<std::string> > racks_observed;
-    std::map<std::string, std::list<SharedRefPtr<Host> > > skipped_endpoints;
+    Host* host = i->second.get();
+    std::map<const Host*, std::pair<int, int> >::iterator ids_it = host_ids.find(host);
+    if (ids_it == host_ids.end()) {
+      int dc = -1;
+      int rack = -1;
+      if (!host->dc().empty()) {
+        DCRackMap::const_iterator racks_it = racks.find(host->dc());
+        std::map<std::string, int>::iterator dc_it = dc_ids_.find(host->dc());
+        if (dc_it == dc_ids_.end()) {
+          dc_it = dc_ids_.insert(std::make_pair(host->dc(),
+                                                static_cast<int>(rack_counts_.size()))).first;
+          rack_counts_.push_back(racks_it != racks.end() ? racks_it->second.size() : 0);
+        }
+        dc = dc_it->second;
 
-    CopyOnWriteHostVec replicas(new HostVec());
-    TokenHostMap::const_iterator j = i;
-    for (size_t count = 0; count < primary.size() && replica_counts != replication_factors_; ++count) {
-      const SharedRefPtr<Host>& host = j->second;
-      const std::string& dc = host->dc();
-
-      ++j;
-      if (j == primary.end()) {
-        j = primary.begin();
+        if (!host->rack().empty() && racks_it != racks.end()) {
+          std::set<std::string>::const_iterator rack_it = racks_it->second.find(host->rack());
+          if (rack_it != racks_it->second.end()) {
+            rack = static_cast<int>(std::distance(racks_it->second.begin(), rack_it));
+          }
+        }
       }
+      ids_it = host_ids.insert(std::make_pair(host, std::make_pair(dc, rack))).first;
+    }
 
-      DCReplicaCountMap::const_iterator rf_it =  replication_factors_.find(dc);
-      if (dc.empty() || rf_it == replication_factors_.end()) {
-        continue;
-      }
+    Entry entry = { &i->first, host, ids_it->second.first, ids_it->second.second };
+    entries_.push_back(entry);
+  }
+}
+
+int HostRing::dc_id(const std::string& dc) const {
+  std::map<std::string, int>::const_iterator i = dc_ids_.find(dc);
+  return i != dc_ids_.end() ? i->second : -1;
+}
+
+struct ReplicationStrategy::BuildReplicasRange {
+  BuildReplicasRange()
+    : strategy(NULL)
+    , ring(NULL)
+    , begin(0)
+    , end(0)
+    , is_thread_started(false) { }
+
+  const ReplicationStrategy* strategy;
+  const HostRing* ring;
+  size_t begin;
+  size_t end;
+  std::vector<CopyOnWriteHostVec> replicas;
+  uv_thread_t thread;
+  bool is_thread_started;
+};
+
+void ReplicationStrategy::on_build_replicas(void* arg) {
+  BuildReplicasRange* range = static_cast<BuildReplicasRange*>(arg);
+  range->replicas.reserve(range->end - range->begin);
+  for (size_t i = range->begin; i < range->end; ++i) {
+    CopyOnWriteHostVec replicas(new HostVec());
+    range->strategy->build_replicas(*range->ring, i, &(*replicas));
+    range->replicas.push_back(replicas);
+  }
+}
+
+void ReplicationStrategy::tokens_to_replicas(const TokenHostMap& primary, TokenReplicaMap* output,
+                                             ReplicaSetPool* pool, size_t num_threads) const {
+  DCRackMap racks;
+  if (is_rack_aware()) {
+    racks = racks_in_dcs(primary);
+  }
+  tokens_to_replicas(HostRing(primary, racks), output, pool, num_threads);
+}
+
+void ReplicationStrategy::tokens_to_replicas(const HostRing& ring, TokenReplicaMap* output,
+                                             ReplicaSetPool* pool, size_t num_threads) const {
+  // Each range of the ring is walked on its own thread, the first range is
+  // walked on the calling thread. Building the map and interning the replica
+  // sets isn't thread-safe so that's done afterwards.
+  if (num_threads == 0) {
+    num_threads = build_thread_count(ring.size());
+  }
+  num_threads = std::max(static_cast<size_t>(1), std::min(num_threads, ring.size()));
+  std::vector<BuildReplicasRange> ranges(num_threads);
+  for (size_t i = 0; i < num_threads; ++i) {
+    BuildReplicasRange& range = ranges[i];
+    range.strategy = this;
+    range.ring = &ring;
+    range.begin = ring.size() * i / num_threads;
+    range.end = ring.size() * (i + 1) / num_threads;
+  }
+
+  for (size_t i = 1; i < num_threads; ++i) {
+    ranges[i].is_thread_started =
+        uv_thread_create(&ranges[i].thread, on_build_replicas, &ranges[i]) == 0;
+  }
+
+  for (size_t i = 0; i < num_threads; ++i) {
+    if (ranges[i].is_thread_started) {
+      uv_thread_join(&ranges[i].thread);
+    } else {
+      on_build_replicas(&ranges[i]);
+    }
+  }
+
+  output->clear();
+
+  HostRing::Iterator entry = ring.begin();
+  for (std::vector<BuildReplicasRange>::iterator i = ranges.begin(); i != ranges.end(); ++i) {
+    for (std::vector<CopyOnWriteHostVec>::const_iterator j = i->replicas.begin(),
+         end = i->replicas.end(); j != end; ++j, ++entry) {
+      output->insert(output->end(),
+                     std::make_pair(*entry->token, pool != NULL ? pool->intern(*j) : *j));
+    }
+  }
+}
+
+static bool entry_token_less(const HostRing::Entry& lhs, const Token& rhs) {
+  return *lhs.token < rhs;
+}
+
+void ReplicationStrategy::update_replicas(const HostRing& ring,
+                                          const TokenVec& added,
+                                          const TokenVec& removed,
+                                          TokenReplicaMap* output,
+                                          ReplicaSetPool* pool) const {
+  for (TokenVec::const_iterator i = removed.begin(); i != removed.end(); ++i) {
+    output->erase(*i);
+  }
+
+  if (ring.size() == 0) {
+    output->clear();
+    return;
+  }
+
+  // The walk length of the tokens already recomputed by this update
+  std::map<size_t, size_t> walked;
+
+  // A changed token is "reached" by a walk that visits an added token or, for
+  // a removed token, the token that now follows it
+  TokenVec changed(added);
+  changed.insert(changed.end(), removed.begin(), removed.end());
+
+  for (size_t c = 0; c < changed.size(); ++c) {
+    bool is_added = c < added.size();
+
+    size_t target = std::lower_bound(ring.begin(), ring.end(),
+                                     changed[c], entry_token_less) - ring.begin();
+    if (target == ring.size()) {
+      target = 0;
+    }
+
+    size_t i = target;
+    size_t distance = 0;
+    if (!is_added) {
+      i = (i == 0 ? ring.size() : i) - 1;
+      distance = 1;
+    }
 
-      const size_t rf = rf_it->second;
-      size_t& replica_count_this_dc = replica_counts[dc];
-      if (replica_count_this_dc >= rf) {
-        continue;
+    for (size_t visited = 0; visited < ring.size(); ++visited, ++distance) {
+      size_t count;
+      std::map<size_t, size_t>::iterator walked_it = walked.find(i);
+      if (walked_it != walked.end()) {
+        count = walked_it->second;
+      } else {
+        CopyOnWriteHostVec replicas(new HostVec());
+        count = build_replicas(ring, i, &(*replicas));
+        if (pool != NULL) {
+          replicas = pool->intern(replicas);
+        }
+        walked[i] = count;
+        std::pair<TokenReplicaMap::iterator, bool> result
+            = output->insert(std::make_pair(*ring[i].token, replicas));
+        if (!result.second) {
+          result.first->second = replicas;
+        }
       }
 
-      const size_t rack_count_this_dc = racks[dc].size();
-      std::set<std::string>& racks_observed_this_dc = racks_observed[dc];
-      const std::string& rack = host->rack();
+      if (count <= distance) break;
 
-      if (rack.empty() || racks_observed_this_dc.size() == rack_count_this_dc) {
-        ++replica_count_this_dc;
-        replicas->push_back(host);
+      i = (i == 0 ? ring.size() : i) - 1;
+    }
+  }
+}
+
+const std::string NetworkTopologyStrategy::STRATEGY_CLASS("NetworkTopologyStrategy");
+
+bool NetworkTopologyStrategy::equal(const KeyspaceMetadata& ks_meta) {
+  if (ks_meta.strategy_class() != strategy_class_) return false;
+  DCReplicaCountMap temp_rfs;
+  build_dc_replicas(ks_meta, &temp_rfs);
+  return replication_factors_ == temp_rfs;
+}
+
+bool NetworkTopologyStrategy::equal(const ReplicationStrategy& other) const {
+  return other.type() == type_ &&
+      static_cast<const NetworkTopologyStrategy&>(other).replication_factors_ == replication_factors_;
+}
+
+size_t NetworkTopologyStrategy::build_replicas(const HostRing& ring,
+                                               size_t start,
+                                               HostVec* replicas) const {
+  // The state of each DC indexed by its id in "ring"
+  struct DCState {
+    DCState()
+      : replication_factor(0)
+      , replica_count(0)
+      , skipped_index(0) { }
+    size_t replication_factor;
+    size_t replica_count;
+    std::vector<int> racks_observed;
+    HostVec skipped_endpoints;
+    size_t skipped_index;
+  };
+  std::vector<DCState> dcs(ring.dc_count());
+
+  // A DC without any hosts is never satisfied so the whole ring is walked
+  size_t dcs_remaining = 0;
+  for (DCReplicaCountMap::const_iterator i = replication_factors_.begin(),
+       end = replication_factors_.end(); i != end; ++i) {
+    if (i->second == 0) continue;
+    ++dcs_remaining;
+    int dc = ring.dc_id(i->first);
+    if (dc >= 0) {
+      dcs[dc].replication_factor = i->second;
+    }
+  }
+
+  size_t j = start;
+  size_t count = 0;
+  for (; count < ring.size() && dcs_remaining > 0; ++count) {
+    const HostRing::Entry& entry = ring[j];
+
+    if (++j == ring.size()) {
+      j = 0;
+    }
+
+    if (entry.dc < 0) {
+      continue;
+    }
+
+    DCState& dc_state = dcs[entry.dc];
+    const size_t rf = dc_state.replication_factor;
+    size_t& replica_count_this_dc = dc_state.replica_count;
+    if (replica_count_this_dc >= rf) {
+      continue;
+    }
+
+    const size_t rack_count_this_dc = ring.rack_count(entry.dc);
+    std::vector<int>& racks_observed_this_dc = dc_state.racks_observed;
+
+    if (entry.rack < 0 || racks_observed_this_dc.size() == rack_count_this_dc) {
+      ++replica_count_this_dc;
+      replicas->push_back(SharedRefPtr<Host>(entry.host));
+    } else {
+      if (std::find(racks_observed_this_dc.begin(), racks_observed_this_dc.end(),
+                    entry.rack) != racks_observed_this_dc.end()) {
+        dc_state.skipped_endpoints.push_back(SharedRefPtr<Host>(entry.host));
       } else {
-        if (racks_observed_this_dc.count(rack) > 0) {
-          skipped_endpoints[dc].push_back(host);
-        } else {
-          ++replica_count_this_dc;
-          replicas->push_back(host);
-          racks_observed_this_dc.insert(rack);
-
-          if (racks_observed_this_dc.size() == rack_count_this_dc) {
-            std::list<SharedRefPtr<Host> >& skipped_endpoints_this_dc = skipped_endpoints[dc];
-            while (!skipped_endpoints_this_dc.empty() && replica_count_this_dc < rf) {
-              ++replica_count_this_dc;
-              replicas->push_back(skipped_endpoints_this_dc.front());
-              skipped_endpoints_this_dc.pop_front();
-            }
+        ++replica_count_this_dc;
+        replicas->push_back(SharedRefPtr<Host>(entry.host));
+        racks_observed_this_dc.push_back(entry.rack);
+
+        if (racks_observed_this_dc.size() == rack_count_this_dc) {
+          HostVec& skipped_endpoints_this_dc = dc_state.skipped_endpoints;
+          while (dc_state.skipped_index < skipped_endpoints_this_dc.size() &&
+                 replica_count_this_dc < rf) {
+            ++replica_count_this_dc;
+            replicas->push_back(skipped_endpoints_this_dc[dc_state.skipped_index++]);
           }
         }
       }
     }
 
-    output->insert(std::make_pair(i->first, replicas));
+    if (replica_count_this_dc == rf) {
+      --dcs_remaining;
+    }
   }
+
+  return count;
 }
 
 const std::string SimpleStrategy::STRATEGY_CLASS("SimpleStrategy");
@@ -171,33 +452,38 @@ bool SimpleStrategy::equal(const KeyspaceMetadata& ks_meta) {
   return replication_factor_ == get_replication_factor(ks_meta);
 }
 
-void SimpleStrategy::tokens_to_replicas(const TokenHostMap& primary, TokenReplicaMap* output) const {
-  size_t target_replicas = std::min<size_t>(replication_factor_, primary.size());
-  output->clear();
-  for (TokenHostMap::const_iterator i = primary.begin(); i != primary.end(); ++i) {
-    CopyOnWriteHostVec token_replicas(new HostVec());
-    TokenHostMap::const_iterator j = i;
-    do {
-      token_replicas->push_back(j->second);
-      ++j;
-      if (j == primary.end()) {
-        j = primary.begin();
-      }
-    } while (token_replicas->size() < target_replicas);
-    output->insert(std::make_pair(i->first, token_replicas));
-  }
+bool SimpleStrategy::equal(const ReplicationStrategy& other) const {
+  return other.type() == type_ &&
+      static_cast<const SimpleStrategy&>(other).replication_factor_ == replication_factor_;
+}
+
+size_t SimpleStrategy::build_replicas(const HostRing& ring,
+                                      size_t start,
+                                      HostVec* replicas) const {
+  size_t target_replicas = std::min<size_t>(replication_factor_, ring.size());
+  size_t j = start;
+  do {
+    replicas->push_back(SharedRefPtr<Host>(ring[j].host));
+    if (++j == ring.size()) {
+      j = 0;
+    }
+  } while (replicas->size() < target_replicas);
+  return replicas->size();
 }
 
 bool NonReplicatedStrategy::equal(const KeyspaceMetadata& ks_meta) {
   return ks_meta.strategy_class() == strategy_class_;
 }
 
-void NonReplicatedStrategy::tokens_to_replicas(const TokenHostMap& primary, TokenReplicaMap* output) const {
-  output->clear();
-  for (TokenHostMap::const_iterator i = primary.begin(); i != primary.end(); ++i) {
-    CopyOnWriteHostVec token_replicas(new HostVec(1, i->second));
-    output->insert(std::make_pair(i->first, token_replicas));
-  }
+bool NonReplicatedStrategy::equal(const ReplicationStrategy& other) const {
+  return other.type() == type_;
+}
+
+size_t NonReplicatedStrategy::build_replicas(const HostRing& ring,
+                                             size_t start,
+                                             HostVec* replicas) const {
+  replicas->push_back(SharedRefPtr<Host>(ring[start].host));
+  return 1;
 }
 
 }
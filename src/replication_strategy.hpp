@@ -22,6 +22,9 @@
 #include "ref_counted.hpp"
 
 #include <map>
+#include <set>
+#include <string>
+#include <vector>
 
 namespace cass {
 
@@ -31,19 +34,131 @@ class Value;
 typedef std::vector<uint8_t> Token;
 typedef std::map<Token, SharedRefPtr<Host> > TokenHostMap;
 typedef std::map<Token, CopyOnWriteHostVec> TokenReplicaMap;
+typedef std::vector<Token> TokenVec;
+
+typedef std::map<std::string, std::set<std::string> > DCRackMap;
+DCRackMap racks_in_dcs(const TokenHostMap& token_hosts);
+
+// The hosts of a TokenHostMap in token order with their DC and rack resolved
+// to small integer ids. Walking a contiguous array and comparing ids is much
+// faster than following the map's nodes and comparing names.
+class HostRing {
+public:
+  struct Entry {
+    const Token* token;
+    Host* host;
+    int dc;   // -1 if the host has no DC
+    int rack; // -1 if the host has no rack, otherwise unique within the DC
+  };
+
+  typedef std::vector<Entry>::const_iterator Iterator;
+
+  HostRing(const TokenHostMap& primary, const DCRackMap& racks);
+
+  Iterator begin() const { return entries_.begin(); }
+  Iterator end() const { return entries_.end(); }
+
+  size_t size() const { return entries_.size(); }
+  const Entry& operator[](size_t index) const { return entries_[index]; }
+
+  // Returns -1 if no host is in the DC
+  int dc_id(const std::string& dc) const;
+  size_t dc_count() const { return rack_counts_.size(); }
+  // The number of racks in "racks" for the DC
+  size_t rack_count(int dc) const { return rack_counts_[dc]; }
+
+private:
+  std::vector<Entry> entries_;
+  std::map<std::string, int> dc_ids_;
+  std::vector<size_t> rack_counts_;
+};
+
+// Interns replica sets so that tokens with the same replicas share a single
+// HostVec. With vnodes there are far fewer distinct replica sets than tokens.
+// The shared sets must not be modified.
+class ReplicaSetPool {
+public:
+  CopyOnWriteHostVec intern(const CopyOnWriteHostVec& replicas);
+
+  // Removes the sets no longer referenced outside of the pool
+  void purge();
+  void clear() { replica_sets_.clear(); }
+
+  size_t size() const { return replica_sets_.size(); }
+
+  // An estimate of the memory used by the pool and its sets
+  size_t memory_size() const;
+
+private:
+  struct HostVecLess {
+    bool operator()(const HostVec* lhs, const HostVec* rhs) const;
+  };
+
+  // The key points at the value's HostVec
+  typedef std::map<const HostVec*, CopyOnWriteHostVec, HostVecLess> Map;
+  Map replica_sets_;
+};
 
 class ReplicationStrategy : public RefCounted<ReplicationStrategy> {
 public:
+  enum Type {
+    NETWORK_TOPOLOGY_STRATEGY,
+    SIMPLE_STRATEGY,
+    NON_REPLICATED_STRATEGY
+  };
+
   static SharedRefPtr<ReplicationStrategy> from_keyspace_meta(const KeyspaceMetadata& ks_meta);
 
-  ReplicationStrategy(const std::string& strategy_class)
-    : strategy_class_(strategy_class) { }
+  ReplicationStrategy(Type type, const std::string& strategy_class)
+    : type_(type)
+    , strategy_class_(strategy_class) { }
 
   virtual ~ReplicationStrategy() { }
   virtual bool equal(const KeyspaceMetadata& ks_meta) = 0;
-  virtual void tokens_to_replicas(const TokenHostMap& primary, TokenReplicaMap* output) const = 0;
+
+  // True if both strategies place replicas the same way so keyspaces using
+  // them can share their replicas
+  virtual bool equal(const ReplicationStrategy& other) const = 0;
+
+  Type type() const { return type_; }
+
+  // Replica placement depends on the racks in each DC ("racks_in_dcs()") so
+  // all of the replicas need to be recomputed when they change
+  virtual bool is_rack_aware() const { return false; }
+
+  // If "pool" is provided the replica sets are interned in it. Large rings are
+  // split across threads, "num_threads" forces the number of threads (zero
+  // picks it from the ring's size and the number of CPUs).
+  void tokens_to_replicas(const TokenHostMap& primary, TokenReplicaMap* output,
+                          ReplicaSetPool* pool = NULL, size_t num_threads = 0) const;
+  void tokens_to_replicas(const HostRing& ring, TokenReplicaMap* output,
+                          ReplicaSetPool* pool = NULL, size_t num_threads = 0) const;
+
+  // Updates "output" after "added" and "removed" tokens were applied to the
+  // primary map "ring" was built from. Only the tokens whose walk around the
+  // ring reaches a changed token are recomputed. A walk never ends after the
+  // walk of the token that follows it so the affected tokens are found by
+  // walking backwards from each changed token until a walk no longer reaches
+  // it. The racks "ring" was built with must be unchanged by the update.
+  void update_replicas(const HostRing& ring,
+                       const TokenVec& added,
+                       const TokenVec& removed,
+                       TokenReplicaMap* output,
+                       ReplicaSetPool* pool = NULL) const;
+
+protected:
+  // Computes the replicas for the token at "start" and returns the number of
+  // tokens (starting with "start") the walk around the ring visited
+  virtual size_t build_replicas(const HostRing& ring,
+                                size_t start,
+                                HostVec* replicas) const = 0;
+
+private:
+  struct BuildReplicasRange;
+  static void on_build_replicas(void* arg);
 
 protected:
+  const Type type_;
   std::string strategy_class_;
 };
 
@@ -56,13 +171,19 @@ public:
 
   NetworkTopologyStrategy(const std::string& strategy_class,
                           const DCReplicaCountMap& replication_factors)
-    : ReplicationStrategy(strategy_class)
+    : ReplicationStrategy(NETWORK_TOPOLOGY_STRATEGY, strategy_class)
     , replication_factors_(replication_factors) { }
 
   virtual ~NetworkTopologyStrategy() { }
 
   virtual bool equal(const KeyspaceMetadata& ks_meta);
-  virtual void tokens_to_replicas(const TokenHostMap& primary, TokenReplicaMap* output) const;
+  virtual bool equal(const ReplicationStrategy& other) const;
+  virtual bool is_rack_aware() const { return true; }
+
+protected:
+  virtual size_t build_replicas(const HostRing& ring,
+                                size_t start,
+                                HostVec* replicas) const;
 
 private:
   DCReplicaCountMap replication_factors_;
@@ -75,13 +196,18 @@ public:
 
   SimpleStrategy(const std::string& strategy_class,
                  size_t replication_factor)
-    : ReplicationStrategy(strategy_class)
+    : ReplicationStrategy(SIMPLE_STRATEGY, strategy_class)
     , replication_factor_(replication_factor) { }
 
   virtual ~SimpleStrategy() { }
 
   virtual bool equal(const KeyspaceMetadata& ks_meta);
-  virtual void tokens_to_replicas(const TokenHostMap& primary, TokenReplicaMap* output) const;
+  virtual bool equal(const ReplicationStrategy& other) const;
+
+protected:
+  virtual size_t build_replicas(const HostRing& ring,
+                                size_t start,
+                                HostVec* replicas) const;
 
 private:
   size_t replication_factor_;
@@ -91,11 +217,16 @@ private:
 class NonReplicatedStrategy : public ReplicationStrategy {
 public:
   NonReplicatedStrategy(const std::string& strategy_class)
-    : ReplicationStrategy(strategy_class) { }
+    : ReplicationStrategy(NON_REPLICATED_STRATEGY, strategy_class) { }
   virtual ~NonReplicatedStrategy() { }
 
   virtual bool equal(const KeyspaceMetadata& ks_meta);
-  virtual void tokens_to_replicas(const TokenHostMap& primary, TokenReplicaMap* output) const;
+  virtual bool equal(const ReplicationStrategy& other) const;
+
+protected:
+  virtual size_t build_replicas(const HostRing& ring,
+                                size_t start,
+                                HostVec* replicas) const;
 };
 
 } // namespace cass
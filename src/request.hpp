@@ -19,6 +19,7 @@
 
 #include "buffer.hpp"
 #include "constants.hpp"
+#include "keyspace_id.hpp"
 #include "macros.hpp"
 #include "ref_counted.hpp"
 #include "retry_policy.hpp"
@@ -63,7 +64,8 @@ public:
       : opcode_(opcode)
       , consistency_(DEFAULT_CONSISTENCY)
       , serial_consistency_(CASS_CONSISTENCY_ANY)
-      , timestamp_(CASS_INT64_MIN) { }
+      , timestamp_(CASS_INT64_MIN)
+      , is_idempotent_(false) { }
 
   virtual ~Request() { }
 
@@ -83,6 +85,10 @@ public:
 
   void set_timestamp(int64_t timestamp) { timestamp_ = timestamp; }
 
+  bool is_idempotent() const { return is_idempotent_; }
+
+  void set_is_idempotent(bool is_idempotent) { is_idempotent_ = is_idempotent; }
+
   RetryPolicy* retry_policy() const {
     return retry_policy_.get();
   }
@@ -106,6 +112,7 @@ private:
   CassConsistency consistency_;
   CassConsistency serial_consistency_;
   int64_t timestamp_;
+  bool is_idempotent_;
   SharedRefPtr<RetryPolicy> retry_policy_;
   SharedRefPtr<const CustomPayload> custom_payload_;
 
@@ -116,19 +123,44 @@ private:
 class RoutableRequest : public Request {
 public:
   RoutableRequest(uint8_t opcode)
-    : Request(opcode) {}
+    : Request(opcode)
+    , shared_keyspace_id_cache_(NULL) {}
 
   RoutableRequest(uint8_t opcode, const std::string& keyspace)
     : Request(opcode)
-    , keyspace_(keyspace){}
+    , keyspace_(keyspace)
+    , shared_keyspace_id_cache_(NULL) {}
 
   virtual bool get_routing_key(std::string* routing_key, EncodingCache* cache) const = 0;
 
+  // The Murmur3 token of the routing key if it's already been computed
+  virtual bool get_routing_token(int64_t* token) const { return false; }
+
   const std::string& keyspace() const { return keyspace_; }
-  void set_keyspace(const std::string& keyspace) { keyspace_ = keyspace; }
+
+  void set_keyspace(const std::string& keyspace) {
+    keyspace_ = keyspace;
+    keyspace_id_cache_.reset();
+    shared_keyspace_id_cache_ = NULL;
+  }
+
+  // The id of "keyspace()" in the token map (see TokenMap::keyspace_id())
+  const KeyspaceIdCache& keyspace_id_cache() const {
+    return shared_keyspace_id_cache_ != NULL ? *shared_keyspace_id_cache_
+                                             : keyspace_id_cache_;
+  }
+
+protected:
+  // Shares the cache of an object with the same keyspace that outlives the
+  // request, so the keyspace isn't looked up for every new request
+  void share_keyspace_id_cache(const KeyspaceIdCache* cache) {
+    shared_keyspace_id_cache_ = cache;
+  }
 
 private:
   std::string keyspace_;
+  KeyspaceIdCache keyspace_id_cache_;
+  const KeyspaceIdCache* shared_keyspace_id_cache_;
 };
 
 } // namespace cass
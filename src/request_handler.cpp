@@ -19,6 +19,7 @@
 #include "connection.hpp"
 #include "constants.hpp"
 #include "execute_request.hpp"
+#include "external_types.hpp"
 #include "io_worker.hpp"
 #include "pool.hpp"
 #include "prepare_handler.hpp"
@@ -31,6 +32,48 @@
 
 namespace cass {
 
+void MultiResponseFuture::add(Future* future) {
+  inc_ref(); // Released by on_future_set()
+  future->set_callback(on_future_set, this);
+}
+
+void MultiResponseFuture::on_future_set(CassFuture* future, void* data) {
+  MultiResponseFuture* multi_future = static_cast<MultiResponseFuture*>(data);
+  multi_future->handle_future_set(static_cast<ResponseFuture*>(future->from()));
+  multi_future->dec_ref();
+}
+
+void MultiResponseFuture::handle_future_set(ResponseFuture* future) {
+  const Error* error = future->get_error();
+
+  ScopedMutex lock(&mutex_);
+  if (error != NULL) {
+    if (error_code_ == CASS_OK) {
+      error_code_ = error->code;
+      error_message_ = error->message;
+      first_address_ = future->get_host_address();
+      first_response_ = future->response();
+    }
+  } else if (error_code_ == CASS_OK && !first_response_) {
+    first_address_ = future->get_host_address();
+    first_response_ = future->response();
+  }
+
+  if (--remaining_ > 0) return;
+
+  // This was the last request so the state can't change anymore
+  lock.unlock();
+
+  if (error_code_ == CASS_OK) {
+    set_response(first_address_, first_response_);
+  } else if (first_response_) {
+    set_error_with_response(first_address_, first_response_,
+                            error_code_, error_message_);
+  } else {
+    set_error_with_host_address(first_address_, error_code_, error_message_);
+  }
+}
+
 void RequestHandler::on_set(ResponseMessage* response) {
   assert(connection_ != NULL);
   assert(!is_query_plan_exhausted_ && "Tried to set on a non-existent host");
@@ -67,6 +110,52 @@ void RequestHandler::on_timeout() {
 void RequestHandler::set_io_worker(IOWorker* io_worker) {
   future_->set_loop(io_worker->loop());
   io_worker_ = io_worker;
+  metrics_ = io_worker->metrics();
+}
+
+void RequestHandler::schedule_next_execution() {
+  if (!execution_plan_ || is_done_) return;
+  int64_t delay_ms = execution_plan_->next_execution();
+  if (delay_ms < 0) return;
+  inc_ref(); // Timer reference
+  execution_timer_.start(io_worker_->timer_wheel(), delay_ms, this, on_execution_timeout);
+}
+
+void RequestHandler::cancel_next_execution() {
+  if (execution_timer_.is_running()) {
+    execution_timer_.stop();
+    dec_ref(); // Timer reference
+  }
+}
+
+void RequestHandler::on_execution_timeout(TimerWheel::Entry* timer) {
+  RequestHandler* request_handler = static_cast<RequestHandler*>(timer->data());
+  request_handler->execute_speculative();
+  request_handler->dec_ref(); // Timer reference
+}
+
+RequestHandler* RequestHandler::new_speculative_execution() {
+  RequestHandler* request_handler = new RequestHandler(this);
+  request_handler->inc_ref(); // IOWorker reference
+  request_handler->next_host();
+  if (request_handler->is_query_plan_exhausted_) {
+    request_handler->dec_ref();
+    return NULL;
+  }
+  running_executions_++;
+  return request_handler;
+}
+
+void RequestHandler::execute_speculative() {
+  if (is_done_) return;
+
+  RequestHandler* request_handler = new_speculative_execution();
+  if (request_handler == NULL) return; // There are no more hosts to try
+
+  metrics_->speculative_executions.inc();
+  io_worker_->execute_speculative(request_handler);
+
+  schedule_next_execution();
 }
 
 void RequestHandler::retry() {
@@ -85,8 +174,8 @@ bool RequestHandler::get_current_host_address(Address* address) {
 }
 
 void RequestHandler::next_host() {
-  current_host_ = query_plan_->compute_next();
-  is_query_plan_exhausted_ = !current_host_;
+  current_host_ = origin()->query_plan_->compute_next();
+  is_query_plan_exhausted_ = current_host_ == NULL;
 }
 
 bool RequestHandler::is_host_up(const Address& address) const {
@@ -94,28 +183,83 @@ bool RequestHandler::is_host_up(const Address& address) const {
 }
 
 void RequestHandler::set_response(const SharedRefPtr<Response>& response) {
-  uint64_t elapsed = uv_hrtime() - start_time_ns();
-  current_host_->update_latency(elapsed);
-  connection_->metrics()->record_request(elapsed);
-  future_->set_response(current_host_->address(), response);
+  uint64_t now = uv_hrtime();
+  // The host's latency only includes this execution, but the request's
+  // latency includes the delay before a speculative execution was started
+  current_host_->update_latency(now - start_time_ns());
+  if (complete_execution()) {
+    metrics_->record_request(now - origin()->start_time_ns());
+    if (origin_) {
+      // Only a response counts as a win, not an error
+      metrics_->speculative_wins.inc();
+    }
+    future_->set_response(current_host_->address(), response);
+  }
   return_connection_and_finish();
 }
 
 void RequestHandler::set_error(CassError code, const std::string& message) {
-  if (is_query_plan_exhausted_) {
-    future_->set_error(code, message);
-  } else {
-    future_->set_error_with_host_address(current_host_->address(), code, message);
-  }
-  return_connection_and_finish();
+  handle_error(SharedRefPtr<Response>(), code, message);
 }
 
 void RequestHandler::set_error_with_error_response(const SharedRefPtr<Response>& error,
                                                    CassError code, const std::string& message) {
-  future_->set_error_with_response(current_host_->address(), error, code, message);
+  handle_error(error, code, message);
+}
+
+void RequestHandler::handle_error(const SharedRefPtr<Response>& error,
+                                  CassError code, const std::string& message) {
+  RequestHandler* origin = this->origin();
+
+  // An execution's error only fails the request if no other executions are
+  // still waiting on a response, one of them could still succeed
+  if (!origin->is_done_ && origin->running_executions_ > 1) {
+    if (code != CASS_ERROR_LIB_NO_HOSTS_AVAILABLE &&
+        origin->error_code_ == CASS_OK) {
+      origin->error_code_ = code;
+      origin->error_message_ = message;
+      origin->error_response_ = error;
+      origin->has_error_address_ = !is_query_plan_exhausted_;
+      if (origin->has_error_address_) {
+        origin->error_address_ = current_host_->address();
+      }
+    }
+    return_connection_and_finish();
+    return;
+  }
+
+  if (complete_execution()) {
+    if (code == CASS_ERROR_LIB_NO_HOSTS_AVAILABLE &&
+        origin->error_code_ != CASS_OK) {
+      // Running out of hosts is less useful than an earlier execution's error
+      if (origin->error_response_) {
+        future_->set_error_with_response(origin->error_address_, origin->error_response_,
+                                         origin->error_code_, origin->error_message_);
+      } else if (origin->has_error_address_) {
+        future_->set_error_with_host_address(origin->error_address_,
+                                             origin->error_code_, origin->error_message_);
+      } else {
+        future_->set_error(origin->error_code_, origin->error_message_);
+      }
+    } else if (error) {
+      future_->set_error_with_response(current_host_->address(), error, code, message);
+    } else if (is_query_plan_exhausted_) {
+      future_->set_error(code, message);
+    } else {
+      future_->set_error_with_host_address(current_host_->address(), code, message);
+    }
+  }
   return_connection_and_finish();
 }
 
+bool RequestHandler::complete_execution() {
+  RequestHandler* origin = this->origin();
+  if (origin->is_done_) return false;
+  origin->is_done_ = true;
+  origin->cancel_next_execution();
+  return true;
+}
+
 void RequestHandler::return_connection() {
   if (pool_ != NULL && connection_ != NULL) {
       pool_->return_connection(connection_);
@@ -124,6 +268,7 @@ void RequestHandler::return_connection() {
 
 void RequestHandler::return_connection_and_finish() {
   return_connection();
+  origin()->running_executions_--;
   if (io_worker_ != NULL) {
     io_worker_->request_finished(this);
   }
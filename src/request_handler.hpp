@@ -28,6 +28,8 @@
 #include "response.hpp"
 #include "retry_policy.hpp"
 #include "scoped_ptr.hpp"
+#include "speculative_execution.hpp"
+#include "timer_wheel.hpp"
 
 #include <string>
 #include <uv.h>
@@ -41,9 +43,15 @@ class Timer;
 
 class ResponseFuture : public Future {
 public:
+  ResponseFuture()
+      : Future(CASS_FUTURE_TYPE_RESPONSE) { }
+
+  // Only prepared statements use the schema metadata (to determine the
+  // partition key columns) so the snapshot is only taken for PREPARE
+  // requests. This keeps the metadata lock off the execute path.
   ResponseFuture(const Metadata& metadata)
       : Future(CASS_FUTURE_TYPE_RESPONSE)
-      , schema_metadata(metadata.schema_snapshot()) { }
+      , schema_metadata(new Metadata::SchemaSnapshot(metadata.schema_snapshot())) { }
 
   void set_response(Address address, const SharedRefPtr<Response>& response) {
     ScopedMutex lock(&mutex_);
@@ -79,13 +87,38 @@ public:
   }
 
   std::string statement;
-  Metadata::SchemaSnapshot schema_metadata;
+  ScopedPtr<const Metadata::SchemaSnapshot> schema_metadata;
 
 private:
   Address address_;
   SharedRefPtr<Response> response_;
 };
 
+// Combines several requests into a single future. It's set once all of the
+// requests have finished: with the first error if any of them failed,
+// otherwise with the first response received.
+class MultiResponseFuture : public ResponseFuture {
+public:
+  MultiResponseFuture(size_t count)
+    : remaining_(count)
+    , error_code_(CASS_OK) { }
+
+  // Adds the future of one of the requests. This future is kept alive until
+  // "future" is set.
+  void add(Future* future);
+
+private:
+  static void on_future_set(CassFuture* future, void* data);
+  void handle_future_set(ResponseFuture* future);
+
+private:
+  size_t remaining_;
+  Address first_address_;
+  SharedRefPtr<Response> first_response_;
+  CassError error_code_;
+  std::string error_message_;
+};
+
 
 class RequestHandler : public Handler {
 public:
@@ -97,40 +130,110 @@ public:
       , retry_policy_(retry_policy)
       , num_retries_(0)
       , is_query_plan_exhausted_(true)
+      , current_host_(NULL)
       , io_worker_(NULL)
-      , pool_(NULL) {
+      , metrics_(NULL)
+      , pool_(NULL)
+      , running_executions_(1)
+      , is_done_(false)
+      , error_code_(CASS_OK)
+      , has_error_address_(false) {
     set_timestamp(request->timestamp());
   }
 
+  // A speculative execution of "request_handler". It shares the future,
+  // query plan and retry policy of the original request handler.
+  RequestHandler(RequestHandler* request_handler)
+      : Handler(request_handler->request())
+      , future_(request_handler->future_.get())
+      , retry_policy_(request_handler->retry_policy_)
+      , num_retries_(0)
+      , is_query_plan_exhausted_(true)
+      , current_host_(NULL)
+      , io_worker_(request_handler->io_worker_)
+      , metrics_(request_handler->metrics_)
+      , pool_(NULL)
+      , origin_(request_handler)
+      , running_executions_(0)
+      , is_done_(false)
+      , error_code_(CASS_OK)
+      , has_error_address_(false) {
+    set_timestamp(request_handler->timestamp());
+  }
+
   virtual void on_set(ResponseMessage* response);
   virtual void on_error(CassError code, const std::string& message);
   virtual void on_timeout();
 
   virtual void retry();
 
+  // Query plans for this request should be allocated from this arena
+  QueryPlanArena* query_plan_arena() { return &query_plan_arena_; }
+
   void set_query_plan(QueryPlan* query_plan) {
     query_plan_.reset(query_plan);
   }
 
+  void set_execution_plan(SpeculativeExecutionPlan* execution_plan) {
+    execution_plan_.reset(execution_plan);
+  }
+
   void set_io_worker(IOWorker* io_worker);
 
+  // Testing only (set by set_io_worker())
+  void set_metrics(Metrics* metrics) { metrics_ = metrics; }
+
+  // Starts the timer for the next speculative execution if the request has
+  // an execution plan
+  void schedule_next_execution();
+
   Pool* pool() const { return pool_; }
 
   void set_pool(Pool* pool) {
     pool_ = pool;
   }
 
+  // Kept alive by the query plan
+  Host* current_host() const { return current_host_; }
   bool get_current_host_address(Address* address);
   void next_host();
 
+  // Returns true if the request can be moved to another IO worker. Running
+  // speculative executions share state with the original request so they
+  // keep it on the current IO worker (this is why speculative executions
+  // can't be combined with IO worker affinity).
+  bool is_transferable() const { return !origin_ && running_executions_ == 1; }
+
+  // Stops the timer for the next speculative execution. This must be called
+  // on the current IO worker before the request is moved to another one.
+  void cancel_next_execution();
+
+  // Creates a speculative execution on the next host of the query plan and
+  // counts it as running. Returns NULL if there are no more hosts to try.
+  RequestHandler* new_speculative_execution();
+
+  // Testing only
+  int running_executions() const { return running_executions_; }
+
   bool is_host_up(const Address& address) const;
 
   void set_response(const SharedRefPtr<Response>& response);
 
 private:
+  // The original request handler (this one if it's not a speculative
+  // execution) which holds the state shared by all executions
+  RequestHandler* origin() { return origin_ ? origin_.get() : this; }
+
+  bool complete_execution();
+  void execute_speculative();
+
+  static void on_execution_timeout(TimerWheel::Entry* timer);
+
   void set_error(CassError code, const std::string& message);
   void set_error_with_error_response(const SharedRefPtr<Response>& error,
                                      CassError code, const std::string& message);
+  void handle_error(const SharedRefPtr<Response>& error,
+                    CassError code, const std::string& message);
   void return_connection();
   void return_connection_and_finish();
 
@@ -145,10 +248,27 @@ private:
   RetryPolicy* retry_policy_;
   int num_retries_;
   bool is_query_plan_exhausted_;
-  SharedRefPtr<Host> current_host_;
+  Host* current_host_;
+  // The plan must be destroyed before its arena
+  QueryPlanArena query_plan_arena_;
   ScopedPtr<QueryPlan> query_plan_;
   IOWorker* io_worker_;
+  Metrics* metrics_;
   Pool* pool_;
+  ScopedRefPtr<RequestHandler> origin_;
+
+  // Only used by the original request handler
+  ScopedPtr<SpeculativeExecutionPlan> execution_plan_;
+  TimerWheel::Entry execution_timer_;
+  int running_executions_;
+  bool is_done_;
+  // The first error of an execution that failed while other executions were
+  // still running. It's used if the last execution runs out of hosts.
+  CassError error_code_;
+  std::string error_message_;
+  SharedRefPtr<Response> error_response_;
+  Address error_address_;
+  bool has_error_address_;
 };
 
 } // namespace cass
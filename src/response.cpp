@@ -17,6 +17,7 @@
 #include "response.hpp"
 
 #include "auth_responses.hpp"
+#include "compression.hpp"
 #include "error_response.hpp"
 #include "event_response.hpp"
 #include "logger.hpp"
@@ -95,7 +96,50 @@ bool ResponseMessage::allocate_body(int8_t opcode) {
   }
 }
 
-ssize_t ResponseMessage::decode(char* input, size_t size) {
+bool ResponseMessage::decompress_body(const Compressor* compressor) {
+  if (compressor == NULL) {
+    LOG_ERROR("Received a compressed frame, but compression was not negotiated");
+    return false;
+  }
+
+  SharedRefPtr<RefBuffer> compressed(response_body_->buffer());
+
+  size_t length;
+  if (!compressor->uncompressed_length(compressed->data(), length_, &length)) {
+    LOG_ERROR("Invalid uncompressed length for %s compressed frame", compressor->name());
+    return false;
+  }
+
+  response_body_->set_buffer(length, buffer_pool_);
+  if (!compressor->decompress(compressed->data(), length_,
+                              response_body_->data(), length)) {
+    LOG_ERROR("Unable to decompress %s compressed frame", compressor->name());
+    return false;
+  }
+
+  compressed_length_ = length_;
+  length_ = static_cast<int32_t>(length);
+  return true;
+}
+
+void ResponseMessage::reset() {
+  version_ = 0;
+  flags_ = 0;
+  stream_ = 0;
+  opcode_ = 0;
+  length_ = 0;
+  compressed_length_ = 0;
+  received_ = 0;
+  header_size_ = 0;
+  is_header_received_ = false;
+  header_buffer_pos_ = header_buffer_;
+  is_body_ready_ = false;
+  is_body_error_ = false;
+  response_body_.reset();
+  body_buffer_pos_ = NULL;
+}
+
+ssize_t ResponseMessage::decode(char* input, size_t size, const Compressor* compressor) {
   char* input_pos = input;
 
   received_ += size;
@@ -138,7 +182,7 @@ ssize_t ResponseMessage::decode(char* input, size_t size) {
         return -1;
       }
 
-      response_body_->set_buffer(length_);
+      response_body_->set_buffer(length_, buffer_pool_);
       body_buffer_pos_ = response_body_->data();
     } else {
       // We haven't received all the data for the header. We consume the
@@ -157,11 +201,18 @@ ssize_t ResponseMessage::decode(char* input, size_t size) {
     size_t overage = received_ - frame_size;
     size_t needed = remaining - overage;
 
-    memcpy(body_buffer_pos_, input_pos, needed);
+    if (input_pos != body_buffer_pos_) { // Not read directly into the body
+      memcpy(body_buffer_pos_, input_pos, needed);
+    }
     body_buffer_pos_ += needed;
     input_pos += needed;
     assert(body_buffer_pos_ == response_body_->data() + length_);
 
+    if ((flags_ & CASS_FLAG_COMPRESSION) && !decompress_body(compressor)) {
+      is_body_error_ = true;
+      return -1;
+    }
+
     char* pos = response_body()->data();
 
     if (flags_ & CASS_FLAG_WARNING) {
@@ -181,7 +232,9 @@ ssize_t ResponseMessage::decode(char* input, size_t size) {
   } else {
     // We haven't received all the data for the frame. We consume the entire
     // buffer.
-    memcpy(body_buffer_pos_, input_pos, remaining);
+    if (input_pos != body_buffer_pos_) {
+      memcpy(body_buffer_pos_, input_pos, remaining);
+    }
     body_buffer_pos_ += remaining;
     return size;
   }
@@ -22,12 +22,15 @@
 #include "hash_table.hpp"
 #include "macros.hpp"
 #include "ref_counted.hpp"
+#include "response_buffer_pool.hpp"
 #include "scoped_ptr.hpp"
 
 #include <uv.h>
 
 namespace cass {
 
+class Compressor;
+
 class Response : public RefCounted<Response> {
 public:
   struct CustomPayloadItem {
@@ -51,8 +54,9 @@ public:
 
   const SharedRefPtr<RefBuffer>& buffer() const { return buffer_; }
 
-  void set_buffer(size_t size) {
-    buffer_ = SharedRefPtr<RefBuffer>(RefBuffer::create(size));
+  void set_buffer(size_t size, ResponseBufferPool* pool = NULL) {
+    buffer_ = SharedRefPtr<RefBuffer>(pool != NULL ? pool->acquire(size)
+                                                    : RefBuffer::create(size));
   }
 
   const CustomPayloadVec& custom_payload() const { return custom_payload_; }
@@ -74,12 +78,15 @@ private:
 
 class ResponseMessage {
 public:
-  ResponseMessage()
-      : version_(0)
+  // Bodies are allocated from "buffer_pool" if it's not NULL
+  ResponseMessage(ResponseBufferPool* buffer_pool = NULL)
+      : buffer_pool_(buffer_pool)
+      , version_(0)
       , flags_(0)
       , stream_(0)
       , opcode_(0)
       , length_(0)
+      , compressed_length_(0)
       , received_(0)
       , header_size_(0)
       , is_header_received_(false)
@@ -94,21 +101,43 @@ public:
 
   int16_t stream() const { return stream_; }
 
+  int32_t length() const { return length_; }
+
+  // The size of the body as received if it was compressed, otherwise 0
+  int32_t compressed_length() const { return compressed_length_; }
+
   const SharedRefPtr<Response>& response_body() { return response_body_; }
 
   bool is_body_ready() const { return is_body_ready_; }
 
-  ssize_t decode(char* input, size_t size);
+  // The position in the body where the next received bytes belong and how
+  // many bytes of the body are still missing (0 until the header has been
+  // received). Data can be read directly into this region and then passed
+  // to decode() which doesn't copy it.
+  char* body_buffer_pos() const { return body_buffer_pos_; }
+
+  size_t body_remaining() const {
+    if (!is_header_received_ || is_body_ready_ || !response_body_) return 0;
+    return static_cast<size_t>((response_body_->data() + length_) - body_buffer_pos_);
+  }
+
+  ssize_t decode(char* input, size_t size, const Compressor* compressor);
+
+  // Prepares the message to decode a new frame so it can be reused
+  void reset();
 
 private:
   bool allocate_body(int8_t opcode);
+  bool decompress_body(const Compressor* compressor);
 
 private:
+  ResponseBufferPool* buffer_pool_;
   uint8_t version_;
   uint8_t flags_;
   int16_t stream_;
   uint8_t opcode_;
   int32_t length_;
+  int32_t compressed_length_;
   size_t received_;
   size_t header_size_;
 
@@ -0,0 +1,98 @@
+/*
+  Copyright (c) 2014-2016 DataStax
+
+  Licensed under the Apache License, Version 2.0 (the "License");
+  you may not use this file except in compliance with the License.
+  You may obtain a copy of the License at
+
+  http://www.apache.org/licenses/LICENSE-2.0
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+*/
+
+
+#include "response_buffer_pool.hpp"
+
+#include "metrics.hpp"
+
+namespace cass {
+
+ResponseBufferPool::ResponseBufferPool(Metrics* metrics)
+  : metrics_(metrics)
+  , acquire_count_(0)
+  , last_acquire_count_(0) {
+  for (size_t i = 0; i < NUM_SIZE_CLASSES; ++i) {
+    size_t count = MAX_FREE_BYTES_PER_SIZE_CLASS / (MIN_CAPACITY << i);
+    free_lists_[i].reset(new FreeList(count < 2 ? 2 : count));
+  }
+}
+
+ResponseBufferPool::~ResponseBufferPool() {
+  trim();
+}
+
+RefBuffer* ResponseBufferPool::acquire(size_t size) {
+  size_t index = size_class(size);
+  if (index >= NUM_SIZE_CLASSES) {
+    return RefBuffer::create(size);
+  }
+
+  size_t capacity = MIN_CAPACITY << index;
+  ++acquire_count_;
+  void* memory;
+  if (free_lists_[index]->dequeue(memory)) {
+    if (metrics_ != NULL) metrics_->response_buffer_pool_hits.inc();
+  } else {
+    memory = ::operator new(RefBuffer::block_size(capacity));
+    if (metrics_ != NULL) metrics_->response_buffer_pool_misses.inc();
+  }
+
+  inc_ref(); // Released with the buffer
+  return RefBuffer::create(this, memory, capacity);
+}
+
+void ResponseBufferPool::release(void* memory, size_t capacity) {
+  if (!free_lists_[size_class(capacity)]->enqueue(memory)) {
+    ::operator delete(memory);
+  }
+  dec_ref(); // This can delete the pool
+}
+
+size_t ResponseBufferPool::trim() {
+  size_t freed = 0;
+  for (size_t i = 0; i < NUM_SIZE_CLASSES; ++i) {
+    void* memory;
+    while (free_lists_[i]->dequeue(memory)) {
+      ::operator delete(memory);
+      freed += MIN_CAPACITY << i;
+    }
+  }
+  return freed;
+}
+
+size_t ResponseBufferPool::trim_if_idle() {
+  bool is_idle = acquire_count_ == last_acquire_count_;
+  last_acquire_count_ = acquire_count_;
+  return is_idle ? trim() : 0;
+}
+
+size_t ResponseBufferPool::capacity(size_t size) {
+  size_t index = size_class(size);
+  return index < NUM_SIZE_CLASSES ? MIN_CAPACITY << index : size;
+}
+
+size_t ResponseBufferPool::size_class(size_t size) {
+  size_t index = 0;
+  size_t capacity = MIN_CAPACITY;
+  while (capacity < size && index < NUM_SIZE_CLASSES) {
+    capacity <<= 1;
+    ++index;
+  }
+  return index;
+}
+
+} // namespace cass
@@ -0,0 +1,85 @@
+/*
+  Copyright (c) 2014-2016 DataStax
+
+  Licensed under the Apache License, Version 2.0 (the "License");
+  you may not use this file except in compliance with the License.
+  You may obtain a copy of the License at
+
+  http://www.apache.org/licenses/LICENSE-2.0
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+*/
+
+
+#ifndef __CASS_RESPONSE_BUFFER_POOL_HPP_INCLUDED__
+#define __CASS_RESPONSE_BUFFER_POOL_HPP_INCLUDED__
+
+#include "macros.hpp"
+#include "mpmc_queue.hpp"
+#include "ref_counted.hpp"
+#include "scoped_ptr.hpp"
+
+namespace cass {
+
+class Metrics;
+
+// Size-classed free lists for the response bodies received by an IO worker.
+// Buffers are acquired on the IO worker's thread, but results are often
+// freed by the application so buffers can be released on any thread. The
+// free lists are bounded lock-free queues and the pool is kept alive by its
+// outstanding buffers.
+class ResponseBufferPool
+    : public RefBuffer::Pool
+    , public RefCounted<ResponseBufferPool> {
+public:
+  typedef SharedRefPtr<ResponseBufferPool> Ptr;
+
+  // Size classes are powers of two from MIN_CAPACITY up to
+  // MIN_CAPACITY << (NUM_SIZE_CLASSES - 1) (1 MB)
+  static const size_t MIN_CAPACITY = 256;
+  static const size_t NUM_SIZE_CLASSES = 13;
+  // The free buffers kept per size class are limited to roughly this many
+  // bytes (but at least two buffers)
+  static const size_t MAX_FREE_BYTES_PER_SIZE_CLASS = 512 * 1024;
+
+  // "metrics" records hits and misses, it can be NULL
+  ResponseBufferPool(Metrics* metrics);
+  ~ResponseBufferPool();
+
+  // Must only be called from the pool's IO worker thread. Buffers larger
+  // than the biggest size class are allocated without the pool.
+  RefBuffer* acquire(size_t size);
+
+  virtual void release(void* memory, size_t capacity);
+
+  // Frees all the cached buffers and returns the number of bytes freed. Must
+  // only be called from the pool's IO worker thread.
+  size_t trim();
+
+  // Trims the pool if no buffers have been acquired since the last call
+  size_t trim_if_idle();
+
+  static size_t capacity(size_t size);
+
+private:
+  typedef MPMCQueue<void*> FreeList;
+
+  static size_t size_class(size_t size);
+
+private:
+  Metrics* metrics_;
+  ScopedPtr<FreeList> free_lists_[NUM_SIZE_CLASSES];
+  size_t acquire_count_;
+  size_t last_acquire_count_;
+
+private:
+  DISALLOW_COPY_AND_ASSIGN(ResponseBufferPool);
+};
+
+} // namespace cass
+
+#endif
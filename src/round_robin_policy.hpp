@@ -17,6 +17,7 @@
 #ifndef __CASS_ROUND_ROBIN_POLICY_HPP_INCLUDED__
 #define __CASS_ROUND_ROBIN_POLICY_HPP_INCLUDED__
 
+#include "atomic.hpp"
 #include "cassandra.h"
 #include "copy_on_write_ptr.hpp"
 #include "load_balancing.hpp"
@@ -40,11 +41,12 @@ public:
     return CASS_HOST_DISTANCE_LOCAL;
   }
 
-  virtual QueryPlan* new_query_plan(const std::string& connected_keyspace,
+  virtual QueryPlan* new_query_plan(KeyspaceId connected_keyspace_id,
                                     const Request* request,
                                     const TokenMap& token_map,
-                                    Request::EncodingCache* cache) {
-    return new RoundRobinQueryPlan(hosts_, index_++);
+                                    Request::EncodingCache* cache,
+                                    QueryPlanArena* arena) {
+    return new (arena) RoundRobinQueryPlan(hosts_, index_.fetch_add(1, MEMORY_ORDER_RELAXED));
   }
 
   virtual void on_add(const SharedRefPtr<Host>& host) {
@@ -73,15 +75,15 @@ private:
       , index_(start_index)
       , remaining_(hosts->size()) {}
 
-    SharedRefPtr<Host> compute_next()  {
+    Host* compute_next()  {
       while (remaining_ > 0) {
         --remaining_;
         const SharedRefPtr<Host>& host((*hosts_)[index_++ % hosts_->size()]);
         if (host->is_up()) {
-          return host;
+          return host.get();
         }
       }
-      return SharedRefPtr<Host>();
+      return NULL;
     }
 
   private:
@@ -91,7 +93,7 @@ private:
   };
 
   CopyOnWriteHostVec hosts_;
-  size_t index_;
+  Atomic<size_t> index_;
 
 private:
   DISALLOW_COPY_AND_ASSIGN(RoundRobinPolicy);
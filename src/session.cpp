@@ -91,6 +91,10 @@ CassFuture* cass_session_execute_batch(CassSession* session, const CassBatch* ba
   return CassFuture::to(session->execute(batch->from()));
 }
 
+CassFuture* cass_session_execute_batch_split(CassSession* session, const CassBatch* batch) {
+  return CassFuture::to(session->execute_split(batch->from()));
+}
+
 const CassSchemaMeta* cass_session_get_schema_meta(const CassSession* session) {
   return CassSchemaMeta::to(new cass::Metadata::SchemaSnapshot(session->metadata().schema_snapshot()));
 }
@@ -127,6 +131,37 @@ void  cass_session_get_metrics(const CassSession* session,
   metrics->errors.connection_timeouts = internal_metrics->connection_timeouts.sum();
   metrics->errors.pending_request_timeouts = internal_metrics->pending_request_timeouts.sum();
   metrics->errors.request_timeouts = internal_metrics->request_timeouts.sum();
+
+  metrics->compression.uncompressed_bytes_sent = internal_metrics->uncompressed_bytes_sent.sum();
+  metrics->compression.compressed_bytes_sent = internal_metrics->compressed_bytes_sent.sum();
+  metrics->compression.uncompressed_bytes_received = internal_metrics->uncompressed_bytes_received.sum();
+  metrics->compression.compressed_bytes_received = internal_metrics->compressed_bytes_received.sum();
+
+  metrics->speculative_executions.attempts = internal_metrics->speculative_executions.sum();
+  metrics->speculative_executions.wins = internal_metrics->speculative_wins.sum();
+
+  metrics->writes.bytes_written = internal_metrics->bytes_written.sum();
+  metrics->writes.bytes_written_synchronously = internal_metrics->bytes_written_sync.sum();
+
+  cass::Metrics::Histogram::Snapshot flush_requests_snapshot;
+  internal_metrics->flush_batch_requests.get_snapshot(&flush_requests_snapshot);
+  metrics->flushes.requests_median = flush_requests_snapshot.median;
+  metrics->flushes.requests_percentile_99th = flush_requests_snapshot.percentile_99th;
+  metrics->flushes.requests_max = flush_requests_snapshot.max;
+
+  cass::Metrics::Histogram::Snapshot flush_bytes_snapshot;
+  internal_metrics->flush_batch_bytes.get_snapshot(&flush_bytes_snapshot);
+  metrics->flushes.bytes_median = flush_bytes_snapshot.median;
+  metrics->flushes.bytes_percentile_99th = flush_bytes_snapshot.percentile_99th;
+  metrics->flushes.bytes_max = flush_bytes_snapshot.max;
+
+  metrics->response_pool.buffer_hits = internal_metrics->response_buffer_pool_hits.sum();
+  metrics->response_pool.buffer_misses = internal_metrics->response_buffer_pool_misses.sum();
+  metrics->response_pool.message_hits = internal_metrics->response_message_pool_hits.sum();
+  metrics->response_pool.message_misses = internal_metrics->response_message_pool_misses.sum();
+
+  metrics->token_map.replica_sets = session->metadata().token_map_replica_set_count();
+  metrics->token_map.memory_bytes = session->metadata().token_map_memory_size();
 }
 
 } // extern "C"
@@ -140,21 +175,26 @@ Session::Session()
     , pending_pool_count_(0)
     , pending_workers_count_(0)
     , current_io_worker_(0)
-    , keyspace_(new std::string){
+    , next_owner_io_worker_(0)
+    , keyspace_(new Keyspace("")) {
   uv_mutex_init(&state_mutex_);
   uv_mutex_init(&hosts_mutex_);
+  uv_rwlock_init(&policy_rwlock_);
 }
 
 Session::~Session() {
   join();
   uv_mutex_destroy(&state_mutex_);
   uv_mutex_destroy(&hosts_mutex_);
+  uv_rwlock_destroy(&policy_rwlock_);
 }
 
 void Session::clear(const Config& config) {
   config_ = config;
   metrics_.reset(new Metrics(config_.thread_count_io() + 1));
   load_balancing_policy_.reset(config.load_balancing_policy());
+  speculative_execution_policy_.reset(config.speculative_execution_policy());
+  speculative_execution_policy_->init(metrics_.get());
   connect_future_.reset();
   close_future_.reset();
   { // Lock hosts
@@ -168,7 +208,8 @@ void Session::clear(const Config& config) {
   current_host_mark_ = true;
   pending_pool_count_ = 0;
   pending_workers_count_ = 0;
-  current_io_worker_ = 0;
+  current_io_worker_.store(0);
+  next_owner_io_worker_ = 0;
 }
 
 int Session::init() {
@@ -180,7 +221,7 @@ int Session::init() {
   if (rc != 0) return rc;
 
   for (unsigned int i = 0; i < config_.thread_count_io(); ++i) {
-    SharedRefPtr<IOWorker> io_worker(new IOWorker(this));
+    SharedRefPtr<IOWorker> io_worker(new IOWorker(this, i));
     int rc = io_worker->init();
     if (rc != 0) return rc;
     io_workers_.push_back(io_worker);
@@ -200,7 +241,8 @@ void Session::broadcast_keyspace_change(const std::string& keyspace,
     if (*it == calling_io_worker) continue;
       (*it)->set_keyspace(keyspace);
   }
-  keyspace_ = CopyOnWritePtr<std::string>(new std::string(keyspace));
+  ScopedWriteLock l(&policy_rwlock_);
+  keyspace_ = CopyOnWritePtr<Keyspace>(new Keyspace(keyspace));
 }
 
 SharedRefPtr<Host> Session::get_host(const Address& address) {
@@ -213,9 +255,26 @@ SharedRefPtr<Host> Session::get_host(const Address& address) {
   return it->second;
 }
 
+IOWorker* Session::owner_io_worker(const Host* host) const {
+  return io_workers_[host->io_worker_index()].get();
+}
+
+bool Session::transfer(RequestHandler* request_handler) {
+  // Lock policy (the session can't close the IO workers while this is held)
+  ScopedReadLock l(&policy_rwlock_);
+  if (state_.load(MEMORY_ORDER_ACQUIRE) != SESSION_STATE_CONNECTED) {
+    return false;
+  }
+  return owner_io_worker(request_handler->current_host())->execute(request_handler);
+}
+
 SharedRefPtr<Host> Session::add_host(const Address& address) {
   LOG_DEBUG("Adding new host: %s", address.to_string().c_str());
   SharedRefPtr<Host> host(new Host(address, !current_host_mark_));
+  // Hosts are spread evenly across the IO workers (only used for IO worker
+  // affinity)
+  host->set_io_worker_index(next_owner_io_worker_++ % io_workers_.size());
+  host->init_io_worker_availability(io_workers_.size());
   { // Lock hosts
     ScopedMutex l(&hosts_mutex_);
     hosts_[address] = host;
@@ -463,9 +522,9 @@ void Session::on_event(const SessionEvent& event) {
     case SessionEvent::NOTIFY_KEYSPACE_ERROR: {
       // Currently, this is only called when the keyspace does not exist
       // and not for any other keyspace related errors.
-      const CopyOnWritePtr<std::string> keyspace(keyspace_);
+      const CopyOnWritePtr<Keyspace> keyspace(keyspace_);
       notify_connect_error(CASS_ERROR_LIB_UNABLE_TO_SET_KEYSPACE,
-                           "Keyspace '" + *keyspace + "' does not exist");
+                           "Keyspace '" + keyspace->name + "' does not exist");
       break;
     }
 
@@ -510,7 +569,26 @@ void Session::on_resolve_done(MultiResolver<Session*>* resolver) {
 }
 
 void Session::execute(RequestHandler* request_handler) {
-  if (state_.load(MEMORY_ORDER_ACQUIRE) != SESSION_STATE_CONNECTED) {
+  if (config_.use_direct_dispatch()) {
+    bool is_connected = false;
+    bool is_dispatched = false;
+    { // Lock policy (the session can't close the IO workers while this is held)
+      ScopedReadLock l(&policy_rwlock_);
+      if (state_.load(MEMORY_ORDER_ACQUIRE) == SESSION_STATE_CONNECTED) {
+        is_connected = true;
+        is_dispatched = dispatch(request_handler);
+      }
+    }
+    // Errors are set outside of the lock because a future callback could
+    // execute another request on this thread.
+    if (!is_connected) {
+      request_handler->on_error(CASS_ERROR_LIB_NO_HOSTS_AVAILABLE,
+                                "Session is not connected");
+    } else if (!is_dispatched) {
+      request_handler->on_error(CASS_ERROR_LIB_NO_HOSTS_AVAILABLE,
+                                "All connections on all I/O threads are busy");
+    }
+  } else if (state_.load(MEMORY_ORDER_ACQUIRE) != SESSION_STATE_CONNECTED) {
     request_handler->on_error(CASS_ERROR_LIB_NO_HOSTS_AVAILABLE,
                               "Session is not connected");
   } else if (!request_queue_->enqueue(request_handler)) {
@@ -545,7 +623,10 @@ void Session::on_add_resolve_name(NameResolver* resolver) {
 
 void Session::on_control_connection_ready() {
   // No hosts lock necessary (only called on session thread and read-only)
-  load_balancing_policy_->init(control_connection_.connected_host(), hosts_);
+  { // Lock policy
+    ScopedWriteLock l(&policy_rwlock_);
+    load_balancing_policy_->init(control_connection_.connected_host(), hosts_);
+  }
   load_balancing_policy_->register_handles(loop());
   for (IOWorkerVec::iterator it = io_workers_.begin(),
        end = io_workers_.end(); it != end; ++it) {
@@ -604,11 +685,21 @@ void Session::internal_on_add(SharedRefPtr<Host> host, bool is_initial_connectio
   }
 
   if (is_initial_connection) {
-    pending_pool_count_ += io_workers_.size();
+    pending_pool_count_ += config_.use_io_worker_affinity() ? 1 : io_workers_.size();
   } else {
+    ScopedWriteLock l(&policy_rwlock_);
     load_balancing_policy_->on_add(host);
   }
 
+  add_pool_async(host, is_initial_connection);
+}
+
+void Session::add_pool_async(SharedRefPtr<Host> host, bool is_initial_connection) {
+  if (config_.use_io_worker_affinity()) {
+    owner_io_worker(host.get())->add_pool_async(host, is_initial_connection);
+    return;
+  }
+
   for (IOWorkerVec::iterator it = io_workers_.begin(),
        end = io_workers_.end(); it != end; ++it) {
     (*it)->add_pool_async(host, is_initial_connection);
@@ -616,7 +707,10 @@ void Session::internal_on_add(SharedRefPtr<Host> host, bool is_initial_connectio
 }
 
 void Session::on_remove(SharedRefPtr<Host> host) {
-  load_balancing_policy_->on_remove(host);
+  { // Lock policy
+    ScopedWriteLock l(&policy_rwlock_);
+    load_balancing_policy_->on_remove(host);
+  }
   { // Lock hosts
     ScopedMutex l(&hosts_mutex_);
     hosts_.erase(host->address());
@@ -634,17 +728,20 @@ void Session::on_up(SharedRefPtr<Host> host) {
     return;
   }
 
-  load_balancing_policy_->on_up(host);
-
-  for (IOWorkerVec::iterator it = io_workers_.begin(),
-       end = io_workers_.end(); it != end; ++it) {
-    (*it)->add_pool_async(host, false);
+  { // Lock policy
+    ScopedWriteLock l(&policy_rwlock_);
+    load_balancing_policy_->on_up(host);
   }
+
+  add_pool_async(host, false);
 }
 
 void Session::on_down(SharedRefPtr<Host> host) {
   host->set_down();
-  load_balancing_policy_->on_down(host);
+  { // Lock policy
+    ScopedWriteLock l(&policy_rwlock_);
+    load_balancing_policy_->on_down(host);
+  }
 
   bool cancel_reconnect = false;
   if (load_balancing_policy_->distance(host) == CASS_HOST_DISTANCE_IGNORE) {
@@ -659,7 +756,7 @@ void Session::on_down(SharedRefPtr<Host> host) {
 }
 
 Future* Session::execute(const RoutableRequest* request) {
-  ResponseFuture* future = new ResponseFuture(metadata_);
+  ResponseFuture* future = new ResponseFuture();
   future->inc_ref(); // External reference
 
   RetryPolicy* retry_policy
@@ -676,6 +773,33 @@ Future* Session::execute(const RoutableRequest* request) {
   return future;
 }
 
+Future* Session::execute_split(const BatchRequest* batch) {
+  BatchRequest::Vec batches;
+  { // Lock policy (the keyspace is changed by the IO workers)
+    ScopedReadLock l(&policy_rwlock_);
+    const CopyOnWritePtr<Keyspace> keyspace(keyspace_);
+    TokenMap::ConstPtr token_map(metadata_.token_map());
+    batch->split_by_replicas(token_map->keyspace_id(keyspace->name, keyspace->id_cache),
+                             *token_map, &batches);
+  }
+
+  if (batches.size() <= 1) {
+    return execute(batch);
+  }
+
+  MultiResponseFuture* future = new MultiResponseFuture(batches.size());
+  future->inc_ref(); // External reference
+
+  for (BatchRequest::Vec::const_iterator i = batches.begin(),
+       end = batches.end(); i != end; ++i) {
+    Future* batch_future = execute(i->get());
+    future->add(batch_future);
+    batch_future->dec_ref();
+  }
+
+  return future;
+}
+
 #if UV_VERSION_MAJOR == 0
 void Session::on_execute(uv_async_t* data, int status) {
 #else
@@ -688,35 +812,9 @@ void Session::on_execute(uv_async_t* data) {
   RequestHandler* request_handler = NULL;
   while (session->request_queue_->dequeue(request_handler)) {
     if (request_handler != NULL) {
-      request_handler->set_query_plan(session->new_query_plan(request_handler->request(),
-                                                              request_handler->encoding_cache()));
-
-      if (request_handler->timestamp() == CASS_INT64_MIN) {
-        request_handler->set_timestamp(session->config_.timestamp_gen()->next());
-      }
-
-      bool is_done = false;
-      while (!is_done) {
-        request_handler->next_host();
-
-        Address address;
-        if (!request_handler->get_current_host_address(&address)) {
-          request_handler->on_error(CASS_ERROR_LIB_NO_HOSTS_AVAILABLE,
-                                    "All connections on all I/O threads are busy");
-          break;
-        }
-
-        size_t start = session->current_io_worker_;
-        for (size_t i = 0, size = session->io_workers_.size(); i < size; ++i) {
-          const SharedRefPtr<IOWorker>& io_worker = session->io_workers_[start % size];
-          if (io_worker->is_host_available(address) &&
-              io_worker->execute(request_handler)) {
-            session->current_io_worker_ = (start + 1) % size;
-            is_done = true;
-            break;
-          }
-          start++;
-        }
+      if (!session->dispatch(request_handler)) {
+        request_handler->on_error(CASS_ERROR_LIB_NO_HOSTS_AVAILABLE,
+                                  "All connections on all I/O threads are busy");
       }
     } else {
       is_closing = true;
@@ -724,6 +822,9 @@ void Session::on_execute(uv_async_t* data) {
   }
 
   if (is_closing) {
+    // Wait for any requests being dispatched directly to the IO workers so
+    // that they're enqueued before the IO workers are closed.
+    ScopedWriteLock l(&session->policy_rwlock_);
     session->pending_workers_count_ = session->io_workers_.size();
     for (IOWorkerVec::iterator it = session->io_workers_.begin(),
                                end = session->io_workers_.end();
@@ -733,10 +834,56 @@ void Session::on_execute(uv_async_t* data) {
   }
 }
 
-QueryPlan* Session::new_query_plan(const Request* request, Request::EncodingCache* cache) {
-  const CopyOnWritePtr<std::string> keyspace(keyspace_);
-  return load_balancing_policy_->new_query_plan(*keyspace, request,
-                                                metadata_.token_map(), cache);
+bool Session::dispatch(RequestHandler* request_handler) {
+  request_handler->set_query_plan(new_query_plan(request_handler->request(),
+                                                 request_handler->encoding_cache(),
+                                                 request_handler->query_plan_arena()));
+
+  if (request_handler->request()->is_idempotent()) {
+    request_handler->set_execution_plan(
+          speculative_execution_policy_->new_plan(request_handler->request()));
+  }
+
+  if (request_handler->timestamp() == CASS_INT64_MIN) {
+    request_handler->set_timestamp(config_.timestamp_gen()->next());
+  }
+
+  for (;;) {
+    request_handler->next_host();
+
+    const Host* host = request_handler->current_host();
+    if (host == NULL) {
+      return false;
+    }
+
+    if (config_.use_io_worker_affinity()) {
+      IOWorker* io_worker = owner_io_worker(host);
+      if (io_worker->is_host_available(host) &&
+          io_worker->execute(request_handler)) {
+        return true;
+      }
+      continue;
+    }
+
+    size_t start = current_io_worker_.fetch_add(1, MEMORY_ORDER_RELAXED);
+    for (size_t i = 0, size = io_workers_.size(); i < size; ++i) {
+      const SharedRefPtr<IOWorker>& io_worker = io_workers_[start % size];
+      if (io_worker->is_host_available(host) &&
+          io_worker->execute(request_handler)) {
+        return true;
+      }
+      start++;
+    }
+  }
+}
+
+QueryPlan* Session::new_query_plan(const Request* request, Request::EncodingCache* cache,
+                                   QueryPlanArena* arena) {
+  const CopyOnWritePtr<Keyspace> keyspace(keyspace_);
+  TokenMap::ConstPtr token_map(metadata_.token_map());
+  return load_balancing_policy_->new_query_plan(token_map->keyspace_id(keyspace->name,
+                                                                       keyspace->id_cache),
+                                                request, *token_map, cache, arena);
 }
 
 } // namespace cass
@@ -32,6 +32,7 @@
 #include "row.hpp"
 #include "scoped_lock.hpp"
 #include "scoped_ptr.hpp"
+#include "speculative_execution.hpp"
 
 #include <list>
 #include <memory>
@@ -42,6 +43,7 @@
 
 namespace cass {
 
+class BatchRequest;
 class RequestHandler;
 class Future;
 class IOWorker;
@@ -89,6 +91,14 @@ public:
 
   SharedRefPtr<Host> get_host(const Address& address);
 
+  // The IO worker that owns the host's pool when IO worker affinity is
+  // enabled. This can run on an IO worker thread.
+  IOWorker* owner_io_worker(const Host* host) const;
+
+  // Moves a request to the IO worker that owns its current host. This runs
+  // on an IO worker thread and fails if the session is closing.
+  bool transfer(RequestHandler* request_handler);
+
   bool notify_ready_async();
   bool notify_keyspace_error_async();
   bool notify_worker_closed_async();
@@ -100,6 +110,7 @@ public:
 
   Future* prepare(const char* statement, size_t length);
   Future* execute(const RoutableRequest* statement);
+  Future* execute_split(const BatchRequest* batch);
 
   const Metadata& metadata() const { return metadata_; }
 
@@ -153,7 +164,10 @@ private:
   static void on_execute(uv_async_t* data);
 #endif
 
-  QueryPlan* new_query_plan(const Request* request = NULL, Request::EncodingCache* cache = NULL);
+  bool dispatch(RequestHandler* request_handler);
+
+  QueryPlan* new_query_plan(const Request* request = NULL, Request::EncodingCache* cache = NULL,
+                            QueryPlanArena* arena = NULL);
 
   void on_reconnect(Timer* timer);
 
@@ -171,6 +185,7 @@ private:
 
   void on_add(SharedRefPtr<Host> host, bool is_initial_connection);
   void internal_on_add(SharedRefPtr<Host> host, bool is_initial_connection);
+  void add_pool_async(SharedRefPtr<Host> host, bool is_initial_connection);
 
   void on_remove(SharedRefPtr<Host> host);
   void on_up(SharedRefPtr<Host> host);
@@ -185,6 +200,11 @@ private:
   Config config_;
   ScopedPtr<Metrics> metrics_;
   ScopedRefPtr<LoadBalancingPolicy> load_balancing_policy_;
+  // Held for reading by threads dispatching requests directly (see
+  // Config::use_direct_dispatch()) and for writing when the load balancing
+  // policy, the keyspace or the session state (closing) changes.
+  uv_rwlock_t policy_rwlock_;
+  ScopedRefPtr<SpeculativeExecutionPolicy> speculative_execution_policy_;
   CassError connect_error_code_;
   std::string connect_error_message_;
   ScopedRefPtr<Future> connect_future_;
@@ -200,9 +220,20 @@ private:
   bool current_host_mark_;
   int pending_pool_count_;
   int pending_workers_count_;
-  int current_io_worker_;
+  Atomic<size_t> current_io_worker_;
+  size_t next_owner_io_worker_;
+
+  // The keyspace is replaced along with its cached id so a request never
+  // uses the id of another keyspace
+  struct Keyspace {
+    Keyspace(const std::string& name)
+      : name(name) { }
+
+    std::string name;
+    KeyspaceIdCache id_cache;
+  };
 
-  CopyOnWritePtr<std::string> keyspace_;
+  CopyOnWritePtr<Keyspace> keyspace_;
 };
 
 class SessionFuture : public Future {
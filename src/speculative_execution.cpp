@@ -0,0 +1,70 @@
+/*
+  Copyright (c) 2014-2016 DataStax
+
+  Licensed under the Apache License, Version 2.0 (the "License");
+  you may not use this file except in compliance with the License.
+  You may obtain a copy of the License at
+
+  http://www.apache.org/licenses/LICENSE-2.0
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+*/
+
+
+#include "speculative_execution.hpp"
+
+#include "metrics.hpp"
+
+#include <uv.h>
+
+namespace cass {
+
+int64_t ConstantSpeculativeExecutionPlan::next_execution() {
+  if (remaining_ <= 0) return -1;
+  remaining_--;
+  return constant_delay_ms_;
+}
+
+SpeculativeExecutionPlan* ConstantSpeculativeExecutionPolicy::new_plan(const Request* request) {
+  if (max_speculative_executions_ <= 0) return NULL;
+  return new ConstantSpeculativeExecutionPlan(constant_delay_ms_,
+                                              max_speculative_executions_);
+}
+
+SpeculativeExecutionPlan* PercentileSpeculativeExecutionPolicy::new_plan(const Request* request) {
+  if (max_speculative_executions_ <= 0) return NULL;
+
+  uint64_t now_ms = uv_hrtime() / (1000 * 1000);
+  uint64_t last_refresh_ms = last_refresh_ms_.load(MEMORY_ORDER_RELAXED);
+  // Plans can be created on several threads (direct dispatch) so only the
+  // thread that claims the refresh interval recalculates the delay.
+  if (now_ms - last_refresh_ms >= REFRESH_INTERVAL_MS &&
+      last_refresh_ms_.compare_exchange_strong(last_refresh_ms, now_ms)) {
+    refresh(now_ms);
+  }
+
+  int64_t delay_ms = delay_ms_.load(MEMORY_ORDER_RELAXED);
+  if (delay_ms < 0) return NULL;
+  return new ConstantSpeculativeExecutionPlan(delay_ms,
+                                              max_speculative_executions_);
+}
+
+void PercentileSpeculativeExecutionPolicy::refresh(uint64_t now_ms) {
+  last_refresh_ms_.store(now_ms, MEMORY_ORDER_RELAXED);
+  if (metrics_ == NULL) return;
+
+  // Latencies are recorded in microseconds. The previous delay is kept until
+  // enough requests have completed since the last refresh.
+  int64_t latency_us
+      = metrics_->request_latencies.interval_value_at_percentile(percentile_,
+                                                                 MIN_RECORDED_REQUESTS);
+  if (latency_us > 0) {
+    delay_ms_.store((latency_us + 999) / 1000, MEMORY_ORDER_RELAXED);
+  }
+}
+
+} // namespace cass
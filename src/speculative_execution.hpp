@@ -0,0 +1,148 @@
+/*
+  Copyright (c) 2014-2016 DataStax
+
+  Licensed under the Apache License, Version 2.0 (the "License");
+  you may not use this file except in compliance with the License.
+  You may obtain a copy of the License at
+
+  http://www.apache.org/licenses/LICENSE-2.0
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+*/
+
+#ifndef __CASS_SPECULATIVE_EXECUTION_HPP_INCLUDED__
+#define __CASS_SPECULATIVE_EXECUTION_HPP_INCLUDED__
+
+#include "atomic.hpp"
+#include "macros.hpp"
+#include "ref_counted.hpp"
+
+#include <stdint.h>
+
+namespace cass {
+
+class Metrics;
+class Request;
+
+class SpeculativeExecutionPlan {
+public:
+  virtual ~SpeculativeExecutionPlan() { }
+
+  // Returns the delay (in milliseconds) before the next speculative
+  // execution should be started or a negative value if no more speculative
+  // executions should be started.
+  virtual int64_t next_execution() = 0;
+};
+
+// A speculative execution sends an additional copy of a request to the next
+// host in the query plan when the previous attempt hasn't answered within a
+// delay. The first response completes the request. Only used for requests
+// marked as idempotent.
+class SpeculativeExecutionPolicy : public RefCounted<SpeculativeExecutionPolicy> {
+public:
+  virtual ~SpeculativeExecutionPolicy() { }
+
+  virtual void init(const Metrics* metrics) { }
+
+  // Returns false if the policy never starts speculative executions
+  virtual bool is_enabled() const { return true; }
+
+  // Returns NULL if the request should not be speculatively executed
+  virtual SpeculativeExecutionPlan* new_plan(const Request* request) = 0;
+
+  virtual SpeculativeExecutionPolicy* new_instance() = 0;
+};
+
+class NoSpeculativeExecutionPolicy : public SpeculativeExecutionPolicy {
+public:
+  virtual bool is_enabled() const { return false; }
+
+  virtual SpeculativeExecutionPlan* new_plan(const Request* request) {
+    return NULL;
+  }
+
+  virtual SpeculativeExecutionPolicy* new_instance() {
+    return new NoSpeculativeExecutionPolicy();
+  }
+};
+
+class ConstantSpeculativeExecutionPlan : public SpeculativeExecutionPlan {
+public:
+  ConstantSpeculativeExecutionPlan(int64_t constant_delay_ms,
+                                   int max_speculative_executions)
+    : constant_delay_ms_(constant_delay_ms)
+    , remaining_(max_speculative_executions) { }
+
+  virtual int64_t next_execution();
+
+private:
+  const int64_t constant_delay_ms_;
+  int remaining_;
+};
+
+class ConstantSpeculativeExecutionPolicy : public SpeculativeExecutionPolicy {
+public:
+  ConstantSpeculativeExecutionPolicy(int64_t constant_delay_ms,
+                                     int max_speculative_executions)
+    : constant_delay_ms_(constant_delay_ms)
+    , max_speculative_executions_(max_speculative_executions) { }
+
+  virtual SpeculativeExecutionPlan* new_plan(const Request* request);
+
+  virtual SpeculativeExecutionPolicy* new_instance() {
+    return new ConstantSpeculativeExecutionPolicy(constant_delay_ms_,
+                                                  max_speculative_executions_);
+  }
+
+private:
+  const int64_t constant_delay_ms_;
+  const int max_speculative_executions_;
+};
+
+// Uses a percentile of the session's recent request latencies as the delay.
+// The percentile is recalculated at most every REFRESH_INTERVAL_MS from the
+// requests completed since the last recalculation, once at least
+// MIN_RECORDED_REQUESTS of them have completed. No speculative executions
+// are started before the first delay is known.
+class PercentileSpeculativeExecutionPolicy : public SpeculativeExecutionPolicy {
+public:
+  static const uint64_t REFRESH_INTERVAL_MS = 1000;
+  static const int64_t MIN_RECORDED_REQUESTS = 100;
+
+  PercentileSpeculativeExecutionPolicy(double percentile,
+                                       int max_speculative_executions)
+    : percentile_(percentile)
+    , max_speculative_executions_(max_speculative_executions)
+    , metrics_(NULL)
+    , delay_ms_(-1)
+    , last_refresh_ms_(0) { }
+
+  virtual void init(const Metrics* metrics) { metrics_ = metrics; }
+
+  virtual SpeculativeExecutionPlan* new_plan(const Request* request);
+
+  virtual SpeculativeExecutionPolicy* new_instance() {
+    return new PercentileSpeculativeExecutionPolicy(percentile_,
+                                                    max_speculative_executions_);
+  }
+
+  int64_t delay_ms() const { return delay_ms_.load(MEMORY_ORDER_RELAXED); }
+
+  // Recalculates the delay from the current request latencies
+  void refresh(uint64_t now_ms);
+
+private:
+  const double percentile_;
+  const int max_speculative_executions_;
+  const Metrics* metrics_;
+  Atomic<int64_t> delay_ms_;
+  Atomic<uint64_t> last_refresh_ms_;
+};
+
+} // namespace cass
+
+#endif
@@ -24,8 +24,11 @@
 #include "query_request.hpp"
 #include "scoped_ptr.hpp"
 #include "string_ref.hpp"
+#include "token_map.hpp"
 #include "user_type_value.hpp"
 
+#include <algorithm>
+
 #include <uv.h>
 
 extern "C" {
@@ -56,6 +59,16 @@ CassError cass_statement_add_key_index(CassStatement* statement, size_t index) {
   return CASS_OK;
 }
 
+CassError cass_statement_routing_token(const CassStatement* statement,
+                                       cass_int64_t* token) {
+  int64_t routing_token;
+  if (!statement->get_routing_token(&routing_token)) {
+    return CASS_ERROR_LIB_PARAMETER_UNSET;
+  }
+  *token = routing_token;
+  return CASS_OK;
+}
+
 CassError cass_statement_set_keyspace(CassStatement* statement, const char* keyspace) {
   return cass_statement_set_keyspace_n(statement, keyspace, strlen(keyspace));
 }
@@ -109,6 +122,12 @@ CassError cass_statement_set_retry_policy(CassStatement* statement,
   return CASS_OK;
 }
 
+CassError cass_statement_set_is_idempotent(CassStatement* statement,
+                                           cass_bool_t is_idempotent) {
+  statement->set_is_idempotent(is_idempotent == cass_true);
+  return CASS_OK;
+}
+
 CassError cass_statement_set_timestamp(CassStatement* statement,
                                        cass_int64_t timestamp)  {
   statement->set_timestamp(timestamp);
@@ -254,7 +273,76 @@ int32_t Statement::copy_buffers(int version, BufferVec* bufs, Handler* handler)
   return size;
 }
 
-bool Statement::get_routing_key(std::string* routing_key, EncodingCache* cache)  const {
+bool Statement::get_routing_key(std::string* routing_key, EncodingCache* cache) const {
+  if (routing_key_state_.load(MEMORY_ORDER_ACQUIRE) == ROUTING_KEY_CACHED) {
+    *routing_key = routing_key_;
+    return true;
+  }
+  return build_routing_key(routing_key, cache);
+}
+
+bool Statement::get_routing_token(int64_t* token) const {
+  if (routing_key_state_.load(MEMORY_ORDER_ACQUIRE) == ROUTING_KEY_CACHED) {
+    *token = routing_token_;
+    return true;
+  }
+
+  if (!is_routing_key_cacheable()) return false;
+
+  std::string routing_key;
+  EncodingCache cache;
+  if (!build_routing_key(&routing_key, &cache)) return false;
+  *token = Murmur3Partitioner::hash_int64(
+             reinterpret_cast<const uint8_t*>(routing_key.data()),
+             routing_key.size());
+
+  // The same statement can be executed from several threads at once so only
+  // the thread that claims the cache fills it in
+  int expected = ROUTING_KEY_NOT_CACHED;
+  if (routing_key_state_.compare_exchange_strong(expected, ROUTING_KEY_CACHING)) {
+    routing_key_.swap(routing_key);
+    routing_token_ = *token;
+    routing_key_state_.store(ROUTING_KEY_CACHED, MEMORY_ORDER_RELEASE);
+  }
+  return true;
+}
+
+bool Statement::has_routing_key() const {
+  if (key_indices_.empty()) return false;
+  for (std::vector<size_t>::const_iterator i = key_indices_.begin();
+       i != key_indices_.end(); ++i) {
+    if (*i >= elements_count()) return false;
+    const AbstractData::Element& element(elements()[*i]);
+    if (element.is_unset() || element.is_null()) return false;
+  }
+  return true;
+}
+
+void Statement::on_element_set(size_t index) {
+  if (std::find(key_indices_.begin(), key_indices_.end(), index) != key_indices_.end()) {
+    invalidate_routing_key();
+  }
+}
+
+void Statement::on_elements_reset() {
+  invalidate_routing_key();
+}
+
+bool Statement::is_routing_key_cacheable() const {
+  // Collections can be modified after they're bound so they're encoded when
+  // the statement is executed
+  for (std::vector<size_t>::const_iterator i = key_indices_.begin();
+       i != key_indices_.end(); ++i) {
+    if (*i >= elements_count() || elements()[*i].is_collection()) return false;
+  }
+  return true;
+}
+
+void Statement::invalidate_routing_key() {
+  routing_key_state_.store(ROUTING_KEY_NOT_CACHED, MEMORY_ORDER_RELAXED);
+}
+
+bool Statement::build_routing_key(std::string* routing_key, EncodingCache* cache) const {
   if (key_indices_.empty()) return false;
 
   if (key_indices_.size() == 1) {
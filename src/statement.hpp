@@ -18,6 +18,7 @@
 #define __CASS_STATEMENT_HPP_INCLUDED__
 
 #include "abstract_data.hpp"
+#include "atomic.hpp"
 #include "constants.hpp"
 #include "macros.hpp"
 #include "request.hpp"
@@ -39,7 +40,9 @@ public:
       , AbstractData(values_count)
       , flags_(0)
       , page_size_(-1)
-      , kind_(kind) { }
+      , kind_(kind)
+      , routing_key_state_(ROUTING_KEY_NOT_CACHED)
+      , routing_token_(0) { }
 
   Statement(uint8_t opcode, uint8_t kind, size_t values_count,
             const std::vector<size_t>& key_indices,
@@ -49,7 +52,9 @@ public:
       , flags_(0)
       , page_size_(-1)
       , kind_(kind)
-      , key_indices_(key_indices) { }
+      , key_indices_(key_indices)
+      , routing_key_state_(ROUTING_KEY_NOT_CACHED)
+      , routing_token_(0) { }
 
   virtual ~Statement() { }
 
@@ -91,21 +96,48 @@ public:
 
   uint8_t kind() const { return kind_; }
 
-  void add_key_index(size_t index) { key_indices_.push_back(index); }
+  void add_key_index(size_t index) {
+    key_indices_.push_back(index);
+    invalidate_routing_key();
+  }
 
   virtual bool get_routing_key(std::string* routing_key, EncodingCache* cache) const;
+  virtual bool get_routing_token(int64_t* token) const;
+
+  // Returns true if all of the key columns are bound to non-null values
+  bool has_routing_key() const;
 
   virtual int32_t encode_batch(int version, BufferVec* bufs, Handler* handler) const = 0;
 
 protected:
   int32_t copy_buffers(int version, BufferVec* bufs, Handler* handler) const;
 
+  virtual void on_element_set(size_t index);
+  virtual void on_elements_reset();
+
+private:
+  enum RoutingKeyState {
+    ROUTING_KEY_NOT_CACHED,
+    ROUTING_KEY_CACHING,
+    ROUTING_KEY_CACHED
+  };
+
+  bool is_routing_key_cacheable() const;
+  bool build_routing_key(std::string* routing_key, EncodingCache* cache) const;
+  void invalidate_routing_key();
+
 private:
   uint8_t flags_;
   int32_t page_size_;
   std::string paging_state_;
   uint8_t kind_;
   std::vector<size_t> key_indices_;
+  // The routing key and its Murmur3 token are computed the first time the
+  // token is requested and cached until a key column is rebound, so
+  // re-executing the statement doesn't rebuild and re-hash the key
+  mutable Atomic<int> routing_key_state_;
+  mutable std::string routing_key_;
+  mutable int64_t routing_token_;
 
 private:
   DISALLOW_COPY_AND_ASSIGN(Statement);
@@ -24,69 +24,66 @@
 #include <stdint.h>
 #include <string.h>
 
-#ifdef CASS_USE_SPARSEHASH
-#include <google/dense_hash_map>
-#else
-#include <map>
-#endif
-
 #if defined(_MSC_VER)
 #include <intrin.h>
 #endif
 
 namespace cass {
 
+// Pending items are stored in a table directly indexed by stream ID. The
+// table is split into pages that are only allocated once a stream in that
+// range is used, so connections that never have many requests in flight don't
+// pay for all 32768 slots of protocol v3+. Whether a stream is in use is
+// tracked by the bitmap used to find free streams.
 template <class T>
 class StreamManager {
 public:
   StreamManager(int protocol_version)
       : max_streams_(static_cast<size_t>(1) << (num_bytes_for_stream(protocol_version) * 8 - 1))
       , num_words_(max_streams_ / NUM_BITS_PER_WORD)
+      , num_pages_((max_streams_ + NUM_SLOTS_PER_PAGE - 1) / NUM_SLOTS_PER_PAGE)
       , offset_(0)
-      , words_(new word_t[num_words_]) {
-#ifdef CASS_USE_SPARSEHASH
-    // Client request stream IDs are always positive values so it's
-    // safe to use negative values for the empty and deleted keys.
-    pending_.set_empty_key(-1);
-    pending_.set_deleted_key(-2);
-#endif
+      , pending_count_(0)
+      , words_(new word_t[num_words_])
+      , pages_(new ScopedPtr<T[]>[num_pages_]) {
     memset(words_.get(), 0xFF, sizeof(word_t) * num_words_);
   }
 
   int acquire(const T& item) {
     int stream = acquire_stream();
     if (stream < 0) return -1;
-    pending_[stream] = item;
+    slot(stream) = item;
+    ++pending_count_;
     return stream;
   }
 
   void release(int stream) {
     assert(stream >= 0 && static_cast<size_t>(stream) < max_streams_);
-    pending_.erase(stream);
+    assert(is_pending(stream));
+    slot(stream) = T();
+    --pending_count_;
     release_stream(stream);
   }
 
   bool get_pending_and_release(int stream, T& output) {
-    typename PendingMap::iterator i = pending_.find(stream);
-    if (i != pending_.end()) {
-      output = i->second;
-      pending_.erase(i);
-      release_stream(stream);
-      return true;
+    if (stream < 0 || static_cast<size_t>(stream) >= max_streams_ ||
+        !is_pending(stream)) {
+      return false;
     }
-    return false;
+    T& item = slot(stream);
+    output = item;
+    item = T();
+    --pending_count_;
+    release_stream(stream);
+    return true;
   }
 
-  size_t available_streams() const { return max_streams_ - pending_.size(); }
-  size_t pending_streams() const { return pending_.size(); }
+  size_t available_streams() const { return max_streams_ - pending_count_; }
+  size_t pending_streams() const { return pending_count_; }
   size_t max_streams() const { return max_streams_; }
 
 private:
-#ifdef CASS_USE_SPARSEHASH
-  typedef google::dense_hash_map<int, T> PendingMap;
-#else
-  typedef std::map<int, T> PendingMap;
-#endif
+  static const size_t NUM_SLOTS_PER_PAGE = 1024;
 
 #if defined(_MSC_VER) && defined(_M_AMD64)
   typedef __int64 word_t;
@@ -136,6 +133,18 @@ private:
     return -1;
   }
 
+  inline bool is_pending(int stream) const {
+    return (words_[stream / NUM_BITS_PER_WORD] & (static_cast<word_t>(1) << (stream % NUM_BITS_PER_WORD))) == 0;
+  }
+
+  inline T& slot(int stream) {
+    ScopedPtr<T[]>& page = pages_[stream / NUM_SLOTS_PER_PAGE];
+    if (!page) {
+      page.reset(new T[max_streams_ < NUM_SLOTS_PER_PAGE ? max_streams_ : NUM_SLOTS_PER_PAGE]());
+    }
+    return page[stream % NUM_SLOTS_PER_PAGE];
+  }
+
   inline void release_stream(int stream) {
     assert((words_[stream / NUM_BITS_PER_WORD] & (static_cast<word_t>(1) << (stream % NUM_BITS_PER_WORD))) == 0);
     words_[stream / NUM_BITS_PER_WORD] |=
@@ -153,9 +162,11 @@ private:
 private:
   const size_t max_streams_;
   const size_t num_words_;
+  const size_t num_pages_;
   size_t offset_;
+  size_t pending_count_;
   ScopedPtr<word_t[]> words_;
-  PendingMap pending_;
+  ScopedPtr<ScopedPtr<T[]>[]> pages_;
 
 private:
   DISALLOW_COPY_AND_ASSIGN(StreamManager);
@@ -0,0 +1,231 @@
+/*
+  Copyright (c) 2014-2016 DataStax
+
+  Licensed under the Apache License, Version 2.0 (the "License");
+  you may not use this file except in compliance with the License.
+  You may obtain a copy of the License at
+
+  http://www.apache.org/licenses/LICENSE-2.0
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+*/
+
+
+#include "timer_wheel.hpp"
+
+#include "constants.hpp"
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+#define SLOT_MASK (TimerWheel::NUM_SLOTS - 1)
+
+namespace cass {
+
+static inline int count_trailing_zeros(uint64_t word) {
+#if defined(__GNUC__)
+  return __builtin_ctzll(word);
+#elif defined(_MSC_VER)
+  unsigned long index;
+#  if defined(_M_AMD64)
+  _BitScanForward64(&index, word);
+#  else
+  if (_BitScanForward(&index, static_cast<unsigned long>(word)) == 0) {
+    _BitScanForward(&index, static_cast<unsigned long>(word >> 32));
+    index += 32;
+  }
+#  endif
+  return static_cast<int>(index);
+#else
+  int count = 0;
+  while ((word & 1) == 0) {
+    word >>= 1;
+    ++count;
+  }
+  return count;
+#endif
+}
+
+TimerWheel::TimerWheel()
+  : loop_(NULL)
+  , current_(0)
+  , count_(0)
+  , scheduled_(0) {
+  for (int level = 0; level < NUM_LEVELS; ++level) {
+    for (int index = 0; index < NUM_SLOTS; ++index) {
+      slots_[level][index] = NULL;
+    }
+    occupied_[level] = 0;
+  }
+}
+
+void TimerWheel::init(uv_loop_t* loop) {
+  loop_ = loop;
+  current_ = uv_now(loop);
+}
+
+void TimerWheel::close_handles() {
+  timer_.stop();
+}
+
+void TimerWheel::advance(uint64_t now) {
+  while (count_ > 0) {
+    uint64_t tick = next_event();
+    if (tick > now) break;
+    process(tick);
+  }
+  // There are no events before "now" so it's safe to skip ahead
+  if (now > current_) {
+    current_ = now;
+  }
+}
+
+void TimerWheel::add(Entry* entry, uint64_t timeout) {
+  uint64_t now = uv_now(loop_);
+  if (count_ == 0 && now > current_) {
+    current_ = now;
+  }
+  entry->wheel_ = this;
+  entry->expires_ = now + timeout;
+  link(entry);
+  count_++;
+  schedule();
+}
+
+void TimerWheel::remove(Entry* entry) {
+  // The libuv timer is left running (if it is) because it's likely to be
+  // needed again soon. It's stopped the next time it fires with an empty
+  // wheel.
+  unlink(entry);
+  entry->wheel_ = NULL;
+  count_--;
+}
+
+void TimerWheel::link(Entry* entry) {
+  // Entries are placed by how far in the future they expire. Each level
+  // covers 64 times the range of the level below it.
+  uint64_t expires = entry->expires_;
+  if (expires <= current_) {
+    expires = current_ + 1;
+  } else if (expires - current_ > MAX_TIMEOUT) {
+    expires = current_ + MAX_TIMEOUT;
+  }
+
+  uint64_t delta = expires - current_;
+  int level = 0;
+  while (level < NUM_LEVELS - 1 &&
+         delta >= (1ULL << ((level + 1) * NUM_SLOT_BITS))) {
+    ++level;
+  }
+  int index = static_cast<int>((expires >> (level * NUM_SLOT_BITS)) & SLOT_MASK);
+  link(entry, level, index);
+}
+
+void TimerWheel::link(Entry* entry, int level, int index) {
+  Entry*& head = slots_[level][index];
+  entry->level_ = level;
+  entry->index_ = index;
+  entry->prev_ = NULL;
+  entry->next_ = head;
+  if (head != NULL) {
+    head->prev_ = entry;
+  }
+  head = entry;
+  occupied_[level] |= (1ULL << index);
+}
+
+void TimerWheel::unlink(Entry* entry) {
+  Entry*& head = slots_[entry->level_][entry->index_];
+  if (entry->prev_ != NULL) {
+    entry->prev_->next_ = entry->next_;
+  } else {
+    head = entry->next_;
+  }
+  if (entry->next_ != NULL) {
+    entry->next_->prev_ = entry->prev_;
+  }
+  if (head == NULL) {
+    occupied_[entry->level_] &= ~(1ULL << entry->index_);
+  }
+  entry->next_ = NULL;
+  entry->prev_ = NULL;
+}
+
+uint64_t TimerWheel::next_event() const {
+  // The next event is either the expiration of the next occupied slot on the
+  // lowest level or the time when an occupied slot on a higher level needs to
+  // be moved down (the start of the slot's range).
+  uint64_t next = CASS_UINT64_MAX;
+  for (int level = 0; level < NUM_LEVELS; ++level) {
+    uint64_t occupied = occupied_[level];
+    if (occupied == 0) continue;
+
+    int shift = level * NUM_SLOT_BITS;
+    uint64_t base = current_ >> shift;
+
+    // Rotate so that the slot after the current slot is the lowest bit
+    int rotate = static_cast<int>((base + 1) & SLOT_MASK);
+    if (rotate != 0) {
+      occupied = (occupied >> rotate) | (occupied << (NUM_SLOTS - rotate));
+    }
+    uint64_t tick = (base + 1 + count_trailing_zeros(occupied)) << shift;
+    if (tick < next) {
+      next = tick;
+    }
+  }
+  return next;
+}
+
+void TimerWheel::process(uint64_t tick) {
+  current_ = tick;
+
+  // Move down the entries from higher level slots that start at this tick
+  for (int level = NUM_LEVELS - 1; level > 0; --level) {
+    int shift = level * NUM_SLOT_BITS;
+    if ((tick & ((1ULL << shift) - 1)) != 0) continue;
+    int index = static_cast<int>((tick >> shift) & SLOT_MASK);
+    Entry* entry;
+    while ((entry = slots_[level][index]) != NULL) {
+      unlink(entry);
+      if (entry->expires_ <= tick) {
+        // Expires now, put it in the slot that's about to be processed
+        link(entry, 0, static_cast<int>(tick & SLOT_MASK));
+      } else {
+        link(entry);
+      }
+    }
+  }
+
+  Entry* entry;
+  int index = static_cast<int>(tick & SLOT_MASK);
+  while ((entry = slots_[0][index]) != NULL) {
+    unlink(entry);
+    entry->wheel_ = NULL;
+    count_--;
+    entry->cb_(entry);
+  }
+}
+
+void TimerWheel::schedule() {
+  if (count_ == 0) return;
+
+  uint64_t next = next_event();
+  if (timer_.is_running() && scheduled_ <= next) return;
+
+  uint64_t now = uv_now(loop_);
+  scheduled_ = next;
+  timer_.start(loop_, next > now ? next - now : 0, this, on_timeout);
+}
+
+void TimerWheel::on_timeout(Timer* timer) {
+  TimerWheel* wheel = static_cast<TimerWheel*>(timer->data());
+  wheel->advance(uv_now(wheel->loop_));
+  wheel->schedule();
+}
+
+} // namespace cass
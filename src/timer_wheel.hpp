@@ -0,0 +1,139 @@
+/*
+  Copyright (c) 2014-2016 DataStax
+
+  Licensed under the Apache License, Version 2.0 (the "License");
+  you may not use this file except in compliance with the License.
+  You may obtain a copy of the License at
+
+  http://www.apache.org/licenses/LICENSE-2.0
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+*/
+
+
+#ifndef __CASS_TIMER_WHEEL_HPP_INCLUDED__
+#define __CASS_TIMER_WHEEL_HPP_INCLUDED__
+
+#include "macros.hpp"
+#include "timer.hpp"
+
+#include <stdint.h>
+#include <uv.h>
+
+namespace cass {
+
+// A hierarchical timing wheel (4 levels of 64 slots with a 1 millisecond
+// tick) for timers that are started and stopped at a high rate, like request
+// timeouts. Starting and stopping an entry is O(1) and doesn't allocate. A
+// single libuv timer is only armed for the next occupied slot. Entries are
+// moved down to lower levels as their expiration gets closer. Timeouts longer
+// than the wheel's range (about 4.6 hours) are re-inserted until they expire
+// and a timeout of zero expires on the next tick.
+//
+// A wheel, and all of its entries, can only be used on the loop's thread.
+class TimerWheel {
+public:
+  static const int NUM_LEVELS = 4;
+  static const int NUM_SLOT_BITS = 6;
+  static const int NUM_SLOTS = 1 << NUM_SLOT_BITS;
+  static const uint64_t MAX_TIMEOUT = (1ULL << (NUM_LEVELS * NUM_SLOT_BITS)) - 1;
+
+  class Entry {
+  public:
+    typedef void (*Callback)(Entry*);
+
+    Entry()
+      : wheel_(NULL)
+      , next_(NULL)
+      , prev_(NULL)
+      , expires_(0)
+      , level_(0)
+      , index_(0)
+      , data_(NULL)
+      , cb_(NULL) { }
+
+    ~Entry() {
+      stop();
+    }
+
+    void* data() const { return data_; }
+
+    bool is_running() const { return wheel_ != NULL; }
+
+    void start(TimerWheel* wheel, uint64_t timeout, void* data,
+               Callback cb) {
+      stop();
+      data_ = data;
+      cb_ = cb;
+      wheel->add(this, timeout);
+    }
+
+    void stop() {
+      if (wheel_ != NULL) {
+        wheel_->remove(this);
+      }
+    }
+
+  private:
+    friend class TimerWheel;
+
+    TimerWheel* wheel_;
+    Entry* next_;
+    Entry* prev_;
+    uint64_t expires_;
+    int level_;
+    int index_;
+    void* data_;
+    Callback cb_;
+
+  private:
+    DISALLOW_COPY_AND_ASSIGN(Entry);
+  };
+
+  TimerWheel();
+
+  void init(uv_loop_t* loop);
+
+  // Stops the wheel's libuv timer so that the loop can exit
+  void close_handles();
+
+  size_t size() const { return count_; }
+
+  // Expires all entries with a deadline up to and including "now" (loop time
+  // in milliseconds). This is normally called by the wheel's libuv timer.
+  void advance(uint64_t now);
+
+private:
+  void add(Entry* entry, uint64_t timeout);
+  void remove(Entry* entry);
+
+  void link(Entry* entry);
+  void link(Entry* entry, int level, int index);
+  void unlink(Entry* entry);
+
+  uint64_t next_event() const;
+  void process(uint64_t tick);
+  void schedule();
+
+  static void on_timeout(Timer* timer);
+
+private:
+  uv_loop_t* loop_;
+  uint64_t current_;
+  Entry* slots_[NUM_LEVELS][NUM_SLOTS];
+  uint64_t occupied_[NUM_LEVELS];
+  size_t count_;
+  Timer timer_;
+  uint64_t scheduled_;
+
+private:
+  DISALLOW_COPY_AND_ASSIGN(TimerWheel);
+};
+
+} // namespace cass
+
+#endif
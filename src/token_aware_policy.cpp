@@ -20,20 +20,22 @@ namespace cass {
 
 // The number of replicas is bounded by replication factor per DC. In practice, the number
 // of replicas is fairly small so a linear search should be extremely fast.
-static inline bool contains(const CopyOnWriteHostVec& replicas, const Address& address) {
+static inline const SharedRefPtr<Host>* find_replica(const CopyOnWriteHostVec& replicas,
+                                                     const Address& address) {
   for (HostVec::const_iterator i = replicas->begin(),
        end = replicas->end(); i != end; ++i) {
     if ((*i)->address() == address) {
-      return true;
+      return &(*i);
     }
   }
-  return false;
+  return NULL;
 }
 
-QueryPlan* TokenAwarePolicy::new_query_plan(const std::string& connected_keyspace,
+QueryPlan* TokenAwarePolicy::new_query_plan(KeyspaceId connected_keyspace_id,
                                             const Request* request,
                                             const TokenMap& token_map,
-                                            Request::EncodingCache* cache) {
+                                            Request::EncodingCache* cache,
+                                            QueryPlanArena* arena) {
   if (request != NULL) {
     switch (request->opcode()) {
       {
@@ -41,18 +43,27 @@ QueryPlan* TokenAwarePolicy::new_query_plan(const std::string& connected_keyspac
       case CQL_OPCODE_EXECUTE:
       case CQL_OPCODE_BATCH:
         const RoutableRequest* rr = static_cast<const RoutableRequest*>(request);
-        const std::string& statement_keyspace = rr->keyspace();
-        const std::string& keyspace = statement_keyspace.empty()
-                                      ? connected_keyspace : statement_keyspace;
+        const KeyspaceId keyspace_id = rr->keyspace().empty()
+                                       ? connected_keyspace_id
+                                       : token_map.keyspace_id(rr->keyspace(), rr->keyspace_id_cache());
+        if (keyspace_id == INVALID_KEYSPACE_ID) break;
+
+        // Statements cache their routing token once their key is bound so
+        // the routing key doesn't need to be rebuilt and re-hashed
+        const CopyOnWriteHostVec* replicas = NULL;
+        int64_t token;
         std::string routing_key;
-        if (rr->get_routing_key(&routing_key, cache) && !keyspace.empty()) {
-          CopyOnWriteHostVec replicas = token_map.get_replicas(keyspace, routing_key);
-          if (!replicas->empty()) {
-            return new TokenAwareQueryPlan(child_policy_.get(),
-                                           child_policy_->new_query_plan(connected_keyspace, request, token_map, cache),
-                                           replicas,
-                                           index_++);
-          }
+        if (token_map.has_int64_tokens() && rr->get_routing_token(&token)) {
+          replicas = &token_map.get_replicas(keyspace_id, token);
+        } else if (rr->get_routing_key(&routing_key, cache)) {
+          replicas = &token_map.get_replicas(keyspace_id, routing_key);
+        }
+        if (replicas != NULL && !(*replicas)->empty()) {
+          return new (arena) TokenAwareQueryPlan(child_policy_.get(),
+                                                 child_policy_->new_query_plan(connected_keyspace_id, request,
+                                                                               token_map, cache, arena),
+                                                 *replicas,
+                                                 index_.fetch_add(1, MEMORY_ORDER_RELAXED));
         }
         break;
       }
@@ -61,26 +72,33 @@ QueryPlan* TokenAwarePolicy::new_query_plan(const std::string& connected_keyspac
         break;
     }
   }
-  return child_policy_->new_query_plan(connected_keyspace, request, token_map, cache);
+  return child_policy_->new_query_plan(connected_keyspace_id, request, token_map, cache, arena);
 }
 
-SharedRefPtr<Host> TokenAwarePolicy::TokenAwareQueryPlan::compute_next()  {
+Host* TokenAwarePolicy::TokenAwareQueryPlan::compute_next()  {
   while (remaining_ > 0) {
     --remaining_;
     const SharedRefPtr<Host>& host((*replicas_)[index_++ % replicas_->size()]);
     if (host->is_up() && child_policy_->distance(host) == CASS_HOST_DISTANCE_LOCAL) {
-      return host;
+      return host.get();
     }
   }
 
-  SharedRefPtr<Host> host;
-  while ((host = child_plan_->compute_next())) {
-    if (!contains(replicas_, host->address()) ||
-        child_policy_->distance(host) != CASS_HOST_DISTANCE_LOCAL) {
+  Host* host;
+  while ((host = child_plan_->compute_next()) != NULL) {
+    const SharedRefPtr<Host>* replica = find_replica(replicas_, host->address());
+    if (replica == NULL ||
+        child_policy_->distance(*replica) != CASS_HOST_DISTANCE_LOCAL) {
       return host;
     }
   }
-  return SharedRefPtr<Host>();
+  return NULL;
+}
+
+bool TokenAwarePolicy::TokenAwareQueryPlan::is_replica(const Host* host) const {
+  const SharedRefPtr<Host>* replica = find_replica(replicas_, host->address());
+  return replica != NULL &&
+      child_policy_->distance(*replica) == CASS_HOST_DISTANCE_LOCAL;
 }
 
 } // namespace cass
@@ -17,6 +17,7 @@
 #ifndef __CASS_TOKEN_AWARE_POLICY_HPP_INCLUDED__
 #define __CASS_TOKEN_AWARE_POLICY_HPP_INCLUDED__
 
+#include "atomic.hpp"
 #include "token_map.hpp"
 #include "load_balancing.hpp"
 #include "host.hpp"
@@ -32,10 +33,11 @@ public:
 
   virtual ~TokenAwarePolicy() {}
 
-  virtual QueryPlan* new_query_plan(const std::string& connected_keyspace,
+  virtual QueryPlan* new_query_plan(KeyspaceId connected_keyspace_id,
                                     const Request* request,
                                     const TokenMap& token_map,
-                                    Request::EncodingCache* cache);
+                                    Request::EncodingCache* cache,
+                                    QueryPlanArena* arena);
 
   LoadBalancingPolicy* new_instance() { return new TokenAwarePolicy(child_policy_->new_instance()); }
 
@@ -49,7 +51,8 @@ private:
       , index_(start_index)
       , remaining_(replicas->size()) {}
 
-    SharedRefPtr<Host> compute_next();
+    Host* compute_next();
+    bool is_replica(const Host* host) const;
 
   private:
     LoadBalancingPolicy* child_policy_;
@@ -59,7 +62,7 @@ private:
     size_t remaining_;
   };
 
-  size_t index_;
+  Atomic<size_t> index_;
 
 private:
   DISALLOW_COPY_AND_ASSIGN(TokenAwarePolicy);
@@ -26,6 +26,7 @@
 #include <uv.h>
 
 #include <algorithm>
+#include <set>
 #include <string>
 
 namespace cass {
@@ -94,10 +95,53 @@ static void parse_int128(const char* p, size_t n, uint8_t* output) {
   encode_uint64(output + sizeof(uint64_t), lo);
 }
 
+static bool entry_token_less(const std::pair<int64_t, CopyOnWriteHostVec>& lhs,
+                             const std::pair<int64_t, CopyOnWriteHostVec>& rhs) {
+  return lhs.first < rhs.first;
+}
+
+size_t Int64TokenReplicaMap::fill(const EntryVec& sorted, size_t i, size_t k) {
+  if (k < tokens_.size()) {
+    i = fill(sorted, i, 2 * k);
+    tokens_[k] = sorted[i].first;
+    replicas_[k] = sorted[i].second;
+    if (i == 0) first_ = k;
+    i = fill(sorted, i + 1, 2 * k + 1);
+  }
+  return i;
+}
+
+void Int64TokenReplicaMap::build(const TokenReplicaMap& replicas) {
+  EntryVec sorted;
+  sorted.reserve(replicas.size());
+  for (TokenReplicaMap::const_iterator i = replicas.begin(),
+       end = replicas.end(); i != end; ++i) {
+    sorted.push_back(Entry(Murmur3Partitioner::to_int64(i->first), i->second));
+  }
+  // The byte encoding orders the minimum token last
+  std::sort(sorted.begin(), sorted.end(), entry_token_less);
+
+  clear();
+  if (sorted.empty()) return;
+  tokens_.resize(sorted.size() + 1);
+  replicas_.resize(sorted.size() + 1, NO_REPLICAS);
+  fill(sorted, 0, 1);
+}
+
+void Int64TokenReplicaMap::clear() {
+  tokens_.clear();
+  replicas_.clear();
+  first_ = 0;
+}
+
 void TokenMap::clear() {
   mapped_addresses_.clear();
   token_map_.clear();
-  keyspace_replica_map_.clear();
+  keyspace_replicas_.clear();
+  keyspace_ids_ = CopyOnWritePtr<KeyspaceIds>(new KeyspaceIds());
+  is_built_ = false;
+  racks_.clear();
+  replica_sets_.clear();
   keyspace_strategy_map_.clear();
 }
 
@@ -110,16 +154,25 @@ void TokenMap::build() {
   map_replicas(true);
 }
 
+TokenMap::ConstPtr TokenMap::snapshot() const {
+  SharedRefPtr<TokenMap> snapshot(new TokenMap());
+  snapshot->is_built_ = is_built_;
+  snapshot->keyspace_replicas_ = keyspace_replicas_;
+  snapshot->keyspace_ids_ = keyspace_ids_;
+  snapshot->partitioner_ = partitioner_;
+  return snapshot;
+}
+
 void TokenMap::set_partitioner(const std::string& partitioner_class) {
   // Only set the partition once
   if (partitioner_) return;
 
   if (ends_with(partitioner_class, Murmur3Partitioner::PARTITIONER_CLASS)) {
-    partitioner_.reset(new Murmur3Partitioner());
+    partitioner_ = SharedRefPtr<Partitioner>(new Murmur3Partitioner());
   } else if (ends_with(partitioner_class, RandomPartitioner::PARTITIONER_CLASS)) {
-    partitioner_.reset(new RandomPartitioner());
+    partitioner_ = SharedRefPtr<Partitioner>(new RandomPartitioner());
   } else if (ends_with(partitioner_class, ByteOrderedPartitioner::PARTITIONER_CLASS)) {
-    partitioner_.reset(new ByteOrderedPartitioner());
+    partitioner_ = SharedRefPtr<Partitioner>(new ByteOrderedPartitioner());
   } else {
     LOG_WARN("Unsupported partitioner class '%s'", partitioner_class.c_str());
   }
@@ -133,21 +186,27 @@ void TokenMap::update_host(SharedRefPtr<Host>& host, const TokenStringList& toke
   // 1.) Updates should only happen on "new" host, or "moved"
   // 2.) Moving should only occur on non-vnode clusters, in which case the
   //     token map is relatively small and easy to purge/repopulate
-  purge_address(host->address());
+  TokenVec removed;
+  purge_address(host->address(), &removed);
 
+  TokenVec added;
+  added.reserve(token_strings.size());
   for (TokenStringList::const_iterator i = token_strings.begin();
        i != token_strings.end(); ++i) {
-    token_map_[partitioner_->token_from_string_ref(*i)] = host;
+    Token token(partitioner_->token_from_string_ref(*i));
+    token_map_[token] = host;
+    added.push_back(token);
   }
   mapped_addresses_.insert(host->address());
-  map_replicas();
+  update_replicas(added, removed);
 }
 
 void TokenMap::remove_host(SharedRefPtr<Host>& host) {
   if (!partitioner_) return;
 
-  if (purge_address(host->address())) {
-    map_replicas();
+  TokenVec removed;
+  if (purge_address(host->address(), &removed)) {
+    update_replicas(TokenVec(), removed);
   }
 }
 
@@ -157,7 +216,10 @@ void TokenMap::update_keyspace(const std::string& ks_name, const KeyspaceMetadat
   KeyspaceStrategyMap::iterator i = keyspace_strategy_map_.find(ks_name);
   if (i == keyspace_strategy_map_.end() || !i->second->equal(ks_meta)) {
     SharedRefPtr<ReplicationStrategy> strategy(ReplicationStrategy::from_keyspace_meta(ks_meta));
-    map_keyspace_replicas(ks_name, strategy);
+    if (is_built_) {
+      map_keyspace_replicas(ks_name, strategy, HostRing(token_map_, racks_));
+      replica_sets_.purge();
+    }
     if (i == keyspace_strategy_map_.end()) {
       keyspace_strategy_map_[ks_name] = strategy;
     } else {
@@ -169,17 +231,29 @@ void TokenMap::update_keyspace(const std::string& ks_name, const KeyspaceMetadat
 void TokenMap::drop_keyspace(const std::string& ks_name) {
   if (!partitioner_) return;
 
-  keyspace_replica_map_.erase(ks_name);
+  KeyspaceId ks_id = keyspace_id(ks_name);
+  if (ks_id != INVALID_KEYSPACE_ID && static_cast<size_t>(ks_id) < keyspace_replicas_.size()) {
+    keyspace_replicas_[ks_id].reset();
+    replica_sets_.purge();
+  }
   keyspace_strategy_map_.erase(ks_name);
 }
 
-const CopyOnWriteHostVec& TokenMap::get_replicas(const std::string& ks_name,
+const CopyOnWriteHostVec& TokenMap::get_replicas(KeyspaceId ks_id,
                                                  const std::string& routing_key) const {
   if (!partitioner_) return NO_REPLICAS;
 
-  KeyspaceReplicaMap::const_iterator tokens_it = keyspace_replica_map_.find(ks_name);
-  if (tokens_it != keyspace_replica_map_.end()) {
-    const TokenReplicaMap& tokens_to_replicas = tokens_it->second;
+  if (partitioner_->has_int64_tokens()) {
+    return get_replicas(ks_id,
+                        Murmur3Partitioner::hash_int64(reinterpret_cast<const uint8_t*>(routing_key.data()),
+                                                       routing_key.size()));
+  }
+
+  if (ks_id != INVALID_KEYSPACE_ID && static_cast<size_t>(ks_id) < keyspace_replicas_.size() &&
+      keyspace_replicas_[ks_id]) {
+    const KeyspaceReplicas& keyspace_replicas = *keyspace_replicas_[ks_id];
+
+    const TokenReplicaMap& tokens_to_replicas = keyspace_replicas.tokens;
 
     const Token t = partitioner_->hash(reinterpret_cast<const uint8_t*>(routing_key.data()), routing_key.size());
     TokenReplicaMap::const_iterator replicas_it = tokens_to_replicas.upper_bound(t);
@@ -195,32 +269,177 @@ const CopyOnWriteHostVec& TokenMap::get_replicas(const std::string& ks_name,
   return NO_REPLICAS;
 }
 
+const CopyOnWriteHostVec& TokenMap::get_replicas(KeyspaceId ks_id, int64_t token) const {
+  if (!has_int64_tokens()) return NO_REPLICAS;
+
+  if (ks_id != INVALID_KEYSPACE_ID && static_cast<size_t>(ks_id) < keyspace_replicas_.size() &&
+      keyspace_replicas_[ks_id]) {
+    const CopyOnWriteHostVec* replicas = keyspace_replicas_[ks_id]->int64_tokens.find(token);
+    return replicas != NULL ? *replicas : NO_REPLICAS;
+  }
+  return NO_REPLICAS;
+}
+
 void TokenMap::set_replication_strategy(const std::string& ks_name,
                                         const SharedRefPtr<ReplicationStrategy>& strategy) {
   keyspace_strategy_map_[ks_name] = strategy;
-  map_keyspace_replicas(ks_name, strategy);
+  if (is_built_) {
+    map_keyspace_replicas(ks_name, strategy, HostRing(token_map_, racks_));
+    replica_sets_.purge();
+  }
+}
+
+KeyspaceId TokenMap::intern_keyspace(const std::string& ks_name) {
+  // Only copies the ids if a new keyspace is added while they're shared with
+  // a snapshot
+  KeyspaceId ks_id = keyspace_id(ks_name);
+  if (ks_id != INVALID_KEYSPACE_ID || ks_name.empty()) return ks_id;
+  return keyspace_ids_->intern(ks_name);
 }
 
 void TokenMap::map_replicas(bool force) {
-  if (keyspace_replica_map_.empty() && !force) {// do nothing ahead of first build
+  if (!is_built_ && !force) {// do nothing ahead of first build
     return;
   }
+  is_built_ = true;
+  racks_ = racks_in_dcs(token_map_);
+
+  // Cleared first so keyspaces with equal strategies share the new replicas
+  // instead of stale ones
+  for (KeyspaceReplicaVec::iterator i = keyspace_replicas_.begin(),
+       end = keyspace_replicas_.end(); i != end; ++i) {
+    i->reset();
+  }
+
+  HostRing ring(token_map_, racks_);
   for (KeyspaceStrategyMap::const_iterator i = keyspace_strategy_map_.begin();
        i != keyspace_strategy_map_.end(); ++i) {
-    map_keyspace_replicas(i->first, i->second, force);
+    map_keyspace_replicas(i->first, i->second, ring);
   }
+  replica_sets_.purge();
 }
 
 void TokenMap::map_keyspace_replicas(const std::string& ks_name,
                                      const SharedRefPtr<ReplicationStrategy>& strategy,
-                                     bool force) {
-  if (keyspace_replica_map_.empty() && !force) {// do nothing ahead of first build
+                                     const HostRing& ring) {
+  KeyspaceId ks_id = intern_keyspace(ks_name);
+  if (ks_id == INVALID_KEYSPACE_ID) return;
+  if (static_cast<size_t>(ks_id) >= keyspace_replicas_.size()) {
+    keyspace_replicas_.resize(ks_id + 1);
+  }
+
+  // Keyspaces commonly share the same replication settings so the replicas
+  // of another mapped keyspace with an equal strategy are reused
+  for (KeyspaceStrategyMap::const_iterator i = keyspace_strategy_map_.begin();
+       i != keyspace_strategy_map_.end(); ++i) {
+    if (i->first == ks_name || !i->second->equal(*strategy)) continue;
+    KeyspaceId other_id = keyspace_id(i->first);
+    if (other_id != INVALID_KEYSPACE_ID &&
+        static_cast<size_t>(other_id) < keyspace_replicas_.size() &&
+        keyspace_replicas_[other_id]) {
+      keyspace_replicas_[ks_id] = keyspace_replicas_[other_id];
+      return;
+    }
+  }
+
+  SharedRefPtr<KeyspaceReplicas> replicas(new KeyspaceReplicas());
+  strategy->tokens_to_replicas(ring, &replicas->tokens, &replica_sets_);
+  if (partitioner_ && partitioner_->has_int64_tokens()) {
+    replicas->int64_tokens.build(replicas->tokens);
+  }
+  keyspace_replicas_[ks_id] = replicas;
+}
+
+void TokenMap::update_replicas(const TokenVec& added, const TokenVec& removed) {
+  if (!is_built_) { // do nothing ahead of first build
     return;
   }
-  strategy->tokens_to_replicas(token_map_, &keyspace_replica_map_[ks_name]);
+
+  // Adding the first host of a rack (or removing the last) moves replicas
+  // around the whole ring for rack aware strategies
+  DCRackMap racks(racks_in_dcs(token_map_));
+  bool racks_changed = racks != racks_;
+  racks_.swap(racks);
+
+  if (racks_changed) {
+    for (KeyspaceStrategyMap::const_iterator i = keyspace_strategy_map_.begin();
+         i != keyspace_strategy_map_.end(); ++i) {
+      KeyspaceId ks_id = keyspace_id(i->first);
+      if (i->second->is_rack_aware() && ks_id != INVALID_KEYSPACE_ID &&
+          static_cast<size_t>(ks_id) < keyspace_replicas_.size()) {
+        keyspace_replicas_[ks_id].reset();
+      }
+    }
+  }
+
+  HostRing ring(token_map_, racks_);
+
+  // Snapshots share the replicas so they're updated in a copy. Keyspaces
+  // that share replicas also share the updated copy, which is only updated
+  // once. The replaced replicas are kept alive until the loop is done so
+  // their addresses aren't reused while they're keys in "updated". Replica
+  // sets that are still used by a snapshot are purged by a later update.
+  typedef std::map<const KeyspaceReplicas*, SharedRefPtr<KeyspaceReplicas> > UpdatedMap;
+  UpdatedMap updated;
+  KeyspaceReplicaVec replaced;
+  for (KeyspaceStrategyMap::const_iterator i = keyspace_strategy_map_.begin();
+       i != keyspace_strategy_map_.end(); ++i) {
+    const SharedRefPtr<ReplicationStrategy>& strategy = i->second;
+    KeyspaceId ks_id = intern_keyspace(i->first);
+    if (ks_id == INVALID_KEYSPACE_ID) continue;
+    if (static_cast<size_t>(ks_id) >= keyspace_replicas_.size()) {
+      keyspace_replicas_.resize(ks_id + 1);
+    }
+
+    SharedRefPtr<KeyspaceReplicas>& replicas = keyspace_replicas_[ks_id];
+    if (!replicas) {
+      map_keyspace_replicas(i->first, strategy, ring);
+      updated[replicas.get()] = replicas;
+      continue;
+    }
+
+    UpdatedMap::iterator it = updated.find(replicas.get());
+    if (it != updated.end()) {
+      replicas = it->second;
+      continue;
+    }
+
+    SharedRefPtr<KeyspaceReplicas> copy(new KeyspaceReplicas());
+    copy->tokens = replicas->tokens;
+    strategy->update_replicas(ring, added, removed, &copy->tokens, &replica_sets_);
+    if (partitioner_->has_int64_tokens()) {
+      copy->int64_tokens.build(copy->tokens);
+    }
+    updated[replicas.get()] = copy;
+    replaced.push_back(replicas);
+    replicas = copy;
+  }
+  replaced.clear();
+  replica_sets_.purge();
+}
+
+size_t TokenMap::memory_size() const {
+  // Map nodes are estimated as three pointers and a color and all tokens are
+  // assumed to be the same size as the first
+  const size_t node_size = 4 * sizeof(void*);
+  const size_t token_size = token_map_.empty() ? 0 : token_map_.begin()->first.capacity();
+
+  size_t size = token_map_.size() *
+                (node_size + sizeof(TokenHostMap::value_type) + token_size);
+  std::set<const KeyspaceReplicas*> counted;
+  for (KeyspaceReplicaVec::const_iterator i = keyspace_replicas_.begin(),
+       end = keyspace_replicas_.end(); i != end; ++i) {
+    size += sizeof(SharedRefPtr<KeyspaceReplicas>);
+    if (!*i || !counted.insert(i->get()).second) continue;
+    size += sizeof(KeyspaceReplicas);
+    size += (*i)->tokens.size() *
+            (node_size + sizeof(TokenReplicaMap::value_type) + token_size);
+    size += (*i)->int64_tokens.memory_size();
+  }
+  return size + replica_sets_.memory_size();
 }
 
-bool TokenMap::purge_address(const Address& addr) {
+bool TokenMap::purge_address(const Address& addr, TokenVec* removed) {
   AddressSet::iterator addr_itr = mapped_addresses_.find(addr);
   if (addr_itr == mapped_addresses_.end()) {
     return false;
@@ -230,6 +449,7 @@ bool TokenMap::purge_address(const Address& addr) {
   while (i != token_map_.end()) {
     if (addr.compare(i->second->address()) == 0) {
       TokenHostMap::iterator to_erase = i++;
+      removed->push_back(to_erase->first);
       token_map_.erase(to_erase);
     } else {
       ++i;
@@ -252,12 +472,25 @@ Token Murmur3Partitioner::token_from_string_ref(const StringRef& token_string_re
 
 Token Murmur3Partitioner::hash(const uint8_t* data, size_t size) const {
   Token token(sizeof(int64_t), 0);
+  encode_uint64(&token[0], static_cast<uint64_t>(hash_int64(data, size)) + CASS_UINT64_MAX / 2);
+  return token;
+}
+
+int64_t Murmur3Partitioner::hash_int64(const uint8_t* data, size_t size) {
   int64_t token_value = MurmurHash3_x64_128(data, size, 0);
   if (token_value == CASS_INT64_MIN) {
     token_value = CASS_INT64_MAX;
   }
-  encode_uint64(&token[0], static_cast<uint64_t>(token_value) + CASS_UINT64_MAX / 2);
-  return token;
+  return token_value;
+}
+
+int64_t Murmur3Partitioner::to_int64(const Token& token) {
+  assert(token.size() == sizeof(int64_t));
+  uint64_t value = 0;
+  for (size_t i = 0; i < sizeof(int64_t); ++i) {
+    value = (value << 8) | token[i];
+  }
+  return static_cast<int64_t>(value - CASS_UINT64_MAX / 2);
 }
 
 const std::string RandomPartitioner::PARTITIONER_CLASS("RandomPartitioner");
@@ -20,6 +20,8 @@
 #include "buffer.hpp"
 #include "copy_on_write_ptr.hpp"
 #include "host.hpp"
+#include "keyspace_id.hpp"
+#include "ref_counted.hpp"
 #include "replication_strategy.hpp"
 #include "scoped_ptr.hpp"
 #include "string_ref.hpp"
@@ -31,44 +33,165 @@ namespace cass {
 
 typedef std::vector<StringRef> TokenStringList;
 
-class Partitioner {
+class Partitioner : public RefCounted<Partitioner> {
 public:
   virtual ~Partitioner() {}
   virtual Token token_from_string_ref(const StringRef& token_string_ref) const = 0;
   virtual Token hash(const uint8_t* data, size_t size) const = 0;
+
+  // Partitioners with 64-bit integer tokens are looked up using
+  // Int64TokenReplicaMap instead of a TokenReplicaMap.
+  virtual bool has_int64_tokens() const { return false; }
+};
+
+// A read-only ring of 64-bit tokens and their replicas. The tokens are stored
+// contiguously in Eytzinger (breadth-first) order so a lookup is a
+// branch-light walk down an implicit binary tree whose first levels share a
+// few cache lines, instead of pointer chasing through a std::map.
+class Int64TokenReplicaMap {
+public:
+  Int64TokenReplicaMap()
+    : first_(0) { }
+
+  // "replicas" must use the Murmur3Partitioner token encoding
+  void build(const TokenReplicaMap& replicas);
+  void clear();
+
+  bool empty() const { return tokens_.size() <= 1; }
+  size_t size() const { return tokens_.empty() ? 0 : tokens_.size() - 1; }
+
+  size_t memory_size() const {
+    return tokens_.capacity() * sizeof(int64_t) +
+        replicas_.capacity() * sizeof(CopyOnWriteHostVec);
+  }
+
+  // Returns the replicas for the first token greater than "token", wrapping
+  // around to the first token on the ring. Returns NULL if the ring is empty.
+  const CopyOnWriteHostVec* find(int64_t token) const {
+    const size_t n = tokens_.size();
+    if (n <= 1) return NULL;
+    size_t k = 1;
+    while (k < n) {
+      k = 2 * k + (tokens_[k] <= token);
+    }
+    // Undo the moves to the right after the last move to the left, the node
+    // where that move happened is the first token greater than "token"
+    while (k & 1) k >>= 1;
+    k >>= 1;
+    return &replicas_[k != 0 ? k : first_];
+  }
+
+private:
+  typedef std::pair<int64_t, CopyOnWriteHostVec> Entry;
+  typedef std::vector<Entry> EntryVec;
+
+  size_t fill(const EntryVec& sorted, size_t i, size_t k);
+
+private:
+  // Both are indexed from 1 (index 0 is unused) so the children of "k" are
+  // at "2 * k" and "2 * k + 1"
+  std::vector<int64_t> tokens_;
+  std::vector<CopyOnWriteHostVec> replicas_;
+  // The position of the smallest token
+  size_t first_;
 };
 
-class TokenMap {
+class TokenMap : public RefCounted<TokenMap> {
 public:
+  typedef SharedRefPtr<const TokenMap> ConstPtr;
+
+  TokenMap()
+    : keyspace_ids_(new KeyspaceIds())
+    , is_built_(false) { }
+
   virtual ~TokenMap() {}
 
   void clear();
   void build();
 
+  bool is_built() const { return is_built_; }
+
+  // Returns a read-only copy of the map for lookups on other threads. The
+  // copy shares its replicas with this map and they're never modified once
+  // they're shared, so updating this map doesn't affect the copy.
+  ConstPtr snapshot() const;
+
   void set_partitioner(const std::string& partitioner_class);
   void update_host(SharedRefPtr<Host>& host, const TokenStringList& token_strings);
   void remove_host(SharedRefPtr<Host>& host);
   void update_keyspace(const std::string& ks_name, const KeyspaceMetadata& ks_meta);
   void drop_keyspace(const std::string& ks_name);
-  const CopyOnWriteHostVec& get_replicas(const std::string& ks_name,
+
+  // Returns INVALID_KEYSPACE_ID if the keyspace has never been mapped
+  KeyspaceId keyspace_id(const std::string& ks_name) const {
+    return keyspace_ids_->find(ks_name);
+  }
+
+  // The same as keyspace_id(), but the name is only looked up if "cache"
+  // wasn't set by a map with the same keyspace ids
+  KeyspaceId keyspace_id(const std::string& ks_name, const KeyspaceIdCache& cache) const {
+    uint32_t generation = keyspace_ids_->generation();
+    KeyspaceId ks_id;
+    if (!cache.get(generation, &ks_id)) {
+      ks_id = keyspace_ids_->find(ks_name);
+      cache.set(generation, ks_id);
+    }
+    return ks_id;
+  }
+
+  const CopyOnWriteHostVec& get_replicas(KeyspaceId ks_id,
                                          const std::string& routing_key) const;
+  const CopyOnWriteHostVec& get_replicas(const std::string& ks_name,
+                                         const std::string& routing_key) const {
+    return get_replicas(keyspace_id(ks_name), routing_key);
+  }
+
+  // Lookups by a precomputed Murmur3 token (see Statement::get_routing_token())
+  // are only possible when the Murmur3Partitioner is used
+  bool has_int64_tokens() const {
+    return partitioner_ && partitioner_->has_int64_tokens();
+  }
+  const CopyOnWriteHostVec& get_replicas(KeyspaceId ks_id, int64_t token) const;
+
+  // The number of distinct replica sets shared by all the keyspaces
+  size_t replica_set_count() const { return replica_sets_.size(); }
+
+  // An estimate of the memory used by the tokens and replicas
+  size_t memory_size() const;
 
   // Testing only
   void set_replication_strategy(const std::string& ks_name,
                                 const SharedRefPtr<ReplicationStrategy>& strategy);
 
 private:
+  KeyspaceId intern_keyspace(const std::string& ks_name);
   void map_replicas(bool force = false);
+  void update_replicas(const TokenVec& added, const TokenVec& removed);
+  // The caller purges the replica sets that are no longer used
   void map_keyspace_replicas(const std::string& ks_name,
                              const SharedRefPtr<ReplicationStrategy>& strategy,
-                             bool force = false);
-  bool purge_address(const Address& addr);
+                             const HostRing& ring);
+  bool purge_address(const Address& addr, TokenVec* removed);
 
 protected:
   TokenHostMap token_map_;
 
-  typedef std::map<std::string, TokenReplicaMap> KeyspaceReplicaMap;
-  KeyspaceReplicaMap keyspace_replica_map_;
+  struct KeyspaceReplicas : public RefCounted<KeyspaceReplicas> {
+    // Kept up to date incrementally when hosts are added or removed
+    TokenReplicaMap tokens;
+    // Rebuilt from "tokens" and used for lookups if
+    // Partitioner::has_int64_tokens()
+    Int64TokenReplicaMap int64_tokens;
+  };
+
+  // Indexed by KeyspaceId, unmapped keyspaces are NULL. Keyspaces with equal
+  // replication strategies share their replicas.
+  typedef std::vector<SharedRefPtr<KeyspaceReplicas> > KeyspaceReplicaVec;
+  KeyspaceReplicaVec keyspace_replicas_;
+  CopyOnWritePtr<KeyspaceIds> keyspace_ids_;
+  bool is_built_;
+  DCRackMap racks_;
+  ReplicaSetPool replica_sets_;
 
   typedef std::map<std::string, SharedRefPtr<ReplicationStrategy> > KeyspaceStrategyMap;
   KeyspaceStrategyMap keyspace_strategy_map_;
@@ -76,7 +199,7 @@ protected:
   typedef std::set<Address> AddressSet;
   AddressSet mapped_addresses_;
 
-  ScopedPtr<Partitioner> partitioner_;
+  SharedRefPtr<Partitioner> partitioner_;
 };
 
 
@@ -86,6 +209,10 @@ public:
 
   virtual Token token_from_string_ref(const StringRef& token_string_ref) const;
   virtual Token hash(const uint8_t* data, size_t size) const;
+  virtual bool has_int64_tokens() const { return true; }
+
+  static int64_t hash_int64(const uint8_t* data, size_t size);
+  static int64_t to_int64(const Token& token);
 };
 
 
@@ -0,0 +1,110 @@
+/*
+  Copyright (c) 2014-2016 DataStax
+
+  Licensed under the Apache License, Version 2.0 (the "License");
+  you may not use this file except in compliance with the License.
+  You may obtain a copy of the License at
+
+  http://www.apache.org/licenses/LICENSE-2.0
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+*/
+
+#include "write_arena.hpp"
+
+#include <algorithm>
+#include <string.h>
+
+namespace cass {
+
+WriteChunkPool::~WriteChunkPool() {
+  for (std::vector<char*>::iterator i = free_chunks_.begin(),
+       end = free_chunks_.end(); i != end; ++i) {
+    delete[] *i;
+  }
+}
+
+char* WriteChunkPool::acquire() {
+  if (free_chunks_.empty()) {
+    return new char[CHUNK_SIZE];
+  }
+  char* chunk = free_chunks_.back();
+  free_chunks_.pop_back();
+  return chunk;
+}
+
+void WriteChunkPool::release(char* chunk) {
+  if (free_chunks_.size() < max_free_chunks_) {
+    free_chunks_.push_back(chunk);
+  } else {
+    delete[] chunk;
+  }
+}
+
+WriteArena::~WriteArena() {
+  for (std::vector<char*>::iterator i = chunks_.begin(),
+       end = chunks_.end(); i != end; ++i) {
+    pool_->release(*i);
+  }
+}
+
+void WriteArena::append(const Buffer& buffer) {
+  if (buffer.size() == 0) return;
+
+  if (buffer.size() > COPY_THRESHOLD) {
+    // Large buffers are heap allocated so their data doesn't move when the
+    // buffer is copied
+    referenced_.push_back(buffer);
+    bufs_.push_back(uv_buf_init(const_cast<char*>(referenced_.back().data()),
+                                buffer.size()));
+    is_last_buf_in_chunk_ = false;
+  } else {
+    copy(buffer.data(), buffer.size());
+  }
+  size_ += buffer.size();
+}
+
+void WriteArena::unwritten_bufs(size_t written, std::vector<uv_buf_t>* remaining) const {
+  remaining->reserve(bufs_.size());
+  for (std::vector<uv_buf_t>::const_iterator it = bufs_.begin(),
+       end = bufs_.end(); it != end; ++it) {
+    if (written >= it->len) {
+      written -= it->len;
+    } else {
+      remaining->push_back(uv_buf_init(it->base + written,
+                                       it->len - written));
+      written = 0;
+    }
+  }
+}
+
+void WriteArena::copy(const char* data, size_t size) {
+  while (size > 0) {
+    if (chunk_used_ == WriteChunkPool::CHUNK_SIZE) {
+      chunks_.push_back(pool_->acquire());
+      chunk_used_ = 0;
+      is_last_buf_in_chunk_ = false;
+    }
+
+    size_t to_copy = std::min(size, WriteChunkPool::CHUNK_SIZE - chunk_used_);
+    char* dest = chunks_.back() + chunk_used_;
+    memcpy(dest, data, to_copy);
+
+    if (is_last_buf_in_chunk_) {
+      bufs_.back().len += to_copy;
+    } else {
+      bufs_.push_back(uv_buf_init(dest, to_copy));
+      is_last_buf_in_chunk_ = true;
+    }
+
+    chunk_used_ += to_copy;
+    data += to_copy;
+    size -= to_copy;
+  }
+}
+
+} // namespace cass
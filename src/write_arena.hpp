@@ -0,0 +1,97 @@
+/*
+  Copyright (c) 2014-2016 DataStax
+
+  Licensed under the Apache License, Version 2.0 (the "License");
+  you may not use this file except in compliance with the License.
+  You may obtain a copy of the License at
+
+  http://www.apache.org/licenses/LICENSE-2.0
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+*/
+
+#ifndef __CASS_WRITE_ARENA_HPP_INCLUDED__
+#define __CASS_WRITE_ARENA_HPP_INCLUDED__
+
+#include "buffer.hpp"
+#include "macros.hpp"
+
+#include <uv.h>
+
+#include <vector>
+
+namespace cass {
+
+// Fixed size chunks of memory for write arenas. A connection keeps a few
+// free chunks around so steady state writes don't allocate.
+class WriteChunkPool {
+public:
+  static const size_t CHUNK_SIZE = 64 * 1024;
+
+  WriteChunkPool(size_t max_free_chunks = 8)
+    : max_free_chunks_(max_free_chunks) { }
+
+  ~WriteChunkPool();
+
+  char* acquire();
+  void release(char* chunk);
+
+  size_t free_chunk_count() const { return free_chunks_.size(); }
+
+private:
+  std::vector<char*> free_chunks_;
+  size_t max_free_chunks_;
+
+private:
+  DISALLOW_COPY_AND_ASSIGN(WriteChunkPool);
+};
+
+// Gathers the encoded requests of a single write. Buffers up to
+// COPY_THRESHOLD bytes are copied back to back into chunks so a write of
+// many requests only needs a few iovecs. Larger buffers (usually big bound
+// values) are referenced instead of copied.
+class WriteArena {
+public:
+  static const size_t COPY_THRESHOLD = 4 * 1024;
+
+  WriteArena(WriteChunkPool* pool)
+    : pool_(pool)
+    , chunk_used_(WriteChunkPool::CHUNK_SIZE)
+    , is_last_buf_in_chunk_(false)
+    , size_(0) { }
+
+  ~WriteArena();
+
+  void append(const Buffer& buffer);
+
+  const std::vector<uv_buf_t>& bufs() const { return bufs_; }
+
+  // Gets the iovecs for the data after the first "written" bytes, e.g.
+  // what's left after a partial synchronous write
+  void unwritten_bufs(size_t written, std::vector<uv_buf_t>* remaining) const;
+  size_t size() const { return size_; }
+  bool is_empty() const { return size_ == 0; }
+
+private:
+  void copy(const char* data, size_t size);
+
+private:
+  WriteChunkPool* pool_;
+  std::vector<char*> chunks_;
+  size_t chunk_used_;
+  bool is_last_buf_in_chunk_;
+  BufferVec referenced_;
+  std::vector<uv_buf_t> bufs_;
+  size_t size_;
+
+private:
+  DISALLOW_COPY_AND_ASSIGN(WriteArena);
+};
+
+} // namespace cass
+
+#endif
@@ -0,0 +1,133 @@
+/*
+  Copyright (c) 2014-2016 DataStax
+
+  Licensed under the Apache License, Version 2.0 (the "License");
+  you may not use this file except in compliance with the License.
+  You may obtain a copy of the License at
+
+  http://www.apache.org/licenses/LICENSE-2.0
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+*/
+
+#include "async_queue.hpp"
+#include "loop_thread.hpp"
+#include "mpmc_queue.hpp"
+#include "spsc_queue.hpp"
+
+#include <boost/test/unit_test.hpp>
+#include <boost/atomic.hpp>
+
+#include <uv.h>
+
+#include <vector>
+
+const int NUM_ENTRIES = 1000000;
+
+template <class Queue>
+struct BenchmarkAsyncQueue : public cass::LoopThread {
+  BenchmarkAsyncQueue(size_t queue_size)
+    : value_(0)
+    , wakeups_(0)
+    , async_queue_(queue_size) {
+    BOOST_REQUIRE(init() == 0);
+    BOOST_REQUIRE(async_queue_.init(loop(), this, BenchmarkAsyncQueue::async_func) == 0);
+  }
+
+  void close_and_join() {
+    while(!async_queue_.enqueue(-1)) {
+      // Keep trying
+    }
+    join();
+  }
+
+#if UV_VERSION_MAJOR == 0
+  static void async_func(uv_async_t *handle, int status) {
+#else
+  static void async_func(uv_async_t *handle) {
+#endif
+    BenchmarkAsyncQueue* test_queue = static_cast<BenchmarkAsyncQueue*>(handle->data);
+    test_queue->wakeups_++;
+    int n;
+    while (test_queue->async_queue_.dequeue(n)) {
+      if (n < 0) {
+        test_queue->close_handles();
+        test_queue->async_queue_.close_handles();
+        break;
+      } else {
+        test_queue->value_++;
+      }
+    }
+  }
+
+  boost::atomic<int> value_;
+  boost::atomic<int> wakeups_;
+  cass::AsyncQueue<Queue> async_queue_;
+};
+
+struct ProducerArgs {
+  void* queue;
+  int count;
+};
+
+template <class Queue>
+void producer_thread(void* data) {
+  ProducerArgs* args = static_cast<ProducerArgs*>(data);
+  cass::AsyncQueue<Queue>* queue = static_cast<cass::AsyncQueue<Queue>*>(args->queue);
+  for (int i = 0; i < args->count; ++i) {
+    while (!queue->enqueue(i)) {
+      // Keep trying (the queue is smaller than the number of entries)
+    }
+  }
+}
+
+template <class Queue>
+void async_queue_throughput(const char* name, int num_producers) {
+  const int num_entries = NUM_ENTRIES;
+  std::vector<uv_thread_t> threads(num_producers);
+  std::vector<ProducerArgs> args(num_producers);
+  BenchmarkAsyncQueue<Queue> test_queue(num_entries);
+
+  test_queue.run();
+
+  uint64_t start = uv_hrtime();
+  for (int i = 0; i < num_producers; ++i) {
+    args[i].queue = &test_queue.async_queue_;
+    args[i].count = num_entries / num_producers;
+    uv_thread_create(&threads[i], producer_thread<Queue>, &args[i]);
+  }
+
+  for (int i = 0; i < num_producers; ++i) {
+    uv_thread_join(&threads[i]);
+  }
+
+  test_queue.close_and_join();
+  uint64_t elapsed = uv_hrtime() - start;
+
+  int total = (num_entries / num_producers) * num_producers;
+  BOOST_CHECK_EQUAL(test_queue.value_.load(), total);
+  BOOST_TEST_MESSAGE(name << " with " << num_producers << " producer(s): "
+                     << (total * 1e9 / elapsed) << " entries/s, "
+                     << test_queue.wakeups_.load() << " wakeups for "
+                     << total << " entries");
+}
+
+BOOST_AUTO_TEST_SUITE(async_queue)
+
+BOOST_AUTO_TEST_CASE(spsc_throughput)
+{
+  async_queue_throughput<cass::SPSCQueue<int> >("SPSCQueue", 1);
+}
+
+BOOST_AUTO_TEST_CASE(mpmc_throughput)
+{
+  async_queue_throughput<cass::MPMCQueue<int> >("MPMCQueue", 1);
+  async_queue_throughput<cass::MPMCQueue<int> >("MPMCQueue", 4);
+  async_queue_throughput<cass::MPMCQueue<int> >("MPMCQueue", 8);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
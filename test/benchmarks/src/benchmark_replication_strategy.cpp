@@ -0,0 +1,91 @@
+/*
+  Copyright (c) 2014-2016 DataStax
+
+  Licensed under the Apache License, Version 2.0 (the "License");
+  you may not use this file except in compliance with the License.
+  You may obtain a copy of the License at
+
+  http://www.apache.org/licenses/LICENSE-2.0
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+*/
+
+#include "address.hpp"
+#include "host.hpp"
+#include "replication_strategy.hpp"
+#include "replication_strategy_utils.hpp"
+
+#include <boost/lexical_cast.hpp>
+#include <boost/random/mersenne_twister.hpp>
+#include <boost/test/unit_test.hpp>
+
+#include <uv.h>
+
+#include <string>
+
+BOOST_AUTO_TEST_SUITE(replication_strategy)
+
+BOOST_AUTO_TEST_CASE(update_replicas)
+{
+  const size_t num_hosts = 1000;
+  const size_t tokens_per_host = 256;
+  const size_t num_dcs = 3;
+  const size_t num_racks = 3;
+
+  cass::NetworkTopologyStrategy::DCReplicaCountMap dc_replicas;
+  for (size_t i = 0; i < num_dcs; ++i) {
+    dc_replicas["dc" + boost::lexical_cast<std::string>(i)] = 3;
+  }
+  cass::NetworkTopologyStrategy strategy("NetworkTopologyStrategy", dc_replicas);
+
+  boost::mt19937_64 ng;
+  cass::TokenHostMap primary;
+  cass::TokenVec unused;
+  for (size_t i = 0; i < num_hosts; ++i) {
+    std::string ip("10.0." + boost::lexical_cast<std::string>(i / 256) + "." +
+                   boost::lexical_cast<std::string>(i % 256));
+    add_tokens(create_host(ip,
+                           "rack" + boost::lexical_cast<std::string>((i / num_dcs) % num_racks),
+                           "dc" + boost::lexical_cast<std::string>(i % num_dcs)),
+               tokens_per_host, ng, &primary, &unused);
+  }
+
+  cass::TokenReplicaMap replicas;
+  uint64_t start = uv_hrtime();
+  strategy.tokens_to_replicas(primary, &replicas);
+  uint64_t full_elapsed = uv_hrtime() - start;
+
+  cass::DCRackMap racks(cass::racks_in_dcs(primary));
+  cass::SharedRefPtr<cass::Host> host(create_host("10.1.0.1", "rack0", "dc0"));
+
+  cass::TokenVec added;
+  add_tokens(host, tokens_per_host, ng, &primary, &added);
+  start = uv_hrtime();
+  cass::HostRing added_ring(primary, racks);
+  uint64_t ring_elapsed = uv_hrtime() - start;
+  start = uv_hrtime();
+  strategy.update_replicas(added_ring, added, cass::TokenVec(), &replicas);
+  uint64_t add_elapsed = uv_hrtime() - start;
+
+  cass::TokenVec removed;
+  remove_tokens(host, &primary, &removed);
+  cass::HostRing removed_ring(primary, racks);
+  start = uv_hrtime();
+  strategy.update_replicas(removed_ring, cass::TokenVec(), removed, &replicas);
+  uint64_t remove_elapsed = uv_hrtime() - start;
+
+  BOOST_CHECK_EQUAL(replicas.size(), primary.size());
+
+  BOOST_TEST_MESSAGE("Replica map (" << num_hosts << " hosts, " << tokens_per_host
+                     << " tokens per host, " << num_dcs << " DCs): full rebuild "
+                     << full_elapsed / 1000000.0 << " ms, ring "
+                     << ring_elapsed / 1000000.0 << " ms, add host "
+                     << add_elapsed / 1000000.0 << " ms, remove host "
+                     << remove_elapsed / 1000000.0 << " ms");
+}
+
+BOOST_AUTO_TEST_SUITE_END()
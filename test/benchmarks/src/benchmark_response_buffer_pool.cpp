@@ -0,0 +1,100 @@
+/*
+  Copyright (c) 2014-2016 DataStax
+
+  Licensed under the Apache License, Version 2.0 (the "License");
+  you may not use this file except in compliance with the License.
+  You may obtain a copy of the License at
+
+  http://www.apache.org/licenses/LICENSE-2.0
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+*/
+
+#include "response_buffer_pool.hpp"
+
+#include <boost/test/unit_test.hpp>
+
+#include <vector>
+#include <uv.h>
+
+struct ReleaseThreadArgs {
+  uv_thread_t thread;
+  std::vector<cass::SharedRefPtr<cass::RefBuffer> > buffers;
+};
+
+void release_thread(void* data) {
+  ReleaseThreadArgs* args = static_cast<ReleaseThreadArgs*>(data);
+  args->buffers.clear();
+}
+
+// Allocates "num_iterations" bodies cycling through "sizes" and frees them
+// in batches of "batch_size", on another thread if "is_cross_thread" is set
+// (like results freed by the application). Returns the elapsed time in
+// nanoseconds.
+static uint64_t allocate_bodies(bool is_pooled, bool is_cross_thread,
+                                const size_t* sizes, size_t num_sizes,
+                                size_t batch_size) {
+  const int num_iterations = 300000;
+
+  cass::ResponseBufferPool::Ptr pool(new cass::ResponseBufferPool(NULL));
+  ReleaseThreadArgs args;
+  args.buffers.reserve(batch_size);
+
+  uint64_t start = uv_hrtime();
+  for (int i = 0; i < num_iterations; ++i) {
+    size_t size = sizes[i % num_sizes];
+    args.buffers.push_back(
+          cass::SharedRefPtr<cass::RefBuffer>(is_pooled ? pool->acquire(size)
+                                                        : cass::RefBuffer::create(size)));
+    args.buffers.back()->data()[0] = 'a';
+    if (args.buffers.size() == batch_size) {
+      if (is_cross_thread) {
+        uv_thread_create(&args.thread, release_thread, &args);
+        uv_thread_join(&args.thread);
+      } else {
+        args.buffers.clear();
+      }
+    }
+  }
+  return uv_hrtime() - start;
+}
+
+BOOST_AUTO_TEST_SUITE(response_buffer_pool)
+
+BOOST_AUTO_TEST_CASE(allocate)
+{
+  const size_t small_sizes[] = { 300, 1500, 4000, 12000 };
+  const size_t large_sizes[] = { 200 * 1024, 500 * 1024, 1000 * 1024 };
+
+  struct {
+    const char* name;
+    const size_t* sizes;
+    size_t num_sizes;
+    bool is_cross_thread;
+    size_t batch_size;
+  } cases[] = {
+    { "small bodies", small_sizes, 4, false, 32 },
+    { "small bodies freed on another thread", small_sizes, 4, true, 256 },
+    { "large bodies", large_sizes, 3, false, 2 }
+  };
+
+  for (size_t i = 0; i < sizeof(cases) / sizeof(cases[0]); ++i) {
+    uint64_t elapsed[2];
+    for (int run = 0; run < 2; ++run) { // The first run warms up the heap
+      for (int is_pooled = 0; is_pooled < 2; ++is_pooled) {
+        elapsed[is_pooled] = allocate_bodies(is_pooled != 0, cases[i].is_cross_thread,
+                                             cases[i].sizes, cases[i].num_sizes,
+                                             cases[i].batch_size);
+      }
+    }
+    BOOST_TEST_MESSAGE("Allocating 300000 " << cases[i].name << ": "
+                       << elapsed[0] / 1000000.0 << " ms with new/delete, "
+                       << elapsed[1] / 1000000.0 << " ms from the pool");
+  }
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,105 @@
+/*
+  Copyright (c) 2014-2016 DataStax
+
+  Licensed under the Apache License, Version 2.0 (the "License");
+  you may not use this file except in compliance with the License.
+  You may obtain a copy of the License at
+
+  http://www.apache.org/licenses/LICENSE-2.0
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+*/
+
+#include "constants.hpp"
+#include "response.hpp"
+#include "serialization.hpp"
+
+#include <boost/test/unit_test.hpp>
+
+#include <algorithm>
+#include <string.h>
+#include <vector>
+#include <uv.h>
+
+#define READ_SIZE 64 * 1024
+
+// Builds a protocol v4 RESULT frame with "row_count" rows of one "value_size"
+// byte column
+static std::vector<char> build_rows_frame(int16_t stream, int32_t row_count, size_t value_size) {
+  size_t body_size = 4 * sizeof(int32_t) + row_count * (sizeof(int32_t) + value_size);
+  std::vector<char> frame(CASS_HEADER_SIZE_V3 + body_size);
+
+  char* pos = &frame[0];
+  pos = cass::encode_byte(pos, 0x84); // Response, version 4
+  pos = cass::encode_byte(pos, 0); // Flags
+  cass::encode_int16(pos, stream); pos += sizeof(int16_t);
+  pos = cass::encode_byte(pos, CQL_OPCODE_RESULT);
+  cass::encode_int32(pos, static_cast<int32_t>(body_size)); pos += sizeof(int32_t);
+
+  cass::encode_int32(pos, CASS_RESULT_KIND_ROWS); pos += sizeof(int32_t);
+  cass::encode_int32(pos, CASS_RESULT_FLAG_NO_METADATA); pos += sizeof(int32_t);
+  cass::encode_int32(pos, 1); pos += sizeof(int32_t); // Column count
+  cass::encode_int32(pos, row_count); pos += sizeof(int32_t);
+  for (int32_t i = 0; i < row_count; ++i) {
+    cass::encode_int32(pos, static_cast<int32_t>(value_size)); pos += sizeof(int32_t);
+    memset(pos, 'a' + i % 26, value_size); pos += value_size;
+  }
+
+  return frame;
+}
+
+// Decodes a frame the way the connection reads it from the socket. "input"
+// stands in for the socket and every read copies up to READ_SIZE bytes into
+// a read buffer. When "is_direct" is set the rest of a large body is read
+// straight into the response's buffer instead.
+static bool decode_frame(const std::vector<char>& input, bool is_direct,
+                         cass::ResponseMessage* response) {
+  std::vector<char> read_buffer(READ_SIZE);
+  size_t offset = 0;
+  while (offset < input.size() && !response->is_body_ready()) {
+    size_t body_remaining = response->body_remaining();
+    char* buffer = &read_buffer[0];
+    size_t size = READ_SIZE;
+    if (is_direct && body_remaining >= READ_SIZE) {
+      buffer = response->body_buffer_pos();
+      size = body_remaining;
+    }
+    size = std::min(size, input.size() - offset);
+    memcpy(buffer, &input[offset], size);
+    if (response->decode(buffer, size, NULL) != static_cast<ssize_t>(size)) {
+      return false;
+    }
+    offset += size;
+  }
+  return response->is_body_ready();
+}
+BOOST_AUTO_TEST_SUITE(response_message)
+
+BOOST_AUTO_TEST_CASE(direct_read)
+{
+  // 4MB pages of 4096 rows with 1KB values
+  const int num_pages = 64;
+  std::vector<char> frame = build_rows_frame(3, 4096, 1020);
+  BOOST_REQUIRE(frame.size() > 4 * 1024 * 1024 - 4096);
+
+  uint64_t elapsed[2] = { 0, 0 };
+  for (int i = 0; i < 2; ++i) {
+    bool is_direct = i == 1;
+    uint64_t start = uv_hrtime();
+    for (int page = 0; page < num_pages; ++page) {
+      cass::ResponseMessage response;
+      BOOST_REQUIRE(decode_frame(frame, is_direct, &response));
+    }
+    elapsed[i] = uv_hrtime() - start;
+  }
+
+  BOOST_TEST_MESSAGE("Decoding " << num_pages << " pages of " << frame.size() << " bytes: "
+                     << elapsed[0] / 1000000.0 << " ms through read buffers, "
+                     << elapsed[1] / 1000000.0 << " ms read directly into the body");
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,73 @@
+/*
+  Copyright (c) 2014-2016 DataStax
+
+  Licensed under the Apache License, Version 2.0 (the "License");
+  you may not use this file except in compliance with the License.
+  You may obtain a copy of the License at
+
+  http://www.apache.org/licenses/LICENSE-2.0
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+*/
+
+#include "stream_manager.hpp"
+
+#include <map>
+#include <vector>
+#include <uv.h>
+
+#include <boost/test/unit_test.hpp>
+
+BOOST_AUTO_TEST_SUITE(streams)
+
+// Measures acquire/release throughput with a large number of requests in
+// flight. A std::map keyed by stream ID (the previous implementation) is
+// timed with the same access pattern for comparison.
+BOOST_AUTO_TEST_CASE(throughput)
+{
+  const size_t num_in_flight = 16384;
+  const size_t num_iterations = 50;
+
+  cass::StreamManager<int> streams(3);
+  std::vector<int> acquired(num_in_flight);
+
+  uint64_t start = uv_hrtime();
+  for (size_t n = 0; n < num_iterations; ++n) {
+    for (size_t i = 0; i < num_in_flight; ++i) {
+      acquired[i] = streams.acquire(static_cast<int>(i));
+      BOOST_REQUIRE(acquired[i] >= 0);
+    }
+    for (size_t i = 0; i < num_in_flight; ++i) {
+      int item;
+      BOOST_REQUIRE(streams.get_pending_and_release(acquired[i], item));
+    }
+  }
+  uint64_t stream_manager_elapsed = uv_hrtime() - start;
+
+  std::map<int, int> pending;
+  start = uv_hrtime();
+  for (size_t n = 0; n < num_iterations; ++n) {
+    for (size_t i = 0; i < num_in_flight; ++i) {
+      pending[acquired[i]] = static_cast<int>(i);
+    }
+    for (size_t i = 0; i < num_in_flight; ++i) {
+      std::map<int, int>::iterator it = pending.find(acquired[i]);
+      BOOST_REQUIRE(it != pending.end());
+      pending.erase(it);
+    }
+  }
+  uint64_t map_elapsed = uv_hrtime() - start;
+
+  const double num_ops = static_cast<double>(num_in_flight * num_iterations);
+  BOOST_TEST_MESSAGE("Stream manager with " << num_in_flight << " in-flight: "
+                     << (num_ops / (stream_manager_elapsed / 1e9)) << " acquire/release per second "
+                     << "(std::map: " << (num_ops / (map_elapsed / 1e9)) << " per second)");
+
+  BOOST_CHECK_EQUAL(streams.pending_streams(), 0u);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
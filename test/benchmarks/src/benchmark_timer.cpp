@@ -0,0 +1,94 @@
+/*
+  Copyright (c) 2014-2016 DataStax
+
+  Licensed under the Apache License, Version 2.0 (the "License");
+  you may not use this file except in compliance with the License.
+  You may obtain a copy of the License at
+
+  http://www.apache.org/licenses/LICENSE-2.0
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+*/
+
+#include "scoped_ptr.hpp"
+#include "timer.hpp"
+#include "timer_wheel.hpp"
+
+#include <boost/test/unit_test.hpp>
+
+#include <uv.h>
+
+void on_timer_noop(cass::Timer* timer) { }
+
+void on_wheel_timer_noop(cass::TimerWheel::Entry* entry) { }
+
+BOOST_AUTO_TEST_SUITE(timer)
+
+// Measures starting and stopping request timeouts with 50k requests
+// outstanding using a libuv timer per request (the previous implementation)
+// and a shared timer wheel.
+BOOST_AUTO_TEST_CASE(wheel_throughput)
+{
+  const size_t num_outstanding = 50000;
+  const size_t num_iterations = 10;
+  const uint64_t timeout = 12000;
+
+  uv_loop_t* loop;
+
+#if UV_VERSION_MAJOR == 0
+  loop = uv_loop_new();
+#else
+  uv_loop_t loop_storage__;
+  loop = &loop_storage__;
+  uv_loop_init(loop);
+#endif
+
+  cass::ScopedPtr<cass::Timer[]> timers(new cass::Timer[num_outstanding]);
+  uint64_t start = uv_hrtime();
+  for (size_t n = 0; n < num_iterations; ++n) {
+    for (size_t i = 0; i < num_outstanding; ++i) {
+      timers[i].start(loop, timeout + i % 100, NULL, on_timer_noop);
+    }
+    for (size_t i = 0; i < num_outstanding; ++i) {
+      timers[i].stop();
+    }
+    // Stopped timers are closed and freed by the loop
+    uv_run(loop, UV_RUN_DEFAULT);
+  }
+  uint64_t timer_elapsed = uv_hrtime() - start;
+
+  cass::TimerWheel wheel;
+  wheel.init(loop);
+  cass::ScopedPtr<cass::TimerWheel::Entry[]> entries(new cass::TimerWheel::Entry[num_outstanding]);
+  start = uv_hrtime();
+  for (size_t n = 0; n < num_iterations; ++n) {
+    for (size_t i = 0; i < num_outstanding; ++i) {
+      entries[i].start(&wheel, timeout + i % 100, NULL, on_wheel_timer_noop);
+    }
+    for (size_t i = 0; i < num_outstanding; ++i) {
+      entries[i].stop();
+    }
+  }
+  uint64_t wheel_elapsed = uv_hrtime() - start;
+
+  BOOST_CHECK_EQUAL(wheel.size(), 0u);
+  wheel.close_handles();
+  uv_run(loop, UV_RUN_DEFAULT);
+
+  const double num_ops = static_cast<double>(num_outstanding * num_iterations);
+  BOOST_TEST_MESSAGE("Timer wheel with " << num_outstanding << " outstanding: "
+                     << (num_ops / (wheel_elapsed / 1e9)) << " start/stop per second "
+                     << "(libuv timer per request: " << (num_ops / (timer_elapsed / 1e9)) << " per second)");
+
+#if UV_VERSION_MAJOR == 0
+  uv_loop_delete(loop);
+#else
+  uv_loop_close(loop);
+#endif
+}
+
+BOOST_AUTO_TEST_SUITE_END()
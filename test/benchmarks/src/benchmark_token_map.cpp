@@ -0,0 +1,112 @@
+/*
+  Copyright (c) 2014-2016 DataStax
+
+  Licensed under the Apache License, Version 2.0 (the "License");
+  you may not use this file except in compliance with the License.
+  You may obtain a copy of the License at
+
+  http://www.apache.org/licenses/LICENSE-2.0
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+*/
+
+#include "address.hpp"
+#include "murmur3.hpp"
+#include "token_map.hpp"
+
+#include <boost/lexical_cast.hpp>
+#include <boost/test/unit_test.hpp>
+#include <boost/random/mersenne_twister.hpp>
+
+#include <uv.h>
+
+#include <map>
+#include <string>
+#include <vector>
+
+BOOST_AUTO_TEST_SUITE(token_map)
+
+BOOST_AUTO_TEST_CASE(murmur3_lookups)
+{
+  const size_t num_hosts = 500;
+  const size_t tokens_per_host = 256;
+  const size_t num_keys = 1024;
+  const size_t num_lookups = 1000000;
+
+  typedef std::map<int64_t, cass::SharedRefPtr<cass::Host> > TokenHostMap;
+
+  TokenHostMap tokens;
+  boost::mt19937_64 ng;
+
+  for (size_t i = 0; i < num_hosts; ++i) {
+    cass::SharedRefPtr<cass::Host> host(
+          new cass::Host(cass::Address("10." + boost::lexical_cast<std::string>(i / 256) + ".0." +
+                                       boost::lexical_cast<std::string>(i % 256), 9042), false));
+    for (size_t j = 0; j < tokens_per_host; ++j) {
+      tokens[static_cast<int64_t>(ng())] = host;
+    }
+  }
+
+  cass::TokenMap token_map;
+  token_map.set_partitioner(cass::Murmur3Partitioner::PARTITIONER_CLASS);
+  token_map.set_replication_strategy("test",
+                                     cass::SharedRefPtr<cass::ReplicationStrategy>(
+                                       new cass::NonReplicatedStrategy("")));
+  for (TokenHostMap::iterator i = tokens.begin(); i != tokens.end(); ++i) {
+    cass::TokenStringList token;
+    token.push_back(boost::lexical_cast<std::string>(i->first));
+    token_map.update_host(i->second, token);
+  }
+  token_map.build();
+
+  // The byte encoded ring used for the other partitioners, as a baseline
+  cass::Murmur3Partitioner partitioner;
+  cass::TokenReplicaMap baseline;
+  for (TokenHostMap::iterator i = tokens.begin(); i != tokens.end(); ++i) {
+    std::string token(boost::lexical_cast<std::string>(i->first));
+    baseline.insert(cass::TokenReplicaMap::value_type(
+                    partitioner.token_from_string_ref(cass::StringRef(token)),
+                    cass::CopyOnWriteHostVec(new cass::HostVec(1, i->second))));
+  }
+
+  std::vector<std::string> keys;
+  for (size_t i = 0; i < num_keys; ++i) {
+    keys.push_back("key" + boost::lexical_cast<std::string>(ng()));
+  }
+
+  size_t found = 0;
+  uint64_t start = uv_hrtime();
+  for (size_t i = 0; i < num_lookups; ++i) {
+    const cass::CopyOnWriteHostVec& replicas
+        = token_map.get_replicas("test", keys[i % num_keys]);
+    found += replicas->size();
+  }
+  uint64_t elapsed = uv_hrtime() - start;
+  BOOST_CHECK_EQUAL(found, num_lookups);
+
+  found = 0;
+  uint64_t baseline_start = uv_hrtime();
+  for (size_t i = 0; i < num_lookups; ++i) {
+    const std::string& key = keys[i % num_keys];
+    cass::Token token = partitioner.hash(reinterpret_cast<const uint8_t*>(key.data()),
+                                         key.size());
+    cass::TokenReplicaMap::const_iterator it = baseline.upper_bound(token);
+    if (it == baseline.end()) it = baseline.begin();
+    found += it->second->size();
+  }
+  uint64_t baseline_elapsed = uv_hrtime() - baseline_start;
+  BOOST_CHECK_EQUAL(found, num_lookups);
+
+  BOOST_TEST_MESSAGE("Token ring lookups (" << num_hosts << " hosts, "
+                     << tokens_per_host << " tokens per host): int64 "
+                     << (num_lookups * 1000000000.0) / elapsed
+                     << " lookups/s, byte map "
+                     << (num_lookups * 1000000000.0) / baseline_elapsed
+                     << " lookups/s");
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,169 @@
+/*
+  Copyright (c) 2014-2016 DataStax
+
+  Licensed under the Apache License, Version 2.0 (the "License");
+  you may not use this file except in compliance with the License.
+  You may obtain a copy of the License at
+
+  http://www.apache.org/licenses/LICENSE-2.0
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+*/
+
+#include "handler.hpp"
+#include "query_request.hpp"
+#include "write_arena.hpp"
+
+#include <boost/test/unit_test.hpp>
+
+#include <algorithm>
+#include <string>
+#include <uv.h>
+
+#ifndef _WIN32
+#include <limits.h>
+#include <sys/socket.h>
+#include <sys/uio.h>
+#include <unistd.h>
+
+#ifndef IOV_MAX
+#define IOV_MAX 1024
+#endif
+
+struct BenchmarkHandler : public cass::Handler {
+  BenchmarkHandler(const cass::Request* request)
+    : cass::Handler(request) { }
+
+  virtual void on_set(cass::ResponseMessage* response) { }
+  virtual void on_error(CassError code, const std::string& message) { }
+  virtual void on_timeout() { }
+};
+
+// Drains the other end of the socket pair so writes never block for long
+static void drain_socket(void* data) {
+  int fd = *static_cast<int*>(data);
+  char buf[64 * 1024];
+  while (read(fd, buf, sizeof(buf)) > 0) { }
+}
+
+// Writes the iovecs the same way libuv does, at most IOV_MAX per call
+static size_t write_bufs(int fd, const std::vector<uv_buf_t>& bufs, size_t* num_calls) {
+  std::vector<struct iovec> iovs(bufs.size());
+  for (size_t i = 0; i < bufs.size(); ++i) {
+    iovs[i].iov_base = bufs[i].base;
+    iovs[i].iov_len = bufs[i].len;
+  }
+
+  size_t total = 0;
+  size_t index = 0;
+  while (index < iovs.size()) {
+    int count = static_cast<int>(std::min(iovs.size() - index, static_cast<size_t>(IOV_MAX)));
+    ssize_t n = writev(fd, &iovs[index], count);
+    BOOST_REQUIRE(n > 0);
+    ++(*num_calls);
+    total += n;
+    while (n > 0) {
+      if (static_cast<size_t>(n) >= iovs[index].iov_len) {
+        n -= iovs[index].iov_len;
+        ++index;
+      } else {
+        iovs[index].iov_base = static_cast<char*>(iovs[index].iov_base) + n;
+        iovs[index].iov_len -= n;
+        n = 0;
+      }
+    }
+  }
+  return total;
+}
+#endif
+
+BOOST_AUTO_TEST_SUITE(write_arena)
+
+// Measures encoding and writing batches of small requests to a socket. The
+// list of per request buffers (the previous implementation) needs several
+// iovecs per request, while the arena copies them into a few chunks.
+BOOST_AUTO_TEST_CASE(encode_and_write)
+{
+#ifndef _WIN32
+  const size_t num_flushes = 2000;
+  const size_t requests_per_flush = 128;
+  const std::string query("INSERT INTO ks.table (key, value) VALUES (?, ?)");
+
+  std::vector<cass::SharedRefPtr<cass::QueryRequest> > requests;
+  std::vector<cass::SharedRefPtr<BenchmarkHandler> > handlers;
+  for (size_t i = 0; i < requests_per_flush; ++i) {
+    cass::SharedRefPtr<cass::QueryRequest> request(new cass::QueryRequest(query, 2));
+    request->set(0, static_cast<cass_int64_t>(i));
+    request->set(1, cass::CassString("some value to write", 19));
+    requests.push_back(request);
+    handlers.push_back(cass::SharedRefPtr<BenchmarkHandler>(new BenchmarkHandler(request.get())));
+  }
+
+  int fds[2];
+  BOOST_REQUIRE(socketpair(AF_UNIX, SOCK_STREAM, 0, fds) == 0);
+  uv_thread_t reader;
+  uv_thread_create(&reader, drain_socket, &fds[1]);
+
+  // Encoding into a list of buffers that are each written as an iovec
+  size_t list_bytes = 0;
+  size_t list_iovecs = 0;
+  size_t list_calls = 0;
+  uint64_t start = uv_hrtime();
+  for (size_t n = 0; n < num_flushes; ++n) {
+    cass::BufferVec buffers;
+    for (size_t i = 0; i < requests_per_flush; ++i) {
+      handlers[i]->encode(CASS_HIGHEST_SUPPORTED_PROTOCOL_VERSION, 0, &buffers);
+    }
+    cass::UvBufVec bufs;
+    bufs.reserve(buffers.size());
+    for (cass::BufferVec::const_iterator i = buffers.begin(); i != buffers.end(); ++i) {
+      bufs.push_back(uv_buf_init(const_cast<char*>(i->data()), i->size()));
+    }
+    list_iovecs += bufs.size();
+    list_bytes += write_bufs(fds[0], bufs, &list_calls);
+  }
+  uint64_t list_elapsed = uv_hrtime() - start;
+
+  // Encoding into the write arena
+  cass::WriteChunkPool pool;
+  size_t arena_bytes = 0;
+  size_t arena_iovecs = 0;
+  size_t arena_calls = 0;
+  start = uv_hrtime();
+  for (size_t n = 0; n < num_flushes; ++n) {
+    cass::WriteArena arena(&pool);
+    cass::BufferVec request_buffers;
+    for (size_t i = 0; i < requests_per_flush; ++i) {
+      handlers[i]->encode(CASS_HIGHEST_SUPPORTED_PROTOCOL_VERSION, 0, &request_buffers);
+      for (cass::BufferVec::const_iterator j = request_buffers.begin();
+           j != request_buffers.end(); ++j) {
+        arena.append(*j);
+      }
+      request_buffers.clear();
+    }
+    arena_iovecs += arena.bufs().size();
+    arena_bytes += write_bufs(fds[0], arena.bufs(), &arena_calls);
+  }
+  uint64_t arena_elapsed = uv_hrtime() - start;
+
+  close(fds[0]);
+  uv_thread_join(&reader);
+  close(fds[1]);
+
+  BOOST_CHECK_EQUAL(list_bytes, arena_bytes);
+
+  BOOST_TEST_MESSAGE("Writing " << num_flushes << " flushes of " << requests_per_flush
+                     << " requests: buffer list " << list_iovecs / num_flushes
+                     << " iovecs and " << static_cast<double>(list_calls) / num_flushes
+                     << " writev() calls per flush in " << list_elapsed / 1000000.0
+                     << " ms, write arena " << arena_iovecs / num_flushes
+                     << " iovecs and " << static_cast<double>(arena_calls) / num_flushes
+                     << " writev() calls per flush in " << arena_elapsed / 1000000.0 << " ms");
+#endif
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,77 @@
+/*
+  Copyright (c) 2014-2016 DataStax
+
+  Licensed under the Apache License, Version 2.0 (the "License");
+  you may not use this file except in compliance with the License.
+  You may obtain a copy of the License at
+
+  http://www.apache.org/licenses/LICENSE-2.0
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+*/
+
+#ifndef __CASS_REPLICATION_STRATEGY_UTILS_HPP_INCLUDED__
+#define __CASS_REPLICATION_STRATEGY_UTILS_HPP_INCLUDED__
+
+#include "address.hpp"
+#include "host.hpp"
+#include "replication_strategy.hpp"
+
+#include <boost/random/mersenne_twister.hpp>
+
+#include <string>
+
+// Helpers for building token rings, shared by the replication strategy unit
+// tests and benchmarks
+
+inline cass::SharedRefPtr<cass::Host> create_host(const std::string& ip,
+                                                  const std::string& rack = "",
+                                                  const std::string& dc = "") {
+  cass::SharedRefPtr<cass::Host> host =
+      cass::SharedRefPtr<cass::Host>(new cass::Host(cass::Address(ip, 4092), false));
+  host->set_rack_and_dc(rack, dc);
+  return host;
+}
+
+inline cass::Token random_token(boost::mt19937_64& ng) {
+  uint64_t value = ng();
+  cass::Token token(sizeof(uint64_t));
+  for (size_t i = 0; i < sizeof(uint64_t); ++i) {
+    token[i] = static_cast<uint8_t>(value >> (8 * (sizeof(uint64_t) - 1 - i)));
+  }
+  return token;
+}
+
+inline void add_tokens(const cass::SharedRefPtr<cass::Host>& host,
+                       size_t num_tokens,
+                       boost::mt19937_64& ng,
+                       cass::TokenHostMap* primary,
+                       cass::TokenVec* added) {
+  while (num_tokens > 0) {
+    cass::Token token(random_token(ng));
+    if (primary->insert(std::make_pair(token, host)).second) {
+      added->push_back(token);
+      --num_tokens;
+    }
+  }
+}
+
+inline void remove_tokens(const cass::SharedRefPtr<cass::Host>& host,
+                          cass::TokenHostMap* primary,
+                          cass::TokenVec* removed) {
+  cass::TokenHostMap::iterator i = primary->begin();
+  while (i != primary->end()) {
+    if (i->second == host) {
+      removed->push_back(i->first);
+      primary->erase(i++);
+    } else {
+      ++i;
+    }
+  }
+}
+
+#endif
@@ -0,0 +1,99 @@
+/*
+  Copyright (c) 2014-2016 DataStax
+
+  Licensed under the Apache License, Version 2.0 (the "License");
+  you may not use this file except in compliance with the License.
+  You may obtain a copy of the License at
+
+  http://www.apache.org/licenses/LICENSE-2.0
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+*/
+
+#ifdef STAND_ALONE
+#   define BOOST_TEST_MODULE cassandra
+#endif
+
+#include "adaptive_flush.hpp"
+
+#include <boost/test/unit_test.hpp>
+
+BOOST_AUTO_TEST_SUITE(adaptive_flush)
+
+BOOST_AUTO_TEST_CASE(disabled)
+{
+  cass::AdaptiveFlush flush(false, 128, 100);
+
+  BOOST_CHECK(!flush.is_delay_enabled());
+  flush.update(true);
+  BOOST_CHECK_EQUAL(flush.batch_size(), 128u);
+
+  flush.start_delay(0);
+  BOOST_CHECK(!flush.should_delay(0));
+}
+
+BOOST_AUTO_TEST_CASE(batch_size_grows_to_max)
+{
+  cass::AdaptiveFlush flush(true, 128, 0);
+  BOOST_CHECK_EQUAL(flush.batch_size(), 128u);
+
+  const size_t expected[] = { 256, 512, 1024, 1024, 1024 };
+  for (size_t i = 0; i < sizeof(expected) / sizeof(expected[0]); ++i) {
+    flush.update(true);
+    BOOST_CHECK_EQUAL(flush.batch_size(), expected[i]);
+  }
+  BOOST_CHECK_EQUAL(flush.max_batch_size(),
+                    cass::AdaptiveFlush::MAX_BATCH_SIZE_FACTOR * 128u);
+}
+
+BOOST_AUTO_TEST_CASE(batch_size_shrinks_to_min)
+{
+  cass::AdaptiveFlush flush(true, 100, 0);
+  for (int i = 0; i < 10; ++i) {
+    flush.update(true);
+  }
+  BOOST_CHECK_EQUAL(flush.batch_size(), 800u);
+
+  const size_t expected[] = { 400, 200, 100, 100 };
+  for (size_t i = 0; i < sizeof(expected) / sizeof(expected[0]); ++i) {
+    flush.update(false);
+    BOOST_CHECK_EQUAL(flush.batch_size(), expected[i]);
+  }
+
+  // A batch size that isn't a power of two of the minimum doesn't drop
+  // below the minimum
+  cass::AdaptiveFlush odd(true, 3, 0);
+  odd.update(true);
+  BOOST_CHECK_EQUAL(odd.batch_size(), 6u);
+  odd.update(false);
+  odd.update(false);
+  BOOST_CHECK_EQUAL(odd.batch_size(), 3u);
+}
+
+BOOST_AUTO_TEST_CASE(delay)
+{
+  cass::AdaptiveFlush flush(true, 128, 100);
+  BOOST_CHECK(flush.is_delay_enabled());
+
+  flush.start_delay(1000000);
+  BOOST_CHECK(flush.should_delay(1000000));
+  BOOST_CHECK(flush.should_delay(1000000 + 99999));
+  BOOST_CHECK(!flush.should_delay(1000000 + 100000));
+
+  // No delay while the queue is backed up
+  flush.update(true);
+  BOOST_CHECK(!flush.should_delay(1000000));
+  flush.update(false);
+  BOOST_CHECK(flush.should_delay(1000000));
+
+  cass::AdaptiveFlush no_delay(true, 128, 0);
+  no_delay.start_delay(0);
+  BOOST_CHECK(!no_delay.is_delay_enabled());
+  BOOST_CHECK(!no_delay.should_delay(0));
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,57 @@
+/*
+  Copyright (c) 2014-2016 DataStax
+
+  Licensed under the Apache License, Version 2.0 (the "License");
+  you may not use this file except in compliance with the License.
+  You may obtain a copy of the License at
+
+  http://www.apache.org/licenses/LICENSE-2.0
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+*/
+
+#ifdef STAND_ALONE
+#   define BOOST_TEST_MODULE cassandra
+#endif
+
+#include "cassandra.h"
+#include "cluster.hpp"
+#include "external_types.hpp"
+
+#include <boost/test/unit_test.hpp>
+
+BOOST_AUTO_TEST_SUITE(cluster)
+
+BOOST_AUTO_TEST_CASE(io_worker_affinity_with_speculative_executions)
+{
+  CassCluster* cluster = cass_cluster_new();
+
+  // Speculative executions can't be enabled once affinity is enabled
+  BOOST_REQUIRE_EQUAL(cass_cluster_set_use_io_worker_affinity(cluster, cass_true), CASS_OK);
+  BOOST_CHECK_EQUAL(cass_cluster_set_constant_speculative_execution_policy(cluster, 100, 1),
+                    CASS_ERROR_LIB_BAD_PARAMS);
+  BOOST_CHECK_EQUAL(cass_cluster_set_percentile_speculative_execution_policy(cluster, 99.0, 1),
+                    CASS_ERROR_LIB_BAD_PARAMS);
+  BOOST_CHECK_EQUAL(cass_cluster_set_no_speculative_execution_policy(cluster), CASS_OK);
+  BOOST_CHECK(!cluster->config().use_speculative_executions());
+
+  // ...and affinity can't be enabled once speculative executions are enabled
+  BOOST_REQUIRE_EQUAL(cass_cluster_set_use_io_worker_affinity(cluster, cass_false), CASS_OK);
+  BOOST_REQUIRE_EQUAL(cass_cluster_set_constant_speculative_execution_policy(cluster, 100, 1),
+                      CASS_OK);
+  BOOST_CHECK_EQUAL(cass_cluster_set_use_io_worker_affinity(cluster, cass_true),
+                    CASS_ERROR_LIB_BAD_PARAMS);
+  BOOST_CHECK(!cluster->config().use_io_worker_affinity());
+
+  BOOST_REQUIRE_EQUAL(cass_cluster_set_no_speculative_execution_policy(cluster), CASS_OK);
+  BOOST_CHECK_EQUAL(cass_cluster_set_use_io_worker_affinity(cluster, cass_true), CASS_OK);
+  BOOST_CHECK(cluster->config().use_io_worker_affinity());
+
+  cass_cluster_free(cluster);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,128 @@
+/*
+  Copyright (c) 2014-2016 DataStax
+
+  Licensed under the Apache License, Version 2.0 (the "License");
+  you may not use this file except in compliance with the License.
+  You may obtain a copy of the License at
+
+  http://www.apache.org/licenses/LICENSE-2.0
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+*/
+
+#ifdef STAND_ALONE
+#   define BOOST_TEST_MODULE cassandra
+#endif
+
+#include "compression.hpp"
+#include "scoped_ptr.hpp"
+
+#include <string>
+#include <vector>
+
+#include <boost/test/unit_test.hpp>
+
+BOOST_AUTO_TEST_SUITE(compression)
+
+BOOST_AUTO_TEST_CASE(negotiate)
+{
+  std::list<std::string> supported;
+  supported.push_back("snappy");
+
+  cass::Compressor::ConstPtr compressor(
+        cass::Compressor::negotiate(CASS_COMPRESSION_NONE, 4, supported));
+  BOOST_CHECK(!compressor);
+
+  compressor.reset(cass::Compressor::negotiate(CASS_COMPRESSION_LZ4, 4, supported));
+  BOOST_CHECK(!compressor);
+
+  BOOST_CHECK(cass::Compressor::is_supported(CASS_COMPRESSION_NONE));
+}
+
+#if defined(CASS_USE_LZ4) || defined(CASS_USE_SNAPPY)
+static void check_round_trip(const cass::Compressor* compressor,
+                             const std::string& input) {
+  std::vector<char> compressed(compressor->max_compressed_length(input.size()));
+  size_t compressed_size = 0;
+  BOOST_REQUIRE(compressor->compress(input.data(), input.size(),
+                                     &compressed[0], &compressed_size));
+  BOOST_REQUIRE(compressed_size <= compressed.size());
+
+  size_t length = 0;
+  BOOST_REQUIRE(compressor->uncompressed_length(&compressed[0], compressed_size, &length));
+  BOOST_REQUIRE_EQUAL(length, input.size());
+
+  std::vector<char> output(length + 1);
+  BOOST_REQUIRE(compressor->decompress(&compressed[0], compressed_size,
+                                       &output[0], length));
+  BOOST_CHECK(std::string(&output[0], length) == input);
+}
+
+static std::string repeated_input() {
+  std::string input;
+  for (int i = 0; i < 1000; ++i) {
+    input.append("abcdefghijklmnopqrstuvwxyz");
+  }
+  return input;
+}
+#endif
+
+#ifdef CASS_USE_LZ4
+BOOST_AUTO_TEST_CASE(lz4)
+{
+  std::list<std::string> supported;
+  supported.push_back("snappy");
+  supported.push_back("lz4");
+
+  cass::Compressor::ConstPtr compressor(
+        cass::Compressor::negotiate(CASS_COMPRESSION_LZ4, 4, supported));
+  BOOST_REQUIRE(compressor);
+  BOOST_CHECK_EQUAL(std::string(compressor->name()), "lz4");
+
+  // Not available on protocol version 1
+  compressor.reset(cass::Compressor::negotiate(CASS_COMPRESSION_LZ4, 1, supported));
+  BOOST_CHECK(!compressor);
+  compressor.reset(cass::Compressor::negotiate(CASS_COMPRESSION_LZ4, 4, supported));
+
+  check_round_trip(compressor.get(), repeated_input());
+  check_round_trip(compressor.get(), "x");
+}
+#endif
+
+#ifdef CASS_USE_SNAPPY
+BOOST_AUTO_TEST_CASE(snappy)
+{
+  std::list<std::string> supported;
+  supported.push_back("snappy");
+
+  cass::Compressor::ConstPtr compressor(
+        cass::Compressor::negotiate(CASS_COMPRESSION_LZ4 | CASS_COMPRESSION_SNAPPY,
+                                    1, supported));
+  BOOST_REQUIRE(compressor);
+  BOOST_CHECK_EQUAL(std::string(compressor->name()), "snappy");
+
+  check_round_trip(compressor.get(), repeated_input());
+  check_round_trip(compressor.get(), "x");
+}
+#endif
+
+#if defined(CASS_USE_LZ4) && defined(CASS_USE_SNAPPY)
+BOOST_AUTO_TEST_CASE(prefer_lz4)
+{
+  std::list<std::string> supported;
+  supported.push_back("snappy");
+  supported.push_back("lz4");
+
+  cass::Compressor::ConstPtr compressor(
+        cass::Compressor::negotiate(CASS_COMPRESSION_LZ4 | CASS_COMPRESSION_SNAPPY,
+                                    4, supported));
+  BOOST_REQUIRE(compressor);
+  BOOST_CHECK_EQUAL(std::string(compressor->name()), "lz4");
+}
+#endif
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -22,6 +22,7 @@
 #include "constants.hpp"
 #include "dc_aware_policy.hpp"
 #include "latency_aware_policy.hpp"
+#include "least_outstanding_requests_policy.hpp"
 #include "loop_thread.hpp"
 #include "murmur3.hpp"
 #include "query_request.hpp"
@@ -163,17 +164,17 @@ BOOST_AUTO_TEST_CASE(simple) {
   cass::TokenMap tokenMap;
 
   // start on first elem
-  boost::scoped_ptr<cass::QueryPlan> qp(policy.new_query_plan("ks", NULL, tokenMap, NULL));
+  boost::scoped_ptr<cass::QueryPlan> qp(policy.new_query_plan(tokenMap.keyspace_id("ks"), NULL, tokenMap, NULL, NULL));
   const size_t seq1[] = {1, 2};
   verify_sequence(qp.get(), VECTOR_FROM(size_t, seq1));
 
   // rotate starting element
-  boost::scoped_ptr<cass::QueryPlan> qp2(policy.new_query_plan("ks", NULL, tokenMap, NULL));
+  boost::scoped_ptr<cass::QueryPlan> qp2(policy.new_query_plan(tokenMap.keyspace_id("ks"), NULL, tokenMap, NULL, NULL));
   const size_t seq2[] = {2, 1};
   verify_sequence(qp2.get(), VECTOR_FROM(size_t, seq2));
 
   // back around
-  boost::scoped_ptr<cass::QueryPlan> qp3(policy.new_query_plan("ks", NULL, tokenMap, NULL));
+  boost::scoped_ptr<cass::QueryPlan> qp3(policy.new_query_plan(tokenMap.keyspace_id("ks"), NULL, tokenMap, NULL, NULL));
   verify_sequence(qp3.get(), VECTOR_FROM(size_t, seq1));
 }
 
@@ -188,7 +189,7 @@ BOOST_AUTO_TEST_CASE(on_add)
   cass::TokenMap tokenMap;
 
   // baseline
-  boost::scoped_ptr<cass::QueryPlan> qp(policy.new_query_plan("ks", NULL, tokenMap, NULL));
+  boost::scoped_ptr<cass::QueryPlan> qp(policy.new_query_plan(tokenMap.keyspace_id("ks"), NULL, tokenMap, NULL, NULL));
   const size_t seq1[] = {1, 2};
   verify_sequence(qp.get(), VECTOR_FROM(size_t, seq1));
 
@@ -197,7 +198,7 @@ BOOST_AUTO_TEST_CASE(on_add)
   cass::SharedRefPtr<cass::Host> host = host_for_addr(addr_new);
   policy.on_add(host);
 
-  boost::scoped_ptr<cass::QueryPlan> qp2(policy.new_query_plan("ks", NULL, tokenMap, NULL));
+  boost::scoped_ptr<cass::QueryPlan> qp2(policy.new_query_plan(tokenMap.keyspace_id("ks"), NULL, tokenMap, NULL, NULL));
   const size_t seq2[] = {2, seq_new, 1};
   verify_sequence(qp2.get(), VECTOR_FROM(size_t, seq2));
 }
@@ -212,11 +213,11 @@ BOOST_AUTO_TEST_CASE(on_remove)
 
   cass::TokenMap tokenMap;
 
-  boost::scoped_ptr<cass::QueryPlan> qp(policy.new_query_plan("ks", NULL, tokenMap, NULL));
+  boost::scoped_ptr<cass::QueryPlan> qp(policy.new_query_plan(tokenMap.keyspace_id("ks"), NULL, tokenMap, NULL, NULL));
   cass::SharedRefPtr<cass::Host> host = hosts.begin()->second;
   policy.on_remove(host);
 
-  boost::scoped_ptr<cass::QueryPlan> qp2(policy.new_query_plan("ks", NULL, tokenMap, NULL));
+  boost::scoped_ptr<cass::QueryPlan> qp2(policy.new_query_plan(tokenMap.keyspace_id("ks"), NULL, tokenMap, NULL, NULL));
 
   // first query plan has it
   // (note: not manipulating Host::state_ for dynamic removal)
@@ -238,8 +239,8 @@ BOOST_AUTO_TEST_CASE(on_down_on_up)
 
   cass::TokenMap tokenMap;
 
-  boost::scoped_ptr<cass::QueryPlan> qp_before1(policy.new_query_plan("ks", NULL, tokenMap, NULL));
-  boost::scoped_ptr<cass::QueryPlan> qp_before2(policy.new_query_plan("ks", NULL, tokenMap, NULL));
+  boost::scoped_ptr<cass::QueryPlan> qp_before1(policy.new_query_plan(tokenMap.keyspace_id("ks"), NULL, tokenMap, NULL, NULL));
+  boost::scoped_ptr<cass::QueryPlan> qp_before2(policy.new_query_plan(tokenMap.keyspace_id("ks"), NULL, tokenMap, NULL, NULL));
   cass::SharedRefPtr<cass::Host> host = hosts.begin()->second;
   policy.on_down(host);
 
@@ -260,8 +261,8 @@ BOOST_AUTO_TEST_CASE(on_down_on_up)
   // host is added to the list, but not 'up'
   policy.on_up(host);
 
-  boost::scoped_ptr<cass::QueryPlan> qp_after1(policy.new_query_plan("ks", NULL, tokenMap, NULL));
-  boost::scoped_ptr<cass::QueryPlan> qp_after2(policy.new_query_plan("ks", NULL, tokenMap, NULL));
+  boost::scoped_ptr<cass::QueryPlan> qp_after1(policy.new_query_plan(tokenMap.keyspace_id("ks"), NULL, tokenMap, NULL, NULL));
+  boost::scoped_ptr<cass::QueryPlan> qp_after2(policy.new_query_plan(tokenMap.keyspace_id("ks"), NULL, tokenMap, NULL, NULL));
 
   // 1 is dynamically excluded from plan
   {
@@ -293,7 +294,7 @@ void test_dc_aware_policy(size_t local_count, size_t remote_count) {
   const size_t total_hosts = local_count + remote_count;
   cass::TokenMap tokenMap;
 
-  boost::scoped_ptr<cass::QueryPlan> qp(policy.new_query_plan("ks", NULL, tokenMap, NULL));
+  boost::scoped_ptr<cass::QueryPlan> qp(policy.new_query_plan(tokenMap.keyspace_id("ks"), NULL, tokenMap, NULL, NULL));
   std::vector<size_t> seq(total_hosts);
   for (size_t i = 0; i < total_hosts; ++i) seq[i] = i + 1;
   verify_sequence(qp.get(), seq);
@@ -318,7 +319,7 @@ BOOST_AUTO_TEST_CASE(some_dc_local_unspecified)
   policy.init(cass::SharedRefPtr<cass::Host>(), hosts);
 
   cass::TokenMap tokenMap;
-  boost::scoped_ptr<cass::QueryPlan> qp(policy.new_query_plan("ks", NULL, tokenMap, NULL));
+  boost::scoped_ptr<cass::QueryPlan> qp(policy.new_query_plan(tokenMap.keyspace_id("ks"), NULL, tokenMap, NULL, NULL));
 
   const size_t seq[] = {2, 3, 1};
   verify_sequence(qp.get(), VECTOR_FROM(size_t, seq));
@@ -336,10 +337,10 @@ BOOST_AUTO_TEST_CASE(single_local_down)
 
   cass::TokenMap tokenMap;
 
-  boost::scoped_ptr<cass::QueryPlan> qp_before(policy.new_query_plan("ks", NULL, tokenMap, NULL));// has down host ptr in plan
+  boost::scoped_ptr<cass::QueryPlan> qp_before(policy.new_query_plan(tokenMap.keyspace_id("ks"), NULL, tokenMap, NULL, NULL));// has down host ptr in plan
   target_host->set_down();
   policy.on_down(target_host);
-  boost::scoped_ptr<cass::QueryPlan> qp_after(policy.new_query_plan("ks", NULL, tokenMap, NULL));// should not have down host ptr in plan
+  boost::scoped_ptr<cass::QueryPlan> qp_after(policy.new_query_plan(tokenMap.keyspace_id("ks"), NULL, tokenMap, NULL, NULL));// should not have down host ptr in plan
 
   {
     const size_t seq[] = {2, 3, 4};
@@ -364,10 +365,10 @@ BOOST_AUTO_TEST_CASE(all_local_removed_returned)
 
   cass::TokenMap tokenMap;
 
-  boost::scoped_ptr<cass::QueryPlan> qp_before(policy.new_query_plan("ks", NULL, tokenMap, NULL));// has down host ptr in plan
+  boost::scoped_ptr<cass::QueryPlan> qp_before(policy.new_query_plan(tokenMap.keyspace_id("ks"), NULL, tokenMap, NULL, NULL));// has down host ptr in plan
   target_host->set_down();
   policy.on_down(target_host);
-  boost::scoped_ptr<cass::QueryPlan> qp_after(policy.new_query_plan("ks", NULL, tokenMap, NULL));// should not have down host ptr in plan
+  boost::scoped_ptr<cass::QueryPlan> qp_after(policy.new_query_plan(tokenMap.keyspace_id("ks"), NULL, tokenMap, NULL, NULL));// should not have down host ptr in plan
 
   {
     const size_t seq[] = {2};
@@ -379,13 +380,48 @@ BOOST_AUTO_TEST_CASE(all_local_removed_returned)
   policy.on_up(target_host);
 
   // make sure we get the local node first after on_up
-  boost::scoped_ptr<cass::QueryPlan> qp(policy.new_query_plan("ks", NULL, tokenMap, NULL));
+  boost::scoped_ptr<cass::QueryPlan> qp(policy.new_query_plan(tokenMap.keyspace_id("ks"), NULL, tokenMap, NULL, NULL));
   {
     const size_t seq[] = {1, 2};
     verify_sequence(qp.get(), VECTOR_FROM(size_t, seq));
   }
 }
 
+BOOST_AUTO_TEST_CASE(removed_hosts_kept_by_plan)
+{
+  cass::HostMap hosts;
+  populate_hosts(1, "rack", LOCAL_DC, &hosts);
+  populate_hosts(1, "rack", REMOTE_DC, &hosts);
+  populate_hosts(1, "rack", "remote2", &hosts);
+
+  cass::DCAwarePolicy policy(LOCAL_DC, 1, false);
+  policy.init(cass::SharedRefPtr<cass::Host>(), hosts);
+
+  cass::TokenMap tokenMap;
+  boost::scoped_ptr<cass::QueryPlan> qp(policy.new_query_plan(tokenMap.keyspace_id("ks"), NULL, tokenMap, NULL, NULL));
+
+  // Every host is removed right after the plan returns it. The plan must
+  // keep a reference to each of them until it's destroyed.
+  std::vector<cass::SharedRefPtr<cass::Host> > returned;
+  cass::Host* host;
+  while ((host = qp->compute_next()) != NULL) {
+    cass::SharedRefPtr<cass::Host> removed(hosts[host->address()]);
+    hosts.erase(host->address());
+    policy.on_remove(removed);
+    returned.push_back(removed);
+  }
+
+  BOOST_REQUIRE_EQUAL(returned.size(), 3u);
+  for (size_t i = 0; i < returned.size(); ++i) {
+    BOOST_CHECK_GT(returned[i]->ref_count(), 1);
+  }
+
+  qp.reset();
+  for (size_t i = 0; i < returned.size(); ++i) {
+    BOOST_CHECK_EQUAL(returned[i]->ref_count(), 1);
+  }
+}
+
 BOOST_AUTO_TEST_CASE(remote_removed_returned)
 {
   cass::HostMap hosts;
@@ -399,10 +435,10 @@ BOOST_AUTO_TEST_CASE(remote_removed_returned)
 
   cass::TokenMap tokenMap;
 
-  boost::scoped_ptr<cass::QueryPlan> qp_before(policy.new_query_plan("ks", NULL, tokenMap, NULL));// has down host ptr in plan
+  boost::scoped_ptr<cass::QueryPlan> qp_before(policy.new_query_plan(tokenMap.keyspace_id("ks"), NULL, tokenMap, NULL, NULL));// has down host ptr in plan
   target_host->set_down();
   policy.on_down(target_host);
-  boost::scoped_ptr<cass::QueryPlan> qp_after(policy.new_query_plan("ks", NULL, tokenMap, NULL));// should not have down host ptr in plan
+  boost::scoped_ptr<cass::QueryPlan> qp_after(policy.new_query_plan(tokenMap.keyspace_id("ks"), NULL, tokenMap, NULL, NULL));// should not have down host ptr in plan
 
   {
     const size_t seq[] = {1};
@@ -414,7 +450,7 @@ BOOST_AUTO_TEST_CASE(remote_removed_returned)
   policy.on_up(target_host);
 
   // make sure we get both nodes, correct order after
-  boost::scoped_ptr<cass::QueryPlan> qp(policy.new_query_plan("ks", NULL, tokenMap, NULL));
+  boost::scoped_ptr<cass::QueryPlan> qp(policy.new_query_plan(tokenMap.keyspace_id("ks"), NULL, tokenMap, NULL, NULL));
   {
     const size_t seq[] = {1, 2};
     verify_sequence(qp.get(), VECTOR_FROM(size_t, seq));
@@ -431,7 +467,7 @@ BOOST_AUTO_TEST_CASE(used_hosts_per_remote_dc)
     cass::DCAwarePolicy policy(LOCAL_DC, used_hosts, false);
     policy.init(cass::SharedRefPtr<cass::Host>(), hosts);
 
-    cass::ScopedPtr<cass::QueryPlan> qp(policy.new_query_plan("ks", NULL, cass::TokenMap(), NULL));
+    cass::ScopedPtr<cass::QueryPlan> qp(policy.new_query_plan(cass::INVALID_KEYSPACE_ID, NULL, cass::TokenMap(), NULL, NULL));
     size_t total_hosts = 3 + used_hosts;
     std::vector<size_t> seq(total_hosts);
     for (size_t i = 0; i < total_hosts; ++i) seq[i] = i + 1;
@@ -456,7 +492,7 @@ BOOST_AUTO_TEST_CASE(allow_remote_dcs_for_local_cl)
     request->set_consistency(CASS_CONSISTENCY_LOCAL_ONE);
 
     // Check for only local hosts are used
-    cass::ScopedPtr<cass::QueryPlan> qp(policy.new_query_plan("ks", request.get(), cass::TokenMap(), NULL));
+    cass::ScopedPtr<cass::QueryPlan> qp(policy.new_query_plan(cass::INVALID_KEYSPACE_ID, request.get(), cass::TokenMap(), NULL, NULL));
     const size_t seq[] = {1, 2, 3};
     verify_sequence(qp.get(), VECTOR_FROM(size_t, seq));
   }
@@ -472,7 +508,7 @@ BOOST_AUTO_TEST_CASE(allow_remote_dcs_for_local_cl)
     request->set_consistency(CASS_CONSISTENCY_LOCAL_QUORUM);
 
     // Check for only local hosts are used
-    cass::ScopedPtr<cass::QueryPlan> qp(policy.new_query_plan("ks", request.get(), cass::TokenMap(), NULL));
+    cass::ScopedPtr<cass::QueryPlan> qp(policy.new_query_plan(cass::INVALID_KEYSPACE_ID, request.get(), cass::TokenMap(), NULL, NULL));
     const size_t seq[] = {1, 2, 3, 4, 5, 6};
     verify_sequence(qp.get(), VECTOR_FROM(size_t, seq));
   }
@@ -489,7 +525,7 @@ BOOST_AUTO_TEST_CASE(start_with_empty_local_dc)
     cass::DCAwarePolicy policy("", 0, false);
     policy.init(hosts[cass::Address("2.0.0.0", 4092)], hosts);
 
-    cass::ScopedPtr<cass::QueryPlan> qp(policy.new_query_plan("ks", NULL, cass::TokenMap(), NULL));
+    cass::ScopedPtr<cass::QueryPlan> qp(policy.new_query_plan(cass::INVALID_KEYSPACE_ID, NULL, cass::TokenMap(), NULL, NULL));
     const size_t seq[] = {2, 3, 4};
     verify_sequence(qp.get(), VECTOR_FROM(size_t, seq));
   }
@@ -500,7 +536,7 @@ BOOST_AUTO_TEST_CASE(start_with_empty_local_dc)
     policy.init(cass::SharedRefPtr<cass::Host>(
                   new cass::Host(cass::Address("0.0.0.0", 4092), false)), hosts);
 
-    cass::ScopedPtr<cass::QueryPlan> qp(policy.new_query_plan("ks", NULL, cass::TokenMap(), NULL));
+    cass::ScopedPtr<cass::QueryPlan> qp(policy.new_query_plan(cass::INVALID_KEYSPACE_ID, NULL, cass::TokenMap(), NULL, NULL));
     const size_t seq[] = {1};
     verify_sequence(qp.get(), VECTOR_FROM(size_t, seq));
   }
@@ -552,7 +588,7 @@ BOOST_AUTO_TEST_CASE(simple)
   request->add_key_index(0);
 
   {
-    cass::ScopedPtr<cass::QueryPlan> qp(policy.new_query_plan("test", request.get(), token_map, NULL));
+    cass::ScopedPtr<cass::QueryPlan> qp(policy.new_query_plan(token_map.keyspace_id("test"), request.get(), token_map, NULL, NULL));
     const size_t seq[] = { 4, 1, 2, 3 };
     verify_sequence(qp.get(), VECTOR_FROM(size_t, seq));
   }
@@ -562,7 +598,7 @@ BOOST_AUTO_TEST_CASE(simple)
   curr_host_it->second->set_down();
 
   {
-    cass::ScopedPtr<cass::QueryPlan> qp(policy.new_query_plan("test", request.get(), token_map, NULL));
+    cass::ScopedPtr<cass::QueryPlan> qp(policy.new_query_plan(token_map.keyspace_id("test"), request.get(), token_map, NULL, NULL));
     const size_t seq[] = { 2, 4, 3 };
     verify_sequence(qp.get(), VECTOR_FROM(size_t, seq));
   }
@@ -575,12 +611,74 @@ BOOST_AUTO_TEST_CASE(simple)
   curr_host_it->second->set_down();
 
   {
-    cass::ScopedPtr<cass::QueryPlan> qp(policy.new_query_plan("test", request.get(), token_map, NULL));
+    cass::ScopedPtr<cass::QueryPlan> qp(policy.new_query_plan(token_map.keyspace_id("test"), request.get(), token_map, NULL, NULL));
     const size_t seq[] = { 2, 1, 3 };
     verify_sequence(qp.get(), VECTOR_FROM(size_t, seq));
   }
 }
 
+BOOST_AUTO_TEST_CASE(query_plan_arena)
+{
+  const int64_t num_hosts = 4;
+  cass::HostMap hosts;
+  populate_hosts(num_hosts, "rack1", LOCAL_DC, &hosts);
+  cass::TokenAwarePolicy policy(new cass::DCAwarePolicy(LOCAL_DC, 0, false));
+  cass::TokenMap token_map;
+
+  token_map.set_partitioner(cass::Murmur3Partitioner::PARTITIONER_CLASS);
+  cass::SharedRefPtr<cass::ReplicationStrategy> strategy(new cass::SimpleStrategy("", 3));
+  token_map.set_replication_strategy("test", strategy);
+
+  uint64_t partition_size = CASS_UINT64_MAX / num_hosts;
+  int64_t t = CASS_INT64_MIN + partition_size;
+  for (cass::HostMap::iterator i = hosts.begin(); i != hosts.end(); ++i) {
+    std::string ts = boost::lexical_cast<std::string>(t);
+    cass::TokenStringList tokens;
+    tokens.push_back(cass::StringRef(ts));
+    token_map.update_host(i->second, tokens);
+    t += partition_size;
+  }
+
+  token_map.build();
+  policy.init(cass::SharedRefPtr<cass::Host>(), hosts);
+
+  cass::SharedRefPtr<cass::QueryRequest> request(new cass::QueryRequest(1));
+  const char* value = "kjdfjkldsdjkl"; // hash: 9024137376112061887
+  request->set(0, cass::CassString(value, strlen(value)));
+  request->add_key_index(0);
+
+  // The whole chain of plans fits in the arena
+  {
+    cass::QueryPlanArena arena;
+    cass::ScopedPtr<cass::QueryPlan> qp(policy.new_query_plan(token_map.keyspace_id("test"), request.get(), token_map, NULL, &arena));
+    BOOST_CHECK_EQUAL(arena.heap_allocations(), 0u);
+    const size_t seq[] = { 4, 1, 2, 3 };
+    verify_sequence(qp.get(), VECTOR_FROM(size_t, seq));
+  }
+
+  // The longest chain the config can build also fits
+  {
+    cass::LatencyAwarePolicy::Settings settings;
+    cass::LatencyAwarePolicy latency_policy(
+          new cass::LeastOutstandingRequestsPolicy(
+            new cass::TokenAwarePolicy(new cass::DCAwarePolicy(LOCAL_DC, 0, false))),
+          settings);
+    latency_policy.init(cass::SharedRefPtr<cass::Host>(), hosts);
+    cass::QueryPlanArena arena;
+    cass::ScopedPtr<cass::QueryPlan> qp(latency_policy.new_query_plan(token_map.keyspace_id("test"), request.get(), token_map, NULL, &arena));
+    BOOST_CHECK_EQUAL(arena.heap_allocations(), 0u);
+  }
+
+  // Falls back to the heap when the arena is full
+  {
+    cass::QueryPlanArena arena;
+    while (arena.allocate(1) != NULL) { }
+    cass::ScopedPtr<cass::QueryPlan> qp(policy.new_query_plan(token_map.keyspace_id("test"), request.get(), token_map, NULL, &arena));
+    const size_t seq[] = { 1, 2, 4, 3 }; // Replicas rotated by the second plan
+    verify_sequence(qp.get(), VECTOR_FROM(size_t, seq));
+  }
+}
+
 BOOST_AUTO_TEST_CASE(network_topology)
 {
   const size_t num_hosts = 7;
@@ -633,7 +731,7 @@ BOOST_AUTO_TEST_CASE(network_topology)
   request->add_key_index(0);
 
   {
-    cass::ScopedPtr<cass::QueryPlan> qp(policy.new_query_plan("test", request.get(), token_map, NULL));
+    cass::ScopedPtr<cass::QueryPlan> qp(policy.new_query_plan(token_map.keyspace_id("test"), request.get(), token_map, NULL, NULL));
     const size_t seq[] = { 3, 5, 7, 1, 4, 6, 2 };
     verify_sequence(qp.get(), VECTOR_FROM(size_t, seq));
   }
@@ -643,7 +741,7 @@ BOOST_AUTO_TEST_CASE(network_topology)
   curr_host_it->second->set_down();
 
   {
-    cass::ScopedPtr<cass::QueryPlan> qp(policy.new_query_plan("test", request.get(), token_map, NULL));
+    cass::ScopedPtr<cass::QueryPlan> qp(policy.new_query_plan(token_map.keyspace_id("test"), request.get(), token_map, NULL, NULL));
     const size_t seq[] = { 3, 5, 7, 6, 2, 4 };
     verify_sequence(qp.get(), VECTOR_FROM(size_t, seq));
   }
@@ -655,7 +753,7 @@ BOOST_AUTO_TEST_CASE(network_topology)
   curr_host_it->second->set_down();
 
   {
-    cass::ScopedPtr<cass::QueryPlan> qp(policy.new_query_plan("test", request.get(), token_map, NULL));
+    cass::ScopedPtr<cass::QueryPlan> qp(policy.new_query_plan(token_map.keyspace_id("test"), request.get(), token_map, NULL, NULL));
     const size_t seq[] = { 5, 7, 1, 2, 4, 6 };
     verify_sequence(qp.get(), VECTOR_FROM(size_t, seq));
   }
@@ -765,7 +863,7 @@ BOOST_AUTO_TEST_CASE(simple)
 
   // 1 and 4  are under the minimum, but 2 and 3 will be skipped
   {
-    cass::ScopedPtr<cass::QueryPlan> qp(policy.new_query_plan("", NULL, cass::TokenMap(), NULL));
+    cass::ScopedPtr<cass::QueryPlan> qp(policy.new_query_plan(cass::INVALID_KEYSPACE_ID, NULL, cass::TokenMap(), NULL, NULL));
     const size_t seq1[] = {1, 4, 2, 3};
     verify_sequence(qp.get(), VECTOR_FROM(size_t, seq1));
   }
@@ -775,7 +873,7 @@ BOOST_AUTO_TEST_CASE(simple)
 
   // After waiting no hosts should be skipped (notice 2 and 3 tried first)
   {
-    cass::ScopedPtr<cass::QueryPlan> qp(policy.new_query_plan("", NULL, cass::TokenMap(), NULL));
+    cass::ScopedPtr<cass::QueryPlan> qp(policy.new_query_plan(cass::INVALID_KEYSPACE_ID, NULL, cass::TokenMap(), NULL, NULL));
     const size_t seq1[] = {2, 3, 4, 1};
     verify_sequence(qp.get(), VECTOR_FROM(size_t, seq1));
   }
@@ -817,6 +915,133 @@ BOOST_AUTO_TEST_CASE(min_average_under_min_measured)
 
 BOOST_AUTO_TEST_SUITE_END()
 
+BOOST_AUTO_TEST_SUITE(least_outstanding_requests_lb)
+
+cass::QueryPlan* new_least_outstanding_plan(cass::LoadBalancingPolicy& policy) {
+  cass::TokenMap token_map;
+  return policy.new_query_plan(token_map.keyspace_id("ks"), NULL, token_map, NULL, NULL);
+}
+
+BOOST_AUTO_TEST_CASE(simple)
+{
+  cass::HostMap hosts;
+  populate_hosts(3, "rack", "dc", &hosts);
+  cass::SharedRefPtr<cass::Host> host1(hosts[addr_for_sequence(1)]);
+  cass::SharedRefPtr<cass::Host> host2(hosts[addr_for_sequence(2)]);
+
+  cass::LeastOutstandingRequestsPolicy policy(new cass::RoundRobinPolicy());
+  policy.init(cass::SharedRefPtr<cass::Host>(), hosts);
+
+  {
+    // Ties keep the child's order
+    cass::ScopedPtr<cass::QueryPlan> qp(new_least_outstanding_plan(policy));
+    const size_t seq[] = { 1, 2, 3 };
+    verify_sequence(qp.get(), VECTOR_FROM(size_t, seq));
+  }
+
+  for (int i = 0; i < 3; ++i) host2->inc_inflight_request_count();
+
+  {
+    cass::ScopedPtr<cass::QueryPlan> qp(new_least_outstanding_plan(policy));
+    const size_t seq[] = { 3, 2, 1 };
+    verify_sequence(qp.get(), VECTOR_FROM(size_t, seq));
+  }
+
+  {
+    cass::ScopedPtr<cass::QueryPlan> qp(new_least_outstanding_plan(policy));
+    const size_t seq[] = { 3, 1, 2 };
+    verify_sequence(qp.get(), VECTOR_FROM(size_t, seq));
+  }
+
+  {
+    cass::ScopedPtr<cass::QueryPlan> qp(new_least_outstanding_plan(policy));
+    const size_t seq[] = { 1, 2, 3 };
+    verify_sequence(qp.get(), VECTOR_FROM(size_t, seq));
+  }
+
+  // Only the first two hosts are compared
+  host2->dec_inflight_request_count(3);
+  host1->inc_inflight_request_count();
+
+  {
+    cass::ScopedPtr<cass::QueryPlan> qp(new_least_outstanding_plan(policy));
+    const size_t seq[] = { 2, 3, 1 };
+    verify_sequence(qp.get(), VECTOR_FROM(size_t, seq));
+  }
+
+  {
+    cass::ScopedPtr<cass::QueryPlan> qp(new_least_outstanding_plan(policy));
+    const size_t seq[] = { 3, 1, 2 };
+    verify_sequence(qp.get(), VECTOR_FROM(size_t, seq));
+  }
+
+  {
+    cass::ScopedPtr<cass::QueryPlan> qp(new_least_outstanding_plan(policy));
+    const size_t seq[] = { 2, 1, 3 };
+    verify_sequence(qp.get(), VECTOR_FROM(size_t, seq));
+  }
+}
+
+BOOST_AUTO_TEST_CASE(single_replica)
+{
+  const int64_t num_hosts = 4;
+  cass::HostMap hosts;
+  populate_hosts(num_hosts, "rack1", LOCAL_DC, &hosts);
+  cass::LeastOutstandingRequestsPolicy policy(
+        new cass::TokenAwarePolicy(new cass::RoundRobinPolicy()));
+  cass::TokenMap token_map;
+
+  token_map.set_partitioner(cass::Murmur3Partitioner::PARTITIONER_CLASS);
+  cass::SharedRefPtr<cass::ReplicationStrategy> strategy(new cass::SimpleStrategy("", 1));
+  token_map.set_replication_strategy("test", strategy);
+
+  uint64_t partition_size = CASS_UINT64_MAX / num_hosts;
+  int64_t t = CASS_INT64_MIN + partition_size;
+  for (cass::HostMap::iterator i = hosts.begin(); i != hosts.end(); ++i) {
+    std::string ts = boost::lexical_cast<std::string>(t);
+    cass::TokenStringList tokens;
+    tokens.push_back(cass::StringRef(ts));
+    token_map.update_host(i->second, tokens);
+    t += partition_size;
+  }
+
+  token_map.build();
+  policy.init(cass::SharedRefPtr<cass::Host>(), hosts);
+
+  cass::SharedRefPtr<cass::QueryRequest> request(new cass::QueryRequest(1));
+  const char* value = "kjdfjkldsdjkl"; // hash: 9024137376112061887 (replica: 4.0.0.0)
+  request->set(0, cass::CassString(value, strlen(value)));
+  request->add_key_index(0);
+
+  // The only replica is busier than every other host, but it's still tried
+  // first for every plan
+  hosts[addr_for_sequence(4)]->inc_inflight_request_count(10);
+
+  for (int i = 0; i < 8; ++i) {
+    cass::ScopedPtr<cass::QueryPlan> qp(policy.new_query_plan(token_map.keyspace_id("test"),
+                                                              request.get(), token_map,
+                                                              NULL, NULL));
+    cass::Address received;
+    BOOST_REQUIRE(qp->compute_next(&received));
+    BOOST_CHECK_EQUAL(received, addr_for_sequence(4));
+  }
+}
+
+BOOST_AUTO_TEST_CASE(single_host)
+{
+  cass::HostMap hosts;
+  populate_hosts(1, "rack", "dc", &hosts);
+
+  cass::LeastOutstandingRequestsPolicy policy(new cass::RoundRobinPolicy());
+  policy.init(cass::SharedRefPtr<cass::Host>(), hosts);
+
+  cass::ScopedPtr<cass::QueryPlan> qp(new_least_outstanding_plan(policy));
+  const size_t seq[] = { 1 };
+  verify_sequence(qp.get(), VECTOR_FROM(size_t, seq));
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
 BOOST_AUTO_TEST_SUITE(whitelist_lb)
 
 BOOST_AUTO_TEST_CASE(simple)
@@ -831,7 +1056,7 @@ BOOST_AUTO_TEST_CASE(simple)
   policy.init(cass::SharedRefPtr<cass::Host>(), hosts);
 
   cass::TokenMap tokenMap;
-  boost::scoped_ptr<cass::QueryPlan> qp(policy.new_query_plan("ks", NULL, tokenMap, NULL));
+  boost::scoped_ptr<cass::QueryPlan> qp(policy.new_query_plan(tokenMap.keyspace_id("ks"), NULL, tokenMap, NULL, NULL));
 
   // Verify only hosts 37 and 83 are computed in the query plan
   const size_t seq1[] = { 37, 83 };
@@ -854,7 +1079,7 @@ BOOST_AUTO_TEST_CASE(dc)
   policy.init(cass::SharedRefPtr<cass::Host>(), hosts);
 
   cass::TokenMap tokenMap;
-  boost::scoped_ptr<cass::QueryPlan> qp(policy.new_query_plan("ks", NULL, tokenMap, NULL));
+  boost::scoped_ptr<cass::QueryPlan> qp(policy.new_query_plan(tokenMap.keyspace_id("ks"), NULL, tokenMap, NULL, NULL));
 
   // Verify only hosts LOCAL_DC and REMOTE_DC are computed in the query plan
   const size_t seq1[] = { 1, 2, 3, 7, 8, 9 };
@@ -880,7 +1105,7 @@ BOOST_AUTO_TEST_CASE(simple)
   policy.init(cass::SharedRefPtr<cass::Host>(), hosts);
 
   cass::TokenMap tokenMap;
-  boost::scoped_ptr<cass::QueryPlan> qp(policy.new_query_plan("ks", NULL, tokenMap, NULL));
+  boost::scoped_ptr<cass::QueryPlan> qp(policy.new_query_plan(tokenMap.keyspace_id("ks"), NULL, tokenMap, NULL, NULL));
 
   // Verify only hosts 1, 4 and 5 are computed in the query plan
   const size_t seq1[] = { 1, 4, 5 };
@@ -903,7 +1128,7 @@ BOOST_AUTO_TEST_CASE(dc)
   policy.init(cass::SharedRefPtr<cass::Host>(), hosts);
 
   cass::TokenMap tokenMap;
-  boost::scoped_ptr<cass::QueryPlan> qp(policy.new_query_plan("ks", NULL, tokenMap, NULL));
+  boost::scoped_ptr<cass::QueryPlan> qp(policy.new_query_plan(tokenMap.keyspace_id("ks"), NULL, tokenMap, NULL, NULL));
 
   // Verify only hosts from BACKUP_DC are computed in the query plan
   const size_t seq1[] = { 4, 5, 6 };
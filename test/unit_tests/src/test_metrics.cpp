@@ -133,6 +133,33 @@ BOOST_AUTO_TEST_CASE(histogram)
   BOOST_CHECK(snapshot.stddev == 28);
 }
 
+BOOST_AUTO_TEST_CASE(histogram_multiple_snapshots)
+{
+  cass::Metrics::ThreadState thread_state(1);
+  cass::Metrics::Histogram histogram(&thread_state);
+
+  for (uint64_t i = 1; i <= 100; ++i) {
+    histogram.record_value(i);
+  }
+
+  // Values must only be merged once no matter how many snapshots are taken
+  cass::Metrics::Histogram::Snapshot snapshot;
+  histogram.get_snapshot(&snapshot);
+  histogram.get_snapshot(&snapshot);
+  histogram.get_snapshot(&snapshot);
+
+  for (uint64_t i = 101; i <= 200; ++i) {
+    histogram.record_value(i);
+  }
+
+  histogram.get_snapshot(&snapshot);
+
+  BOOST_CHECK(snapshot.min == 1);
+  BOOST_CHECK(snapshot.max == 200);
+  BOOST_CHECK(snapshot.median == 100);
+  BOOST_CHECK(snapshot.percentile_75th == 150);
+}
+
 BOOST_AUTO_TEST_CASE(histogram_threads)
 {
   HistogramThreadArgs args[NUM_THREADS];
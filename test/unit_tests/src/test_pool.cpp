@@ -0,0 +1,58 @@
+/*
+  Copyright (c) 2014-2016 DataStax
+
+  Licensed under the Apache License, Version 2.0 (the "License");
+  you may not use this file except in compliance with the License.
+  You may obtain a copy of the License at
+
+  http://www.apache.org/licenses/LICENSE-2.0
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+*/
+
+
+#ifdef STAND_ALONE
+#   define BOOST_TEST_MODULE cassandra
+#endif
+
+#include "host.hpp"
+#include "io_worker.hpp"
+#include "pool.hpp"
+#include "session.hpp"
+
+#include <boost/test/unit_test.hpp>
+
+static cass::SharedRefPtr<cass::Host> create_host(const cass::Address& address) {
+  cass::SharedRefPtr<cass::Host> host(new cass::Host(address, false));
+  host->set_up();
+  host->init_io_worker_availability(1);
+  return host;
+}
+
+BOOST_AUTO_TEST_SUITE(pool)
+
+BOOST_AUTO_TEST_CASE(host_removed_and_added_back)
+{
+  cass::Session session;
+  cass::SharedRefPtr<cass::IOWorker> io_worker(new cass::IOWorker(&session, 0));
+
+  cass::Address address("127.0.0.1", 9042);
+  cass::SharedRefPtr<cass::Host> removed_host(create_host(address));
+  cass::SharedRefPtr<cass::Pool> pool(new cass::Pool(io_worker.get(), removed_host, false));
+  io_worker->set_host_is_available(removed_host.get(), false);
+
+  // The host is added back as a new object while its pool still exists.
+  // Hosts start out available so the pool's state must be copied over.
+  cass::SharedRefPtr<cass::Host> added_host(create_host(address));
+  BOOST_CHECK(io_worker->is_host_available(added_host.get()));
+
+  pool->set_host(added_host);
+  BOOST_CHECK(pool->host().get() == added_host.get());
+  BOOST_CHECK(!io_worker->is_host_available(added_host.get()));
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -21,22 +21,16 @@
 #include "address.hpp"
 #include "host.hpp"
 #include "replication_strategy.hpp"
+#include "replication_strategy_utils.hpp"
 
+#include <boost/lexical_cast.hpp>
+#include <boost/random/mersenne_twister.hpp>
 #include <boost/test/unit_test.hpp>
 
 #include <vector>
 #include <set>
 #include <string>
 
-static cass::SharedRefPtr<cass::Host> create_host(const std::string& ip,
-                                                  const std::string& rack = "",
-                                                  const std::string& dc = "") {
-  cass::SharedRefPtr<cass::Host> host =
-      cass::SharedRefPtr<cass::Host>(new cass::Host(cass::Address(ip, 4092), false));
-  host->set_rack_and_dc(rack, dc);
-  return host;
-}
-
 void check_host(const cass::SharedRefPtr<cass::Host>& host,
                 const std::string& ip,
                 const std::string& rack = "",
@@ -46,6 +40,16 @@ void check_host(const cass::SharedRefPtr<cass::Host>& host,
   BOOST_CHECK(host->dc() == dc);
 }
 
+static bool equal_replicas(const cass::TokenReplicaMap& lhs,
+                           const cass::TokenReplicaMap& rhs) {
+  if (lhs.size() != rhs.size()) return false;
+  for (cass::TokenReplicaMap::const_iterator i = lhs.begin(), j = rhs.begin();
+       i != lhs.end(); ++i, ++j) {
+    if (i->first != j->first || *i->second != *j->second) return false;
+  }
+  return true;
+}
+
 BOOST_AUTO_TEST_SUITE(replication_strategy)
 
 BOOST_AUTO_TEST_CASE(simple)
@@ -343,4 +347,120 @@ BOOST_AUTO_TEST_CASE(network_topology_not_enough_racks)
   }
 }
 
+BOOST_AUTO_TEST_CASE(update_replicas)
+{
+  cass::NetworkTopologyStrategy::DCReplicaCountMap dc_replicas;
+  dc_replicas["dc1"] = 3;
+  dc_replicas["dc2"] = 2;
+
+  std::vector<cass::SharedRefPtr<cass::ReplicationStrategy> > strategies;
+  strategies.push_back(cass::SharedRefPtr<cass::ReplicationStrategy>(
+                         new cass::NetworkTopologyStrategy("NetworkTopologyStrategy", dc_replicas)));
+  strategies.push_back(cass::SharedRefPtr<cass::ReplicationStrategy>(
+                         new cass::SimpleStrategy("SimpleStrategy", 3)));
+  strategies.push_back(cass::SharedRefPtr<cass::ReplicationStrategy>(
+                         new cass::NonReplicatedStrategy("")));
+
+  for (size_t s = 0; s < strategies.size(); ++s) {
+    const cass::ReplicationStrategy& strategy = *strategies[s];
+    boost::mt19937_64 ng;
+
+    cass::TokenHostMap primary;
+    cass::HostVec hosts;
+    cass::TokenVec unused;
+    // Every rack has a host that's never removed so the racks don't change
+    for (int i = 0; i < 12; ++i) {
+      std::string ip("1.0.0." + boost::lexical_cast<std::string>(i + 1));
+      cass::SharedRefPtr<cass::Host> host(
+            create_host(ip, "rack" + boost::lexical_cast<std::string>(i % 3),
+                        i % 2 == 0 ? "dc1" : "dc2"));
+      add_tokens(host, 8, ng, &primary, &unused);
+    }
+
+    cass::ReplicaSetPool pool;
+    cass::TokenReplicaMap replicas;
+    strategy.tokens_to_replicas(primary, &replicas, &pool);
+    cass::DCRackMap racks(cass::racks_in_dcs(primary));
+
+    for (int i = 0; i < 40; ++i) {
+      cass::TokenVec added;
+      cass::TokenVec removed;
+
+      if (hosts.empty() || ng() % 3 != 0) {
+        std::string ip("2.0.0." + boost::lexical_cast<std::string>(i + 1));
+        cass::SharedRefPtr<cass::Host> host(
+              create_host(ip, "rack" + boost::lexical_cast<std::string>(ng() % 3),
+                          ng() % 2 == 0 ? "dc1" : "dc2"));
+        add_tokens(host, 1 + ng() % 8, ng, &primary, &added);
+        hosts.push_back(host);
+      } else {
+        size_t index = ng() % hosts.size();
+        remove_tokens(hosts[index], &primary, &removed);
+        if (ng() % 2 == 0) {
+          // Moved
+          add_tokens(hosts[index], 1 + ng() % 8, ng, &primary, &added);
+        } else {
+          hosts.erase(hosts.begin() + index);
+        }
+      }
+
+      BOOST_REQUIRE(cass::racks_in_dcs(primary) == racks);
+      strategy.update_replicas(cass::HostRing(primary, racks), added, removed, &replicas, &pool);
+      pool.purge();
+      BOOST_CHECK(pool.size() <= replicas.size());
+
+      cass::TokenReplicaMap expected;
+      strategy.tokens_to_replicas(primary, &expected);
+      BOOST_REQUIRE(equal_replicas(replicas, expected));
+    }
+  }
+}
+
+BOOST_AUTO_TEST_CASE(tokens_to_replicas_threads)
+{
+  cass::NetworkTopologyStrategy::DCReplicaCountMap dc_replicas;
+  dc_replicas["dc1"] = 3;
+  dc_replicas["dc2"] = 2;
+
+  std::vector<cass::SharedRefPtr<cass::ReplicationStrategy> > strategies;
+  strategies.push_back(cass::SharedRefPtr<cass::ReplicationStrategy>(
+                         new cass::NetworkTopologyStrategy("NetworkTopologyStrategy", dc_replicas)));
+  strategies.push_back(cass::SharedRefPtr<cass::ReplicationStrategy>(
+                         new cass::SimpleStrategy("SimpleStrategy", 3)));
+
+  boost::mt19937_64 ng;
+  cass::TokenHostMap primary;
+  cass::TokenVec unused;
+  for (int i = 0; i < 12; ++i) {
+    std::string ip("1.0.0." + boost::lexical_cast<std::string>(i + 1));
+    add_tokens(create_host(ip, "rack" + boost::lexical_cast<std::string>(i % 3),
+                           i % 2 == 0 ? "dc1" : "dc2"),
+               16, ng, &primary, &unused);
+  }
+
+  // The ranges built on each thread must merge into the same map as a build
+  // on a single thread, including more threads than tokens
+  const size_t num_threads[] = { 2, 3, 7, 16, primary.size() + 1 };
+
+  for (size_t s = 0; s < strategies.size(); ++s) {
+    const cass::ReplicationStrategy& strategy = *strategies[s];
+
+    cass::TokenReplicaMap expected;
+    strategy.tokens_to_replicas(primary, &expected, NULL, 1);
+    BOOST_REQUIRE_EQUAL(expected.size(), primary.size());
+
+    for (size_t i = 0; i < sizeof(num_threads) / sizeof(num_threads[0]); ++i) {
+      cass::TokenReplicaMap replicas;
+      strategy.tokens_to_replicas(primary, &replicas, NULL, num_threads[i]);
+      BOOST_CHECK(equal_replicas(replicas, expected));
+
+      cass::ReplicaSetPool pool;
+      cass::TokenReplicaMap pooled;
+      strategy.tokens_to_replicas(primary, &pooled, &pool, num_threads[i]);
+      BOOST_CHECK(equal_replicas(pooled, expected));
+      BOOST_CHECK(pool.size() <= pooled.size());
+    }
+  }
+}
+
 BOOST_AUTO_TEST_SUITE_END()
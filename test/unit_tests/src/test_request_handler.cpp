@@ -0,0 +1,325 @@
+/*
+  Copyright (c) 2014-2016 DataStax
+
+  Licensed under the Apache License, Version 2.0 (the "License");
+  you may not use this file except in compliance with the License.
+  You may obtain a copy of the License at
+
+  http://www.apache.org/licenses/LICENSE-2.0
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+*/
+
+
+#ifdef STAND_ALONE
+#   define BOOST_TEST_MODULE cassandra
+#endif
+
+#include "host.hpp"
+#include "metrics.hpp"
+#include "query_request.hpp"
+#include "request_handler.hpp"
+#include "result_response.hpp"
+#include "retry_policy.hpp"
+#include "round_robin_policy.hpp"
+#include "token_map.hpp"
+
+#include <boost/test/unit_test.hpp>
+
+#include <uv.h>
+
+#define NUM_HOSTS 3
+
+// A request and its speculative executions, each on a different host. The
+// handlers aren't run on an IO worker so they're completed directly.
+struct Executions {
+  Executions()
+    : metrics(1)
+    , future(new cass::ResponseFuture())
+    , request(new cass::QueryRequest("SELECT * FROM table")) {
+    cass::HostMap hosts;
+    for (int i = 1; i <= NUM_HOSTS; ++i) {
+      cass::Address address("127.0.0.1", 9042);
+      address.addr_in()->sin_addr.s_addr = i;
+      cass::SharedRefPtr<cass::Host> host(new cass::Host(address, false));
+      host->set_up();
+      hosts[address] = host;
+    }
+    policy.init(cass::SharedRefPtr<cass::Host>(), hosts);
+
+    origin = cass::SharedRefPtr<cass::RequestHandler>(
+               new cass::RequestHandler(request.get(), future.get(), &retry_policy));
+    origin->inc_ref(); // IOWorker reference
+    origin->set_metrics(&metrics);
+    origin->set_query_plan(policy.new_query_plan(token_map.keyspace_id("ks"),
+                                                 NULL, token_map, NULL, NULL));
+    origin->next_host();
+
+    handlers[0] = origin.get();
+    for (int i = 1; i < NUM_HOSTS; ++i) {
+      handlers[i] = origin->new_speculative_execution();
+      BOOST_REQUIRE(handlers[i] != NULL);
+    }
+  }
+
+  cass::Metrics metrics;
+  cass::RoundRobinPolicy policy;
+  cass::TokenMap token_map;
+  cass::DefaultRetryPolicy retry_policy;
+  cass::SharedRefPtr<cass::ResponseFuture> future;
+  cass::SharedRefPtr<cass::Request> request;
+  // Keeps the shared state alive after the executions finish
+  cass::SharedRefPtr<cass::RequestHandler> origin;
+  cass::RequestHandler* handlers[NUM_HOSTS];
+};
+
+BOOST_AUTO_TEST_SUITE(request_handler)
+
+BOOST_AUTO_TEST_CASE(query_plan_exhausted)
+{
+  Executions executions;
+  BOOST_CHECK(executions.origin->new_speculative_execution() == NULL);
+  BOOST_CHECK_EQUAL(executions.origin->running_executions(), NUM_HOSTS);
+}
+
+BOOST_AUTO_TEST_CASE(first_response_wins)
+{
+  Executions executions;
+  BOOST_CHECK_EQUAL(executions.origin->running_executions(), NUM_HOSTS);
+
+  cass::SharedRefPtr<cass::Response> first(new cass::ResultResponse());
+  cass::Address address = executions.handlers[1]->current_host()->address();
+  executions.handlers[1]->set_response(first);
+  BOOST_REQUIRE(executions.future->ready());
+  BOOST_CHECK_EQUAL(executions.origin->running_executions(), NUM_HOSTS - 1);
+
+  // The later executions are discarded
+  executions.handlers[0]->set_response(cass::SharedRefPtr<cass::Response>(new cass::ResultResponse()));
+  executions.handlers[2]->on_error(CASS_ERROR_LIB_REQUEST_TIMED_OUT, "Request timed out");
+  BOOST_CHECK_EQUAL(executions.origin->running_executions(), 0);
+
+  BOOST_CHECK(executions.future->get_error() == NULL);
+  BOOST_CHECK(executions.future->response().get() == first.get());
+  BOOST_CHECK_EQUAL(executions.future->get_host_address(), address);
+  BOOST_CHECK_EQUAL(executions.metrics.speculative_wins.sum(), 1);
+}
+
+BOOST_AUTO_TEST_CASE(original_response_is_not_a_win)
+{
+  Executions executions;
+
+  executions.handlers[0]->set_response(cass::SharedRefPtr<cass::Response>(new cass::ResultResponse()));
+  executions.handlers[1]->set_response(cass::SharedRefPtr<cass::Response>(new cass::ResultResponse()));
+  executions.handlers[2]->set_response(cass::SharedRefPtr<cass::Response>(new cass::ResultResponse()));
+
+  BOOST_CHECK(executions.future->get_error() == NULL);
+  BOOST_CHECK_EQUAL(executions.origin->running_executions(), 0);
+  BOOST_CHECK_EQUAL(executions.metrics.speculative_wins.sum(), 0);
+}
+
+BOOST_AUTO_TEST_CASE(error_waits_for_other_executions)
+{
+  Executions executions;
+
+  // The slow execution times out but the others are still running
+  executions.handlers[2]->on_error(CASS_ERROR_LIB_REQUEST_TIMED_OUT, "Request timed out");
+  BOOST_CHECK(!executions.future->ready());
+  BOOST_CHECK_EQUAL(executions.origin->running_executions(), NUM_HOSTS - 1);
+
+  cass::SharedRefPtr<cass::Response> response(new cass::ResultResponse());
+  executions.handlers[1]->set_response(response);
+  BOOST_REQUIRE(executions.future->ready());
+
+  // An error after the response is discarded
+  executions.handlers[0]->on_error(CASS_ERROR_LIB_REQUEST_TIMED_OUT, "Request timed out");
+  BOOST_CHECK_EQUAL(executions.origin->running_executions(), 0);
+
+  BOOST_CHECK(executions.future->get_error() == NULL);
+  BOOST_CHECK(executions.future->response().get() == response.get());
+  BOOST_CHECK_EQUAL(executions.metrics.speculative_wins.sum(), 1);
+}
+
+BOOST_AUTO_TEST_CASE(last_error_fails_the_request)
+{
+  Executions executions;
+
+  executions.handlers[0]->on_error(CASS_ERROR_LIB_REQUEST_TIMED_OUT, "Request timed out");
+  executions.handlers[1]->on_error(CASS_ERROR_LIB_REQUEST_TIMED_OUT, "Request timed out");
+  BOOST_CHECK(!executions.future->ready());
+
+  cass::Address address = executions.handlers[2]->current_host()->address();
+  executions.handlers[2]->on_error(CASS_ERROR_SERVER_WRITE_TIMEOUT, "Write timeout");
+  BOOST_REQUIRE(executions.future->ready());
+  BOOST_CHECK_EQUAL(executions.origin->running_executions(), 0);
+
+  const cass::Future::Error* error = executions.future->get_error();
+  BOOST_REQUIRE(error != NULL);
+  BOOST_CHECK_EQUAL(error->code, CASS_ERROR_SERVER_WRITE_TIMEOUT);
+  BOOST_CHECK_EQUAL(executions.future->get_host_address(), address);
+  BOOST_CHECK_EQUAL(executions.metrics.speculative_wins.sum(), 0);
+}
+
+BOOST_AUTO_TEST_CASE(no_hosts_available_uses_earlier_error)
+{
+  Executions executions;
+
+  cass::Address address = executions.handlers[1]->current_host()->address();
+  executions.handlers[1]->on_error(CASS_ERROR_LIB_REQUEST_TIMED_OUT, "Request timed out");
+  executions.handlers[0]->on_error(CASS_ERROR_LIB_NO_HOSTS_AVAILABLE, "No hosts available");
+  BOOST_CHECK(!executions.future->ready());
+
+  // Running out of hosts isn't as useful as the timeout
+  executions.handlers[2]->on_error(CASS_ERROR_LIB_NO_HOSTS_AVAILABLE, "No hosts available");
+  BOOST_REQUIRE(executions.future->ready());
+
+  const cass::Future::Error* error = executions.future->get_error();
+  BOOST_REQUIRE(error != NULL);
+  BOOST_CHECK_EQUAL(error->code, CASS_ERROR_LIB_REQUEST_TIMED_OUT);
+  BOOST_CHECK_EQUAL(executions.future->get_host_address(), address);
+}
+
+BOOST_AUTO_TEST_CASE(speculative_win_latency)
+{
+  Executions executions;
+
+  // The request's latency starts with the original execution, not with the
+  // speculative execution that wins
+  uint64_t now = uv_hrtime();
+  executions.handlers[0]->set_start_time_ns(now - 100 * 1000 * 1000);
+  executions.handlers[1]->set_start_time_ns(now);
+  executions.handlers[1]->set_response(cass::SharedRefPtr<cass::Response>(new cass::ResultResponse()));
+  BOOST_REQUIRE(executions.future->ready());
+
+  cass::Metrics::Histogram::Snapshot snapshot;
+  executions.metrics.request_latencies.get_snapshot(&snapshot);
+  // In microseconds, with the histogram's precision
+  BOOST_CHECK_GE(snapshot.min, 99 * 1000);
+}
+
+BOOST_AUTO_TEST_CASE(no_hosts_available_waits_for_other_executions)
+{
+  Executions executions;
+
+  // Running out of hosts doesn't fail the request while other executions
+  // are still running
+  executions.handlers[0]->on_error(CASS_ERROR_LIB_NO_HOSTS_AVAILABLE, "No hosts available");
+  executions.handlers[1]->on_error(CASS_ERROR_LIB_NO_HOSTS_AVAILABLE, "No hosts available");
+  BOOST_CHECK(!executions.future->ready());
+  BOOST_CHECK_EQUAL(executions.origin->running_executions(), 1);
+
+  executions.handlers[2]->on_error(CASS_ERROR_LIB_NO_HOSTS_AVAILABLE, "No hosts available");
+  BOOST_REQUIRE(executions.future->ready());
+  BOOST_CHECK_EQUAL(executions.origin->running_executions(), 0);
+
+  const cass::Future::Error* error = executions.future->get_error();
+  BOOST_REQUIRE(error != NULL);
+  BOOST_CHECK_EQUAL(error->code, CASS_ERROR_LIB_NO_HOSTS_AVAILABLE);
+  BOOST_CHECK_EQUAL(executions.metrics.speculative_wins.sum(), 0);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+// The sub-futures of a MultiResponseFuture, one for each request
+struct MultiFuture {
+  MultiFuture()
+    : future(new cass::MultiResponseFuture(NUM_HOSTS)) {
+    for (int i = 0; i < NUM_HOSTS; ++i) {
+      addresses[i] = cass::Address("127.0.0.1", 9042);
+      addresses[i].addr_in()->sin_addr.s_addr = i + 1;
+      responses[i] = cass::SharedRefPtr<cass::Response>(new cass::ResultResponse());
+      sub_futures[i] = cass::SharedRefPtr<cass::ResponseFuture>(new cass::ResponseFuture());
+      future->add(sub_futures[i].get());
+    }
+  }
+
+  void set_response(int i) {
+    sub_futures[i]->set_response(addresses[i], responses[i]);
+  }
+
+  void set_error(int i, CassError code) {
+    sub_futures[i]->set_error_with_host_address(addresses[i], code, "Error");
+  }
+
+  void set_error_with_response(int i, CassError code) {
+    sub_futures[i]->set_error_with_response(addresses[i], responses[i], code, "Error");
+  }
+
+  cass::SharedRefPtr<cass::MultiResponseFuture> future;
+  cass::Address addresses[NUM_HOSTS];
+  cass::SharedRefPtr<cass::Response> responses[NUM_HOSTS];
+  cass::SharedRefPtr<cass::ResponseFuture> sub_futures[NUM_HOSTS];
+};
+
+BOOST_AUTO_TEST_SUITE(multi_response_future)
+
+BOOST_AUTO_TEST_CASE(first_response)
+{
+  MultiFuture multi;
+
+  multi.set_response(2);
+  multi.set_response(0);
+  BOOST_CHECK(!multi.future->ready());
+  multi.set_response(1);
+  BOOST_REQUIRE(multi.future->ready());
+
+  BOOST_CHECK(multi.future->get_error() == NULL);
+  BOOST_CHECK(multi.future->response().get() == multi.responses[2].get());
+  BOOST_CHECK_EQUAL(multi.future->get_host_address(), multi.addresses[2]);
+}
+
+BOOST_AUTO_TEST_CASE(first_error_wins)
+{
+  MultiFuture multi;
+
+  multi.set_response(0);
+  multi.set_error(1, CASS_ERROR_LIB_REQUEST_TIMED_OUT);
+  BOOST_CHECK(!multi.future->ready());
+  multi.set_error(2, CASS_ERROR_LIB_NO_HOSTS_AVAILABLE);
+  BOOST_REQUIRE(multi.future->ready());
+
+  const cass::Future::Error* error = multi.future->get_error();
+  BOOST_REQUIRE(error != NULL);
+  BOOST_CHECK_EQUAL(error->code, CASS_ERROR_LIB_REQUEST_TIMED_OUT);
+  BOOST_CHECK_EQUAL(multi.future->get_host_address(), multi.addresses[1]);
+  BOOST_CHECK(!multi.future->response());
+}
+
+BOOST_AUTO_TEST_CASE(error_after_responses)
+{
+  MultiFuture multi;
+
+  multi.set_response(1);
+  multi.set_response(0);
+  BOOST_CHECK(!multi.future->ready());
+  multi.set_error_with_response(2, CASS_ERROR_SERVER_WRITE_TIMEOUT);
+  BOOST_REQUIRE(multi.future->ready());
+
+  // The error's response replaces the earlier successful responses
+  const cass::Future::Error* error = multi.future->get_error();
+  BOOST_REQUIRE(error != NULL);
+  BOOST_CHECK_EQUAL(error->code, CASS_ERROR_SERVER_WRITE_TIMEOUT);
+  BOOST_CHECK(multi.future->response().get() == multi.responses[2].get());
+  BOOST_CHECK_EQUAL(multi.future->get_host_address(), multi.addresses[2]);
+}
+
+BOOST_AUTO_TEST_CASE(first_error_with_response_wins)
+{
+  MultiFuture multi;
+
+  multi.set_error_with_response(0, CASS_ERROR_SERVER_UNAVAILABLE);
+  multi.set_error(2, CASS_ERROR_LIB_REQUEST_TIMED_OUT);
+  multi.set_response(1);
+  BOOST_REQUIRE(multi.future->ready());
+
+  const cass::Future::Error* error = multi.future->get_error();
+  BOOST_REQUIRE(error != NULL);
+  BOOST_CHECK_EQUAL(error->code, CASS_ERROR_SERVER_UNAVAILABLE);
+  BOOST_CHECK(multi.future->response().get() == multi.responses[0].get());
+  BOOST_CHECK_EQUAL(multi.future->get_host_address(), multi.addresses[0]);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,167 @@
+/*
+  Copyright (c) 2014-2016 DataStax
+
+  Licensed under the Apache License, Version 2.0 (the "License");
+  you may not use this file except in compliance with the License.
+  You may obtain a copy of the License at
+
+  http://www.apache.org/licenses/LICENSE-2.0
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+*/
+
+
+#ifdef STAND_ALONE
+#   define BOOST_TEST_MODULE cassandra
+#endif
+
+#include "metrics.hpp"
+#include "response_buffer_pool.hpp"
+
+#include <boost/test/unit_test.hpp>
+
+#include <string.h>
+#include <vector>
+#include <uv.h>
+
+#define NUM_BUFFERS 64
+
+struct ReleaseThreadArgs {
+  uv_thread_t thread;
+  std::vector<cass::SharedRefPtr<cass::RefBuffer> > buffers;
+};
+
+void release_thread(void* data) {
+  ReleaseThreadArgs* args = static_cast<ReleaseThreadArgs*>(data);
+  args->buffers.clear();
+}
+
+BOOST_AUTO_TEST_SUITE(response_buffer_pool)
+
+BOOST_AUTO_TEST_CASE(capacity)
+{
+  BOOST_CHECK_EQUAL(cass::ResponseBufferPool::capacity(0), 256u);
+  BOOST_CHECK_EQUAL(cass::ResponseBufferPool::capacity(1), 256u);
+  BOOST_CHECK_EQUAL(cass::ResponseBufferPool::capacity(256), 256u);
+  BOOST_CHECK_EQUAL(cass::ResponseBufferPool::capacity(257), 512u);
+  BOOST_CHECK_EQUAL(cass::ResponseBufferPool::capacity(5000), 8192u);
+  BOOST_CHECK_EQUAL(cass::ResponseBufferPool::capacity(1024 * 1024), 1024u * 1024u);
+  // Too large to be pooled
+  BOOST_CHECK_EQUAL(cass::ResponseBufferPool::capacity(1024 * 1024 + 1), 1024u * 1024u + 1);
+}
+
+BOOST_AUTO_TEST_CASE(reuse)
+{
+  cass::Metrics metrics(1);
+  cass::ResponseBufferPool::Ptr pool(new cass::ResponseBufferPool(&metrics));
+
+  char* data;
+  {
+    cass::SharedRefPtr<cass::RefBuffer> buffer(pool->acquire(1000));
+    data = buffer->data();
+    memset(data, 'a', 1000);
+  }
+
+  // Same size class
+  cass::SharedRefPtr<cass::RefBuffer> buffer(pool->acquire(1024));
+  BOOST_CHECK(buffer->data() == data);
+
+  // Different size class
+  cass::SharedRefPtr<cass::RefBuffer> other(pool->acquire(100));
+  BOOST_CHECK(other->data() != data);
+
+  BOOST_CHECK_EQUAL(metrics.response_buffer_pool_hits.sum(), 1);
+  BOOST_CHECK_EQUAL(metrics.response_buffer_pool_misses.sum(), 2);
+}
+
+BOOST_AUTO_TEST_CASE(large_buffers_are_not_pooled)
+{
+  cass::Metrics metrics(1);
+  cass::ResponseBufferPool::Ptr pool(new cass::ResponseBufferPool(&metrics));
+
+  size_t size = 2 * 1024 * 1024;
+  for (int i = 0; i < 2; ++i) {
+    cass::SharedRefPtr<cass::RefBuffer> buffer(pool->acquire(size));
+    memset(buffer->data(), 'a', size);
+  }
+
+  BOOST_CHECK_EQUAL(metrics.response_buffer_pool_hits.sum(), 0);
+  BOOST_CHECK_EQUAL(metrics.response_buffer_pool_misses.sum(), 0);
+}
+
+BOOST_AUTO_TEST_CASE(release_on_another_thread)
+{
+  cass::Metrics metrics(1);
+  cass::ResponseBufferPool::Ptr pool(new cass::ResponseBufferPool(&metrics));
+
+  ReleaseThreadArgs args;
+  for (int i = 0; i < NUM_BUFFERS; ++i) {
+    args.buffers.push_back(cass::SharedRefPtr<cass::RefBuffer>(pool->acquire(4096)));
+  }
+
+  uv_thread_create(&args.thread, release_thread, &args);
+  uv_thread_join(&args.thread);
+
+  std::vector<cass::SharedRefPtr<cass::RefBuffer> > buffers;
+  for (int i = 0; i < NUM_BUFFERS; ++i) {
+    buffers.push_back(cass::SharedRefPtr<cass::RefBuffer>(pool->acquire(4096)));
+  }
+
+  BOOST_CHECK_EQUAL(metrics.response_buffer_pool_hits.sum(), NUM_BUFFERS);
+  BOOST_CHECK_EQUAL(metrics.response_buffer_pool_misses.sum(), NUM_BUFFERS);
+}
+
+BOOST_AUTO_TEST_CASE(trim)
+{
+  cass::Metrics metrics(1);
+  cass::ResponseBufferPool::Ptr pool(new cass::ResponseBufferPool(&metrics));
+
+  BOOST_CHECK_EQUAL(pool->trim(), 0u);
+
+  {
+    cass::SharedRefPtr<cass::RefBuffer> small(pool->acquire(100));
+    cass::SharedRefPtr<cass::RefBuffer> large(pool->acquire(5000));
+  }
+
+  BOOST_CHECK_EQUAL(pool->trim(), 256u + 8192u);
+  BOOST_CHECK_EQUAL(pool->trim(), 0u);
+
+  // The trimmed buffers are allocated again
+  cass::SharedRefPtr<cass::RefBuffer> buffer(pool->acquire(100));
+  BOOST_CHECK_EQUAL(metrics.response_buffer_pool_hits.sum(), 0);
+  BOOST_CHECK_EQUAL(metrics.response_buffer_pool_misses.sum(), 3);
+}
+
+BOOST_AUTO_TEST_CASE(trim_if_idle)
+{
+  cass::ResponseBufferPool::Ptr pool(new cass::ResponseBufferPool(NULL));
+
+  cass::SharedRefPtr<cass::RefBuffer>(pool->acquire(100));
+
+  // Buffers were acquired since the last check
+  BOOST_CHECK_EQUAL(pool->trim_if_idle(), 0u);
+  BOOST_CHECK_EQUAL(pool->trim_if_idle(), 256u);
+
+  cass::SharedRefPtr<cass::RefBuffer>(pool->acquire(100));
+  BOOST_CHECK_EQUAL(pool->trim_if_idle(), 0u);
+  cass::SharedRefPtr<cass::RefBuffer>(pool->acquire(100));
+  BOOST_CHECK_EQUAL(pool->trim_if_idle(), 0u);
+  BOOST_CHECK_EQUAL(pool->trim_if_idle(), 256u);
+}
+
+BOOST_AUTO_TEST_CASE(buffers_outlive_pool)
+{
+  cass::ResponseBufferPool::Ptr pool(new cass::ResponseBufferPool(NULL));
+  cass::SharedRefPtr<cass::RefBuffer> buffer(pool->acquire(100));
+  BOOST_CHECK_EQUAL(pool->ref_count(), 2);
+
+  pool.reset();
+  memset(buffer->data(), 'a', 100);
+  buffer.reset(); // Releases the pool
+}
+
+BOOST_AUTO_TEST_SUITE_END()
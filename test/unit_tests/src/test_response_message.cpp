@@ -0,0 +1,138 @@
+/*
+  Copyright (c) 2014-2016 DataStax
+
+  Licensed under the Apache License, Version 2.0 (the "License");
+  you may not use this file except in compliance with the License.
+  You may obtain a copy of the License at
+
+  http://www.apache.org/licenses/LICENSE-2.0
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+*/
+
+
+#ifdef STAND_ALONE
+#   define BOOST_TEST_MODULE cassandra
+#endif
+
+#include "constants.hpp"
+#include "response.hpp"
+#include "result_response.hpp"
+#include "serialization.hpp"
+
+#include <boost/test/unit_test.hpp>
+
+#include <algorithm>
+#include <string.h>
+#include <string>
+#include <vector>
+#include <uv.h>
+
+#define READ_SIZE 64 * 1024
+
+// Builds a protocol v4 RESULT frame with "row_count" rows of one "value_size"
+// byte column
+static std::vector<char> build_rows_frame(int16_t stream, int32_t row_count, size_t value_size) {
+  size_t body_size = 4 * sizeof(int32_t) + row_count * (sizeof(int32_t) + value_size);
+  std::vector<char> frame(CASS_HEADER_SIZE_V3 + body_size);
+
+  char* pos = &frame[0];
+  pos = cass::encode_byte(pos, 0x84); // Response, version 4
+  pos = cass::encode_byte(pos, 0); // Flags
+  cass::encode_int16(pos, stream); pos += sizeof(int16_t);
+  pos = cass::encode_byte(pos, CQL_OPCODE_RESULT);
+  cass::encode_int32(pos, static_cast<int32_t>(body_size)); pos += sizeof(int32_t);
+
+  cass::encode_int32(pos, CASS_RESULT_KIND_ROWS); pos += sizeof(int32_t);
+  cass::encode_int32(pos, CASS_RESULT_FLAG_NO_METADATA); pos += sizeof(int32_t);
+  cass::encode_int32(pos, 1); pos += sizeof(int32_t); // Column count
+  cass::encode_int32(pos, row_count); pos += sizeof(int32_t);
+  for (int32_t i = 0; i < row_count; ++i) {
+    cass::encode_int32(pos, static_cast<int32_t>(value_size)); pos += sizeof(int32_t);
+    memset(pos, 'a' + i % 26, value_size); pos += value_size;
+  }
+
+  return frame;
+}
+
+// Decodes a frame the way the connection reads it from the socket. "input"
+// stands in for the socket and every read copies up to READ_SIZE bytes into
+// a read buffer. When "is_direct" is set the rest of a large body is read
+// straight into the response's buffer instead.
+static bool decode_frame(const std::vector<char>& input, bool is_direct,
+                         cass::ResponseMessage* response) {
+  std::vector<char> read_buffer(READ_SIZE);
+  size_t offset = 0;
+  while (offset < input.size() && !response->is_body_ready()) {
+    size_t body_remaining = response->body_remaining();
+    char* buffer = &read_buffer[0];
+    size_t size = READ_SIZE;
+    if (is_direct && body_remaining >= READ_SIZE) {
+      buffer = response->body_buffer_pos();
+      size = body_remaining;
+    }
+    size = std::min(size, input.size() - offset);
+    memcpy(buffer, &input[offset], size);
+    if (response->decode(buffer, size, NULL) != static_cast<ssize_t>(size)) {
+      return false;
+    }
+    offset += size;
+  }
+  return response->is_body_ready();
+}
+
+BOOST_AUTO_TEST_SUITE(response_message)
+
+BOOST_AUTO_TEST_CASE(body_remaining)
+{
+  std::vector<char> frame = build_rows_frame(1, 10, 16);
+  cass::ResponseMessage response;
+
+  BOOST_CHECK_EQUAL(response.body_remaining(), 0u);
+
+  // A partial header
+  BOOST_CHECK_EQUAL(response.decode(&frame[0], 4, NULL), 4);
+  BOOST_CHECK_EQUAL(response.body_remaining(), 0u);
+
+  // The rest of the header and a bit of the body
+  BOOST_CHECK_EQUAL(response.decode(&frame[4], 10, NULL), 10);
+  BOOST_CHECK_EQUAL(response.body_remaining(), frame.size() - 14);
+
+  // The remaining body received directly into the body
+  size_t remaining = response.body_remaining();
+  memcpy(response.body_buffer_pos(), &frame[14], remaining);
+  BOOST_CHECK_EQUAL(response.decode(response.body_buffer_pos(), remaining, NULL),
+                    static_cast<ssize_t>(remaining));
+  BOOST_REQUIRE(response.is_body_ready());
+  BOOST_CHECK_EQUAL(response.body_remaining(), 0u);
+  BOOST_CHECK(memcmp(response.response_body()->data(),
+                     &frame[CASS_HEADER_SIZE_V3],
+                     frame.size() - CASS_HEADER_SIZE_V3) == 0);
+}
+
+BOOST_AUTO_TEST_CASE(direct_read)
+{
+  std::vector<char> frame = build_rows_frame(2, 1024, 1000);
+
+  cass::ResponseMessage copied;
+  BOOST_REQUIRE(decode_frame(frame, false, &copied));
+
+  cass::ResponseMessage direct;
+  BOOST_REQUIRE(decode_frame(frame, true, &direct));
+
+  BOOST_CHECK_EQUAL(direct.stream(), 2);
+  BOOST_CHECK_EQUAL(direct.length(), copied.length());
+  BOOST_CHECK(memcmp(direct.response_body()->data(),
+                     copied.response_body()->data(),
+                     direct.length()) == 0);
+
+  cass::ResultResponse* result
+      = static_cast<cass::ResultResponse*>(direct.response_body().get());
+  BOOST_CHECK_EQUAL(result->row_count(), 1024);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -18,11 +18,15 @@
 #   define BOOST_TEST_MODULE cassandra
 #endif
 
+#include "batch_request.hpp"
+#include "external_types.hpp"
 #include "query_request.hpp"
+#include "replication_strategy.hpp"
 #include "token_map.hpp"
 #include "murmur3.hpp"
 #include "logger.hpp"
 
+#include <boost/lexical_cast.hpp>
 #include <boost/test/unit_test.hpp>
 #include <boost/cstdint.hpp>
 
@@ -181,4 +185,178 @@ BOOST_AUTO_TEST_CASE(composite)
   }
 }
 
+BOOST_AUTO_TEST_CASE(cached_token)
+{
+  cass::QueryRequest query(3);
+  cass::Request::EncodingCache cache;
+  query.add_key_index(0);
+  query.add_key_index(1);
+
+  int64_t token;
+  BOOST_CHECK(!query.get_routing_token(&token));
+
+  // Not cached until all of the key columns are bound
+  query.set(0, cass_false);
+  BOOST_CHECK(!query.get_routing_token(&token));
+
+  query.set(1, static_cast<cass_int32_t>(123456789));
+  BOOST_REQUIRE(query.get_routing_token(&token));
+
+  std::string routing_key;
+  BOOST_REQUIRE(query.get_routing_key(&routing_key, &cache));
+  BOOST_CHECK_EQUAL(token, cass::MurmurHash3_x64_128(routing_key.data(), routing_key.size(), 0));
+
+  // Binding a value that isn't part of the key doesn't change the token
+  query.set(2, static_cast<cass_int32_t>(1));
+  cass_int64_t api_token;
+  BOOST_REQUIRE_EQUAL(cass_statement_routing_token(CassStatement::to(&query), &api_token), CASS_OK);
+  BOOST_CHECK_EQUAL(api_token, token);
+
+  // Rebinding a key column updates the token
+  query.set(1, static_cast<cass_int32_t>(987654321));
+  int64_t rebound_token;
+  BOOST_REQUIRE(query.get_routing_token(&rebound_token));
+  BOOST_REQUIRE(query.get_routing_key(&routing_key, &cache));
+  BOOST_CHECK(rebound_token != token);
+  BOOST_CHECK_EQUAL(rebound_token, cass::MurmurHash3_x64_128(routing_key.data(), routing_key.size(), 0));
+
+  query.set(1, cass::CassNull());
+  BOOST_CHECK(!query.get_routing_token(&token));
+  BOOST_CHECK(!query.get_routing_key(&routing_key, &cache));
+
+  query.set(1, static_cast<cass_int32_t>(123456789));
+  BOOST_CHECK(query.get_routing_token(&token));
+  query.reset(3);
+  BOOST_CHECK(!query.get_routing_token(&token));
+  BOOST_CHECK_EQUAL(cass_statement_routing_token(CassStatement::to(&query), &api_token),
+                    CASS_ERROR_LIB_PARAMETER_UNSET);
+}
+
+BOOST_AUTO_TEST_CASE(collection_not_cached)
+{
+  cass::QueryRequest query(1);
+  cass::Request::EncodingCache cache;
+  query.add_key_index(0);
+
+  CassCollection* collection = cass_collection_new(CASS_COLLECTION_TYPE_LIST, 1);
+  cass_collection_append_int32(collection, 1);
+  cass_statement_bind_collection(CassStatement::to(&query), 0, collection);
+
+  // Collections can still be modified so the key is built when it's used
+  int64_t token;
+  BOOST_CHECK(!query.get_routing_token(&token));
+  std::string routing_key;
+  BOOST_CHECK(query.get_routing_key(&routing_key, &cache));
+
+  cass_collection_free(collection);
+}
+
+BOOST_AUTO_TEST_CASE(batch_token)
+{
+  cass::SharedRefPtr<cass::QueryRequest> unbound(new cass::QueryRequest(1));
+  unbound->add_key_index(0);
+
+  cass::SharedRefPtr<cass::QueryRequest> with_collection(new cass::QueryRequest(1));
+  with_collection->add_key_index(0);
+  CassCollection* collection = cass_collection_new(CASS_COLLECTION_TYPE_LIST, 1);
+  cass_collection_append_int32(collection, 1);
+  cass_statement_bind_collection(CassStatement::to(with_collection.get()), 0, collection);
+  cass_collection_free(collection);
+
+  cass::SharedRefPtr<cass::QueryRequest> routable(new cass::QueryRequest(1));
+  routable->set(0, static_cast<cass_int32_t>(1));
+  routable->add_key_index(0);
+
+  // The first statement with a routing key is used so a key that can't be
+  // hashed up front doesn't fall through to a later statement's token
+  cass::BatchRequest batch(CASS_BATCH_TYPE_UNLOGGED);
+  batch.add_statement(unbound.get());
+  batch.add_statement(with_collection.get());
+  batch.add_statement(routable.get());
+
+  int64_t token;
+  BOOST_CHECK(!batch.get_routing_token(&token));
+  std::string routing_key;
+  cass::Request::EncodingCache cache;
+  BOOST_REQUIRE(batch.get_routing_key(&routing_key, &cache));
+  BOOST_CHECK(routing_key.size() > 0);
+
+  cass::BatchRequest routable_batch(CASS_BATCH_TYPE_UNLOGGED);
+  routable_batch.add_statement(unbound.get());
+  routable_batch.add_statement(routable.get());
+  int64_t expected_token;
+  BOOST_REQUIRE(routable->get_routing_token(&expected_token));
+  BOOST_REQUIRE(routable_batch.get_routing_token(&token));
+  BOOST_CHECK_EQUAL(token, expected_token);
+}
+
+BOOST_AUTO_TEST_CASE(batch_split)
+{
+  cass::TokenMap token_map;
+  token_map.set_partitioner(cass::Murmur3Partitioner::PARTITIONER_CLASS);
+  token_map.set_replication_strategy("ks",
+                                     cass::SharedRefPtr<cass::ReplicationStrategy>(
+                                       new cass::SimpleStrategy("", 1)));
+  const int num_hosts = 4;
+  uint64_t partition_size = CASS_UINT64_MAX / num_hosts;
+  int64_t t = CASS_INT64_MIN + partition_size;
+  for (int i = 0; i < num_hosts; ++i) {
+    std::string ip("127.0.0." + boost::lexical_cast<std::string>(i + 1));
+    cass::SharedRefPtr<cass::Host> host(new cass::Host(cass::Address(ip, 9042), false));
+    cass::TokenStringList tokens;
+    std::string token(boost::lexical_cast<std::string>(t));
+    tokens.push_back(cass::StringRef(token));
+    token_map.update_host(host, tokens);
+    t += partition_size;
+  }
+  token_map.build();
+
+  cass::SharedRefPtr<cass::BatchRequest> batch(new cass::BatchRequest(CASS_BATCH_TYPE_UNLOGGED));
+  batch->set_consistency(CASS_CONSISTENCY_QUORUM);
+  const size_t num_routable = 64;
+  for (size_t i = 0; i < num_routable; ++i) {
+    cass::SharedRefPtr<cass::QueryRequest> query(new cass::QueryRequest(1));
+    query->set(0, static_cast<cass_int32_t>(i));
+    query->add_key_index(0);
+    batch->add_statement(query.get());
+  }
+  // No routing key
+  batch->add_statement(cass::SharedRefPtr<cass::QueryRequest>(new cass::QueryRequest(0)).get());
+
+  cass::BatchRequest::Vec batches;
+  batch->split_by_replicas(token_map.keyspace_id("ks"), token_map, &batches);
+  BOOST_REQUIRE_EQUAL(batches.size(), 5u);
+
+  size_t count = 0;
+  std::set<const cass::HostVec*> replica_sets;
+  for (cass::BatchRequest::Vec::const_iterator i = batches.begin(); i != batches.end(); ++i) {
+    const cass::BatchRequest::StatementList& statements = (*i)->statements();
+    BOOST_CHECK_EQUAL((*i)->type(), CASS_BATCH_TYPE_UNLOGGED);
+    BOOST_CHECK_EQUAL((*i)->consistency(), CASS_CONSISTENCY_QUORUM);
+    count += statements.size();
+
+    // All of the statements in a batch have the same replicas
+    const cass::HostVec* replicas = NULL;
+    for (cass::BatchRequest::StatementList::const_iterator j = statements.begin();
+         j != statements.end(); ++j) {
+      int64_t token;
+      const cass::HostVec* statement_replicas = NULL;
+      if ((*j)->get_routing_token(&token)) {
+        statement_replicas = &(*token_map.get_replicas(token_map.keyspace_id("ks"), token));
+      }
+      if (j == statements.begin()) {
+        replicas = statement_replicas;
+      }
+      BOOST_CHECK(statement_replicas == replicas);
+    }
+    BOOST_CHECK(replica_sets.insert(replicas).second);
+  }
+  BOOST_CHECK_EQUAL(count, num_routable + 1);
+
+  // Nothing to route without a keyspace
+  batches.clear();
+  batch->split_by_replicas(cass::INVALID_KEYSPACE_ID, token_map, &batches);
+  BOOST_CHECK_EQUAL(batches.size(), 1u);
+}
+
 BOOST_AUTO_TEST_SUITE_END()
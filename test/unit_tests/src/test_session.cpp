@@ -0,0 +1,71 @@
+/*
+  Copyright (c) 2014-2016 DataStax
+
+  Licensed under the Apache License, Version 2.0 (the "License");
+  you may not use this file except in compliance with the License.
+  You may obtain a copy of the License at
+
+  http://www.apache.org/licenses/LICENSE-2.0
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+*/
+
+#ifdef STAND_ALONE
+#   define BOOST_TEST_MODULE cassandra
+#endif
+
+#include "batch_request.hpp"
+#include "future.hpp"
+#include "query_request.hpp"
+#include "session.hpp"
+
+#include <boost/test/unit_test.hpp>
+
+#include <uv.h>
+
+#define NUM_ITERATIONS 10000
+
+struct KeyspaceThreadArgs {
+  uv_thread_t thread;
+  cass::Session* session;
+};
+
+void keyspace_thread(void* data) {
+  KeyspaceThreadArgs* args = static_cast<KeyspaceThreadArgs*>(data);
+  for (int i = 0; i < NUM_ITERATIONS; ++i) {
+    args->session->broadcast_keyspace_change(i % 2 == 0 ? "ks1" : "ks2", NULL);
+  }
+}
+
+BOOST_AUTO_TEST_SUITE(session)
+
+BOOST_AUTO_TEST_CASE(split_batch_while_keyspace_changes)
+{
+  cass::Session session;
+
+  cass::SharedRefPtr<cass::BatchRequest> batch(new cass::BatchRequest(CASS_BATCH_TYPE_UNLOGGED));
+  for (int i = 0; i < 2; ++i) {
+    batch->add_statement(cass::SharedRefPtr<cass::QueryRequest>(new cass::QueryRequest(0)).get());
+  }
+
+  // The keyspace is changed by an IO worker while the application splits
+  // batches using it
+  KeyspaceThreadArgs args;
+  args.session = &session;
+  uv_thread_create(&args.thread, keyspace_thread, &args);
+
+  for (int i = 0; i < NUM_ITERATIONS; ++i) {
+    cass::Future* future = session.execute_split(batch.get());
+    BOOST_REQUIRE(future->get_error() != NULL);
+    BOOST_CHECK_EQUAL(future->get_error()->code, CASS_ERROR_LIB_NO_HOSTS_AVAILABLE);
+    future->dec_ref();
+  }
+
+  uv_thread_join(&args.thread);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
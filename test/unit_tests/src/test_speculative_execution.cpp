@@ -0,0 +1,110 @@
+/*
+  Copyright (c) 2014-2016 DataStax
+
+  Licensed under the Apache License, Version 2.0 (the "License");
+  you may not use this file except in compliance with the License.
+  You may obtain a copy of the License at
+
+  http://www.apache.org/licenses/LICENSE-2.0
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+*/
+
+
+#ifdef STAND_ALONE
+#   define BOOST_TEST_MODULE cassandra
+#endif
+
+#include "metrics.hpp"
+#include "scoped_ptr.hpp"
+#include "speculative_execution.hpp"
+
+#include <boost/test/unit_test.hpp>
+
+BOOST_AUTO_TEST_SUITE(speculative_execution)
+
+BOOST_AUTO_TEST_CASE(no_speculative_execution)
+{
+  cass::NoSpeculativeExecutionPolicy policy;
+  cass::ScopedPtr<cass::SpeculativeExecutionPlan> plan(policy.new_plan(NULL));
+  BOOST_CHECK(!plan);
+}
+
+BOOST_AUTO_TEST_CASE(constant)
+{
+  cass::ConstantSpeculativeExecutionPolicy policy(100, 2);
+  cass::ScopedPtr<cass::SpeculativeExecutionPlan> plan(policy.new_plan(NULL));
+  BOOST_REQUIRE(plan);
+
+  BOOST_CHECK_EQUAL(plan->next_execution(), 100);
+  BOOST_CHECK_EQUAL(plan->next_execution(), 100);
+  BOOST_CHECK_EQUAL(plan->next_execution(), -1);
+
+  cass::ConstantSpeculativeExecutionPolicy disabled(100, 0);
+  plan.reset(disabled.new_plan(NULL));
+  BOOST_CHECK(!plan);
+}
+
+BOOST_AUTO_TEST_CASE(percentile)
+{
+  cass::Metrics metrics(1);
+  cass::PercentileSpeculativeExecutionPolicy policy(99.0, 1);
+  policy.init(&metrics);
+
+  // Not enough requests to calculate the percentile
+  for (int i = 0; i < 50; ++i) {
+    metrics.record_request(10 * 1000 * 1000);
+  }
+  policy.refresh(0);
+  BOOST_CHECK_EQUAL(policy.delay_ms(), -1);
+
+  // 10 ms latencies (recorded in nanoseconds)
+  for (int i = 0; i < 100; ++i) {
+    metrics.record_request(10 * 1000 * 1000);
+  }
+  policy.refresh(0);
+  BOOST_CHECK(policy.delay_ms() >= 10 && policy.delay_ms() <= 11);
+
+  cass::ScopedPtr<cass::SpeculativeExecutionPlan> plan(policy.new_plan(NULL));
+  BOOST_REQUIRE(plan);
+  BOOST_CHECK_EQUAL(plan->next_execution(), policy.delay_ms());
+  BOOST_CHECK_EQUAL(plan->next_execution(), -1);
+}
+
+BOOST_AUTO_TEST_CASE(percentile_interval)
+{
+  cass::Metrics metrics(1);
+  cass::PercentileSpeculativeExecutionPolicy policy(99.0, 1);
+  policy.init(&metrics);
+
+  for (int i = 0; i < 1000; ++i) {
+    metrics.record_request(50 * 1000 * 1000);
+  }
+  policy.refresh(0);
+  BOOST_CHECK(policy.delay_ms() >= 50 && policy.delay_ms() <= 51);
+
+  // Only the requests since the last refresh are used
+  for (int i = 0; i < 1000; ++i) {
+    metrics.record_request(10 * 1000 * 1000);
+  }
+  policy.refresh(0);
+  BOOST_CHECK(policy.delay_ms() >= 10 && policy.delay_ms() <= 11);
+
+  // The previous delay is kept until enough requests have completed
+  for (int i = 0; i < 50; ++i) {
+    metrics.record_request(50 * 1000 * 1000);
+  }
+  policy.refresh(0);
+  BOOST_CHECK(policy.delay_ms() >= 10 && policy.delay_ms() <= 11);
+
+  // The session's metrics still cover all of the requests
+  cass::Metrics::Histogram::Snapshot snapshot;
+  metrics.request_latencies.get_snapshot(&snapshot);
+  BOOST_CHECK(snapshot.max >= 50 * 1000);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
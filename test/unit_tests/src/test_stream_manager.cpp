@@ -91,4 +91,26 @@ BOOST_AUTO_TEST_CASE(release)
   }
 }
 
+BOOST_AUTO_TEST_CASE(invalid_stream)
+{
+  cass::StreamManager<int> streams(3);
+
+  int item = -1;
+  BOOST_CHECK(!streams.get_pending_and_release(-1, item));
+  BOOST_CHECK(!streams.get_pending_and_release(streams.max_streams(), item));
+
+  // Not acquired
+  BOOST_CHECK(!streams.get_pending_and_release(0, item));
+
+  int stream = streams.acquire(42);
+  BOOST_REQUIRE(stream >= 0);
+  BOOST_CHECK_EQUAL(streams.pending_streams(), 1u);
+  BOOST_CHECK(streams.get_pending_and_release(stream, item));
+  BOOST_CHECK_EQUAL(item, 42);
+  BOOST_CHECK_EQUAL(streams.pending_streams(), 0u);
+
+  // Already released
+  BOOST_CHECK(!streams.get_pending_and_release(stream, item));
+}
+
 BOOST_AUTO_TEST_SUITE_END()
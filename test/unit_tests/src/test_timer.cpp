@@ -18,7 +18,11 @@
 #   define BOOST_TEST_MODULE cassandra
 #endif
 
+#include "scoped_ptr.hpp"
 #include "timer.hpp"
+#include "timer_wheel.hpp"
+
+#include <vector>
 
 #include <boost/test/unit_test.hpp>
 
@@ -43,6 +47,12 @@ void on_timer_repeat(cass::Timer* timer) {
   }
 }
 
+void on_wheel_timer(cass::TimerWheel::Entry* entry) {
+  int* count = static_cast<int*>(entry->data());
+  (*count)++;
+  BOOST_CHECK(!entry->is_running());
+}
+
 BOOST_AUTO_TEST_SUITE(timer)
 
 BOOST_AUTO_TEST_CASE(once)
@@ -113,4 +123,100 @@ BOOST_AUTO_TEST_CASE(repeat)
 
 }
 
+BOOST_AUTO_TEST_CASE(wheel_once)
+{
+  uv_loop_t* loop;
+
+#if UV_VERSION_MAJOR == 0
+  loop = uv_loop_new();
+#else
+  uv_loop_t loop_storage__;
+  loop = &loop_storage__;
+  uv_loop_init(loop);
+#endif
+
+  cass::TimerWheel wheel;
+  wheel.init(loop);
+
+  cass::TimerWheel::Entry entry;
+
+  int count = 0;
+
+  entry.start(&wheel, 1, &count, on_wheel_timer);
+
+  BOOST_CHECK(entry.is_running());
+  BOOST_CHECK_EQUAL(wheel.size(), 1u);
+
+  uv_run(loop, UV_RUN_DEFAULT);
+
+  BOOST_CHECK(!entry.is_running());
+  BOOST_CHECK_EQUAL(count, 1);
+  BOOST_CHECK_EQUAL(wheel.size(), 0u);
+
+#if UV_VERSION_MAJOR == 0
+  uv_loop_delete(loop);
+#else
+  uv_loop_close(loop);
+#endif
+}
+
+// Entries on every level of the wheel (and past its range) need to expire
+// exactly on their deadline
+BOOST_AUTO_TEST_CASE(wheel_levels)
+{
+  uv_loop_t* loop;
+
+#if UV_VERSION_MAJOR == 0
+  loop = uv_loop_new();
+#else
+  uv_loop_t loop_storage__;
+  loop = &loop_storage__;
+  uv_loop_init(loop);
+#endif
+
+  cass::TimerWheel wheel;
+  wheel.init(loop);
+
+  const uint64_t timeouts[] = { 1, 63, 64, 65, 4095, 4096, 4097, 100000,
+                                262144, 5000000,
+                                cass::TimerWheel::MAX_TIMEOUT,
+                                cass::TimerWheel::MAX_TIMEOUT + 12345 };
+  const size_t num_timeouts = sizeof(timeouts) / sizeof(timeouts[0]);
+
+  std::vector<int> counts(num_timeouts, 0);
+  cass::ScopedPtr<cass::TimerWheel::Entry[]> entries(new cass::TimerWheel::Entry[num_timeouts]);
+
+  uint64_t now = uv_now(loop);
+  for (size_t i = 0; i < num_timeouts; ++i) {
+    entries[i].start(&wheel, timeouts[i], &counts[i], on_wheel_timer);
+  }
+
+  // Stopped entries never expire
+  cass::TimerWheel::Entry stopped;
+  int stopped_count = 0;
+  stopped.start(&wheel, 64, &stopped_count, on_wheel_timer);
+  stopped.stop();
+  BOOST_CHECK(!stopped.is_running());
+  BOOST_CHECK_EQUAL(wheel.size(), num_timeouts);
+
+  for (size_t i = 0; i < num_timeouts; ++i) {
+    wheel.advance(now + timeouts[i] - 1);
+    BOOST_CHECK_MESSAGE(counts[i] == 0, "Timeout " << timeouts[i] << " expired early");
+    wheel.advance(now + timeouts[i]);
+    BOOST_CHECK_MESSAGE(counts[i] == 1, "Timeout " << timeouts[i] << " didn't expire");
+  }
+
+  BOOST_CHECK_EQUAL(stopped_count, 0);
+  BOOST_CHECK_EQUAL(wheel.size(), 0u);
+
+  wheel.close_handles();
+  uv_run(loop, UV_RUN_DEFAULT);
+
+#if UV_VERSION_MAJOR == 0
+  uv_loop_delete(loop);
+#else
+  uv_loop_close(loop);
+#endif
+}
+
 BOOST_AUTO_TEST_SUITE_END()
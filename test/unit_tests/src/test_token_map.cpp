@@ -228,6 +228,45 @@ BOOST_AUTO_TEST_CASE(remove_host)
   }
 }
 
+BOOST_AUTO_TEST_CASE(snapshot)
+{
+  TestTokenMap<int64_t> test_snapshot;
+
+  test_snapshot.strategy =
+      cass::SharedRefPtr<cass::ReplicationStrategy>(new cass::SimpleStrategy("", 2));
+
+  test_snapshot.tokens[CASS_INT64_MIN / 2] = create_host("1.0.0.1");
+  test_snapshot.tokens[0] = create_host("1.0.0.2");
+  test_snapshot.tokens[CASS_INT64_MAX / 2] = create_host("1.0.0.3");
+
+  test_snapshot.build(cass::Murmur3Partitioner::PARTITIONER_CLASS, "test");
+
+  cass::TokenMap& token_map = test_snapshot.token_map;
+  cass::TokenMap::ConstPtr snapshot(token_map.snapshot());
+  BOOST_CHECK(snapshot->has_int64_tokens());
+
+  // Updating the map doesn't change the replicas of an existing snapshot
+  token_map.remove_host(test_snapshot.tokens.begin()->second);
+
+  {
+    const cass::CopyOnWriteHostVec& replicas = snapshot->get_replicas("test", "abc");
+    BOOST_REQUIRE(replicas->size() == 2);
+    BOOST_CHECK((*replicas)[0]->address() == cass::Address("1.0.0.1", 9042));
+    BOOST_CHECK((*replicas)[1]->address() == cass::Address("1.0.0.2", 9042));
+  }
+
+  {
+    const cass::CopyOnWriteHostVec& replicas = token_map.get_replicas("test", "abc");
+    BOOST_REQUIRE(replicas->size() == 2);
+    BOOST_CHECK((*replicas)[0]->address() == cass::Address("1.0.0.2", 9042));
+    BOOST_CHECK((*replicas)[1]->address() == cass::Address("1.0.0.3", 9042));
+  }
+
+  token_map.clear();
+  BOOST_CHECK_EQUAL(snapshot->get_replicas("test", "abc")->size(), 2u);
+  BOOST_CHECK_EQUAL(token_map.snapshot()->get_replicas("test", "abc")->size(), 0u);
+}
+
 BOOST_AUTO_TEST_CASE(drop_keyspace)
 {
   TestTokenMap<int64_t> test_drop_keyspace;
@@ -262,6 +301,210 @@ BOOST_AUTO_TEST_CASE(drop_keyspace)
   }
 }
 
+BOOST_AUTO_TEST_CASE(keyspace_ids)
+{
+  TestTokenMap<int64_t> test_murmur3;
+  test_murmur3.tokens[0] = create_host("1.0.0.1");
+  test_murmur3.build(cass::Murmur3Partitioner::PARTITIONER_CLASS, "test");
+  const cass::TokenMap& token_map = test_murmur3.token_map;
+
+  BOOST_CHECK_EQUAL(token_map.keyspace_id(""), cass::INVALID_KEYSPACE_ID);
+
+  cass::KeyspaceId id = token_map.keyspace_id("test");
+  BOOST_REQUIRE(id != cass::INVALID_KEYSPACE_ID);
+
+  const cass::CopyOnWriteHostVec& replicas = token_map.get_replicas(id, "abc");
+  BOOST_REQUIRE_EQUAL(replicas->size(), 1u);
+  BOOST_CHECK(replicas->front() == test_murmur3.tokens[0]);
+
+  // Looking up an unknown keyspace doesn't add it
+  BOOST_CHECK(token_map.get_replicas("other", "abc")->empty());
+  BOOST_CHECK_EQUAL(token_map.keyspace_id("other"), cass::INVALID_KEYSPACE_ID);
+  BOOST_CHECK(token_map.get_replicas(cass::INVALID_KEYSPACE_ID, "abc")->empty());
+
+  // Ids belong to the map and are shared with its snapshots
+  cass::TokenMap::ConstPtr snapshot(token_map.snapshot());
+  BOOST_CHECK_EQUAL(snapshot->keyspace_id("test"), id);
+  BOOST_CHECK_EQUAL(cass::TokenMap().keyspace_id("test"), cass::INVALID_KEYSPACE_ID);
+}
+
+BOOST_AUTO_TEST_CASE(keyspace_id_cache)
+{
+  TestTokenMap<int64_t> test_murmur3;
+  test_murmur3.tokens[0] = create_host("1.0.0.1");
+  test_murmur3.build(cass::Murmur3Partitioner::PARTITIONER_CLASS, "test");
+  cass::TokenMap& token_map = test_murmur3.token_map;
+
+  cass::KeyspaceIdCache cache;
+  cass::KeyspaceId id = token_map.keyspace_id("test", cache);
+  BOOST_CHECK_EQUAL(id, token_map.keyspace_id("test"));
+
+  // The name isn't looked up again while the ids don't change, even in a
+  // snapshot
+  cass::KeyspaceIdCache other_cache;
+  BOOST_CHECK_EQUAL(token_map.keyspace_id("other", other_cache), cass::INVALID_KEYSPACE_ID);
+  cass::TokenMap::ConstPtr snapshot(token_map.snapshot());
+  BOOST_CHECK_EQUAL(snapshot->keyspace_id("unused", cache), id);
+
+  // Adding a keyspace looks the names up again
+  token_map.set_replication_strategy("other",
+                                     cass::SharedRefPtr<cass::ReplicationStrategy>(
+                                       new cass::SimpleStrategy("", 1)));
+  cass::KeyspaceId other_id = token_map.keyspace_id("other", other_cache);
+  BOOST_CHECK(other_id != cass::INVALID_KEYSPACE_ID);
+  BOOST_CHECK_EQUAL(token_map.keyspace_id("test", cache), id);
+
+  // The snapshot still has the previous ids
+  BOOST_CHECK_EQUAL(snapshot->keyspace_id("other", other_cache), cass::INVALID_KEYSPACE_ID);
+  BOOST_CHECK_EQUAL(token_map.keyspace_id("other", other_cache), other_id);
+}
+
+BOOST_AUTO_TEST_CASE(shared_replica_sets)
+{
+  TestTokenMap<int64_t> test_murmur3;
+  test_murmur3.strategy =
+      cass::SharedRefPtr<cass::ReplicationStrategy>(new cass::SimpleStrategy("", 1));
+
+  boost::mt19937_64 ng;
+  cass::HostVec hosts;
+  for (int i = 0; i < 4; ++i) {
+    hosts.push_back(create_host("1.0.0." + boost::lexical_cast<std::string>(i + 1)));
+    for (int j = 0; j < 256; ++j) {
+      test_murmur3.tokens[static_cast<int64_t>(ng())] = hosts.back();
+    }
+  }
+
+  test_murmur3.token_map.set_replication_strategy("other", test_murmur3.strategy);
+  test_murmur3.build(cass::Murmur3Partitioner::PARTITIONER_CLASS, "test");
+
+  cass::TokenMap& token_map = test_murmur3.token_map;
+
+  // One set per host shared by both keyspaces
+  BOOST_CHECK_EQUAL(token_map.replica_set_count(), hosts.size());
+  BOOST_CHECK(token_map.memory_size() > 0);
+
+  for (int i = 0; i < 24; ++i) {
+    std::string key(1, 'a' + i);
+    const cass::CopyOnWriteHostVec& replicas = token_map.get_replicas("test", key);
+    const cass::CopyOnWriteHostVec& other_replicas = token_map.get_replicas("other", key);
+    BOOST_REQUIRE_EQUAL(replicas->size(), 1u);
+    BOOST_CHECK(&(*replicas) == &(*other_replicas));
+  }
+
+  // The removed host's set is no longer in use
+  token_map.remove_host(hosts.front());
+  BOOST_CHECK_EQUAL(token_map.replica_set_count(), hosts.size() - 1);
+
+  token_map.drop_keyspace("test");
+  token_map.drop_keyspace("other");
+  BOOST_CHECK_EQUAL(token_map.replica_set_count(), 0u);
+}
+
+BOOST_AUTO_TEST_CASE(shared_keyspace_replicas)
+{
+  TestTokenMap<int64_t> test_murmur3;
+  test_murmur3.strategy =
+      cass::SharedRefPtr<cass::ReplicationStrategy>(new cass::SimpleStrategy("", 2));
+
+  boost::mt19937_64 ng;
+  cass::HostVec hosts;
+  for (int i = 0; i < 4; ++i) {
+    hosts.push_back(create_host("1.0.0." + boost::lexical_cast<std::string>(i + 1)));
+    for (int j = 0; j < 64; ++j) {
+      test_murmur3.tokens[static_cast<int64_t>(ng())] = hosts.back();
+    }
+  }
+
+  cass::TokenMap& token_map = test_murmur3.token_map;
+  token_map.set_replication_strategy("other", cass::SharedRefPtr<cass::ReplicationStrategy>(
+                                       new cass::SimpleStrategy("", 2)));
+  token_map.set_replication_strategy("third", cass::SharedRefPtr<cass::ReplicationStrategy>(
+                                       new cass::SimpleStrategy("", 1)));
+  test_murmur3.build(cass::Murmur3Partitioner::PARTITIONER_CLASS, "test");
+
+  // Keyspaces with equal strategies look up replicas in the same map
+  for (int i = 0; i < 24; ++i) {
+    std::string key(1, 'a' + i);
+    BOOST_CHECK(&token_map.get_replicas("test", key) == &token_map.get_replicas("other", key));
+    BOOST_CHECK(&token_map.get_replicas("test", key) != &token_map.get_replicas("third", key));
+    BOOST_CHECK_EQUAL(token_map.get_replicas("test", key)->size(), 2u);
+    BOOST_CHECK_EQUAL(token_map.get_replicas("third", key)->size(), 1u);
+  }
+
+  // Shared replicas are still up to date after a topology change
+  token_map.remove_host(hosts.front());
+  for (int i = 0; i < 24; ++i) {
+    std::string key(1, 'a' + i);
+    BOOST_CHECK(&token_map.get_replicas("test", key) == &token_map.get_replicas("other", key));
+    const cass::CopyOnWriteHostVec& replicas = token_map.get_replicas("other", key);
+    BOOST_REQUIRE_EQUAL(replicas->size(), 2u);
+    BOOST_CHECK(!((*replicas)[0]->address() == hosts.front()->address()));
+    BOOST_CHECK(!((*replicas)[1]->address() == hosts.front()->address()));
+  }
+
+  // Changing a strategy moves the keyspace to the replicas of its new equal
+  token_map.set_replication_strategy("other", cass::SharedRefPtr<cass::ReplicationStrategy>(
+                                       new cass::SimpleStrategy("", 1)));
+  token_map.drop_keyspace("third");
+  for (int i = 0; i < 24; ++i) {
+    std::string key(1, 'a' + i);
+    BOOST_CHECK(&token_map.get_replicas("test", key) != &token_map.get_replicas("other", key));
+    BOOST_CHECK_EQUAL(token_map.get_replicas("test", key)->size(), 2u);
+    BOOST_CHECK_EQUAL(token_map.get_replicas("other", key)->size(), 1u);
+  }
+}
+
+BOOST_AUTO_TEST_CASE(murmur3_int64_ring)
+{
+  cass::Murmur3Partitioner partitioner;
+  boost::mt19937_64 ng;
+
+  // Every ring size up to a few levels of the implicit tree, including the
+  // smallest and largest tokens
+  for (size_t size = 1; size <= 33; ++size) {
+    std::map<int64_t, cass::SharedRefPtr<cass::Host> > tokens;
+    tokens[CASS_INT64_MIN] = create_host("1.0.0.1");
+    tokens[CASS_INT64_MAX] = create_host("1.0.0.2");
+    while (tokens.size() < size + 2) {
+      tokens[static_cast<int64_t>(ng())] = create_host("1.0.0.3");
+    }
+
+    cass::TokenReplicaMap replicas;
+    for (std::map<int64_t, cass::SharedRefPtr<cass::Host> >::iterator i = tokens.begin();
+         i != tokens.end(); ++i) {
+      std::string token(boost::lexical_cast<std::string>(i->first));
+      replicas.insert(cass::TokenReplicaMap::value_type(
+                      partitioner.token_from_string_ref(cass::StringRef(token)),
+                      cass::CopyOnWriteHostVec(new cass::HostVec(1, i->second))));
+    }
 
+    cass::Int64TokenReplicaMap ring;
+    ring.build(replicas);
+    BOOST_REQUIRE_EQUAL(ring.size(), tokens.size());
+
+    std::vector<int64_t> lookups;
+    lookups.push_back(CASS_INT64_MIN);
+    lookups.push_back(CASS_INT64_MAX);
+    for (std::map<int64_t, cass::SharedRefPtr<cass::Host> >::iterator i = tokens.begin();
+         i != tokens.end(); ++i) {
+      lookups.push_back(i->first);
+      lookups.push_back(i->first - 1);
+    }
+    for (int i = 0; i < 64; ++i) {
+      lookups.push_back(static_cast<int64_t>(ng()));
+    }
+
+    for (std::vector<int64_t>::iterator i = lookups.begin(); i != lookups.end(); ++i) {
+      std::map<int64_t, cass::SharedRefPtr<cass::Host> >::iterator expected = tokens.upper_bound(*i);
+      if (expected == tokens.end()) expected = tokens.begin();
+      const cass::CopyOnWriteHostVec* result = ring.find(*i);
+      BOOST_REQUIRE(result != NULL);
+      BOOST_CHECK((*result)->front() == expected->second);
+    }
+  }
+
+  cass::Int64TokenReplicaMap empty;
+  BOOST_CHECK(empty.find(0) == NULL);
+}
 
 BOOST_AUTO_TEST_SUITE_END()
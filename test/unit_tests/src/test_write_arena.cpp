@@ -0,0 +1,225 @@
+/*
+  Copyright (c) 2014-2016 DataStax
+
+  Licensed under the Apache License, Version 2.0 (the "License");
+  you may not use this file except in compliance with the License.
+  You may obtain a copy of the License at
+
+  http://www.apache.org/licenses/LICENSE-2.0
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+*/
+
+#ifdef STAND_ALONE
+#   define BOOST_TEST_MODULE cassandra
+#endif
+
+#include "write_arena.hpp"
+
+#include <boost/test/unit_test.hpp>
+
+#include <string>
+#include <uv.h>
+
+#ifndef _WIN32
+#include <sys/socket.h>
+#include <unistd.h>
+#endif
+
+static std::string gather(const std::vector<uv_buf_t>& bufs) {
+  std::string result;
+  for (std::vector<uv_buf_t>::const_iterator i = bufs.begin(); i != bufs.end(); ++i) {
+    result.append(i->base, i->len);
+  }
+  return result;
+}
+
+#if !defined(_WIN32) && UV_VERSION_MAJOR >= 1
+struct SocketReader {
+  uv_thread_t thread;
+  int fd;
+  std::string data;
+};
+
+static void read_socket(void* arg) {
+  SocketReader* reader = static_cast<SocketReader*>(arg);
+  char buf[4096];
+  ssize_t n;
+  while ((n = read(reader->fd, buf, sizeof(buf))) > 0) {
+    reader->data.append(buf, n);
+  }
+}
+
+static void on_write(uv_write_t* req, int status) {
+  BOOST_CHECK_EQUAL(status, 0);
+  *static_cast<bool*>(req->data) = true;
+}
+#endif
+
+BOOST_AUTO_TEST_SUITE(write_arena)
+
+BOOST_AUTO_TEST_CASE(small_buffers_are_coalesced)
+{
+  cass::WriteChunkPool pool;
+  cass::WriteArena arena(&pool);
+
+  std::string expected;
+  for (int i = 0; i < 1000; ++i) {
+    std::string s(i % 64, static_cast<char>('a' + i % 26));
+    arena.append(cass::Buffer(s.data(), s.size()));
+    expected.append(s);
+  }
+
+  BOOST_CHECK_EQUAL(arena.size(), expected.size());
+  BOOST_CHECK_EQUAL(arena.bufs().size(), 1u);
+  BOOST_CHECK(gather(arena.bufs()) == expected);
+}
+
+BOOST_AUTO_TEST_CASE(large_buffers_are_referenced)
+{
+  cass::WriteChunkPool pool;
+  cass::WriteArena arena(&pool);
+
+  std::string small("small");
+  std::string large(cass::WriteArena::COPY_THRESHOLD + 1, 'x');
+
+  cass::Buffer large_buffer(large.data(), large.size());
+  arena.append(cass::Buffer(small.data(), small.size()));
+  arena.append(large_buffer);
+  arena.append(cass::Buffer(small.data(), small.size()));
+
+  BOOST_REQUIRE_EQUAL(arena.bufs().size(), 3u);
+  BOOST_CHECK(arena.bufs()[1].base == large_buffer.data());
+  BOOST_CHECK(gather(arena.bufs()) == small + large + small);
+}
+
+BOOST_AUTO_TEST_CASE(spans_chunks)
+{
+  cass::WriteChunkPool pool;
+  std::string expected;
+  {
+    cass::WriteArena arena(&pool);
+    // Force a buffer to be split across two chunks
+    std::string s(cass::WriteArena::COPY_THRESHOLD, 'y');
+    while (expected.size() <= cass::WriteChunkPool::CHUNK_SIZE) {
+      arena.append(cass::Buffer(s.data(), s.size()));
+      expected.append(s);
+    }
+    BOOST_CHECK_EQUAL(arena.bufs().size(), 2u);
+    BOOST_CHECK(gather(arena.bufs()) == expected);
+  }
+
+  // The chunks are returned to the pool and reused
+  BOOST_CHECK_EQUAL(pool.free_chunk_count(), 2u);
+  {
+    cass::WriteArena arena(&pool);
+    arena.append(cass::Buffer("z", 1));
+    BOOST_CHECK_EQUAL(pool.free_chunk_count(), 1u);
+  }
+  BOOST_CHECK_EQUAL(pool.free_chunk_count(), 2u);
+}
+
+BOOST_AUTO_TEST_CASE(unwritten_bufs)
+{
+  cass::WriteChunkPool pool;
+  cass::WriteArena arena(&pool);
+
+  std::string small(100, 'a');
+  std::string large(cass::WriteArena::COPY_THRESHOLD + 1, 'b');
+  arena.append(cass::Buffer(small.data(), small.size()));
+  arena.append(cass::Buffer(large.data(), large.size()));
+  arena.append(cass::Buffer(small.data(), small.size()));
+  BOOST_REQUIRE_EQUAL(arena.bufs().size(), 3u);
+
+  const std::string expected(gather(arena.bufs()));
+  const size_t written[] = {
+    0, // Nothing written
+    1, 99, // Within the first buffer
+    100, // On a buffer boundary
+    150, 100 + large.size() - 1, // Within the referenced buffer
+    100 + large.size(), // On the last boundary
+    expected.size() - 1
+  };
+  const size_t expected_count[] = { 3, 3, 3, 2, 2, 2, 1, 1 };
+
+  for (size_t i = 0; i < sizeof(written) / sizeof(written[0]); ++i) {
+    std::vector<uv_buf_t> remaining;
+    arena.unwritten_bufs(written[i], &remaining);
+    BOOST_CHECK_EQUAL(remaining.size(), expected_count[i]);
+    BOOST_CHECK(gather(remaining) == expected.substr(written[i]));
+  }
+
+  // A full write leaves nothing
+  std::vector<uv_buf_t> remaining;
+  arena.unwritten_bufs(expected.size(), &remaining);
+  BOOST_CHECK(remaining.empty());
+}
+
+#if !defined(_WIN32) && UV_VERSION_MAJOR >= 1
+// Writes synchronously the way Connection does, then queues whatever didn't
+// fit in the socket's send buffer. The data must arrive intact and in order.
+BOOST_AUTO_TEST_CASE(partial_try_write)
+{
+  cass::WriteChunkPool pool;
+  cass::WriteArena arena(&pool);
+
+  std::string expected;
+  for (int i = 0; i < 64; ++i) {
+    std::string small(1000, static_cast<char>('a' + i % 26));
+    std::string large(cass::WriteArena::COPY_THRESHOLD * 4, static_cast<char>('A' + i % 26));
+    arena.append(cass::Buffer(small.data(), small.size()));
+    arena.append(cass::Buffer(large.data(), large.size()));
+    expected.append(small);
+    expected.append(large);
+  }
+
+  int fds[2];
+  BOOST_REQUIRE(socketpair(AF_UNIX, SOCK_STREAM, 0, fds) == 0);
+  int send_buffer_size = 4096;
+  setsockopt(fds[0], SOL_SOCKET, SO_SNDBUF, &send_buffer_size, sizeof(send_buffer_size));
+
+  uv_loop_t loop;
+  BOOST_REQUIRE(uv_loop_init(&loop) == 0);
+  uv_pipe_t pipe;
+  BOOST_REQUIRE(uv_pipe_init(&loop, &pipe, 0) == 0);
+  BOOST_REQUIRE(uv_pipe_open(&pipe, fds[0]) == 0);
+  uv_stream_t* stream = reinterpret_cast<uv_stream_t*>(&pipe);
+
+  // Nothing reads the socket yet so the write can't complete
+  int rc = uv_try_write(stream, arena.bufs().data(), arena.bufs().size());
+  BOOST_REQUIRE(rc > 0);
+  size_t written = static_cast<size_t>(rc);
+  BOOST_REQUIRE(written < arena.size());
+
+  std::vector<uv_buf_t> remaining;
+  arena.unwritten_bufs(written, &remaining);
+
+  bool is_done = false;
+  uv_write_t req;
+  req.data = &is_done;
+  BOOST_REQUIRE(uv_write(&req, stream, remaining.data(), remaining.size(), on_write) == 0);
+
+  SocketReader reader;
+  reader.fd = fds[1];
+  uv_thread_create(&reader.thread, read_socket, &reader);
+
+  uv_run(&loop, UV_RUN_DEFAULT);
+  BOOST_CHECK(is_done);
+
+  uv_close(reinterpret_cast<uv_handle_t*>(&pipe), NULL); // Closes fds[0]
+  uv_run(&loop, UV_RUN_DEFAULT);
+  uv_loop_close(&loop);
+
+  uv_thread_join(&reader.thread);
+  close(fds[1]);
+
+  BOOST_CHECK_EQUAL(reader.data.size(), expected.size());
+  BOOST_CHECK(reader.data == expected);
+}
+#endif
+
+BOOST_AUTO_TEST_SUITE_END()